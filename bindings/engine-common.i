@@ -44,6 +44,7 @@ AccountList * gnc_account_get_descendants_sorted (const Account *account);
 %ignore gnc_account_get_children_sorted;
 %ignore gnc_account_get_descendants;
 %ignore gnc_account_get_descendants_sorted;
+%ignore xaccAccountsGetBalancesAtDates;
 %include <Account.h>
 
 %include <Transaction.h>
@@ -1800,6 +1800,50 @@ get_acct_type ()
     return account_type;
 }
 
+SCM
+gnc_accounts_get_balances_at_dates (SCM accounts, SCM dates,
+                                    gboolean ignclosing)
+{
+    swig_type_info * account_type = get_acct_type();
+    GList *acct_list = NULL;
+    GArray *date_array = g_array_new (FALSE, FALSE, sizeof (time64));
+    gnc_numeric *balances;
+    SCM result = SCM_EOL;
+    guint n_accts, i, j;
+
+    for (; !scm_is_null (accounts); accounts = SCM_CDR (accounts))
+        acct_list = g_list_prepend (acct_list,
+                                    SWIG_MustGetPtr (SCM_CAR (accounts),
+                                                     account_type, 1, 0));
+    acct_list = g_list_reverse (acct_list);
+
+    for (; !scm_is_null (dates); dates = SCM_CDR (dates))
+    {
+        time64 date = scm_to_int64 (SCM_CAR (dates));
+        g_array_append_val (date_array, date);
+    }
+
+    balances = xaccAccountsGetBalancesAtDates (acct_list,
+                                               (time64*) date_array->data,
+                                               date_array->len, ignclosing);
+    n_accts = g_list_length (acct_list);
+
+    /* Build the lists back to front */
+    for (i = n_accts; i > 0; i--)
+    {
+        SCM acct_balances = SCM_EOL;
+        for (j = date_array->len; j > 0; j--)
+            acct_balances = scm_cons (gnc_numeric_to_scm (balances[(i - 1) * date_array->len + j - 1]),
+                                      acct_balances);
+        result = scm_cons (acct_balances, result);
+    }
+
+    g_free (balances);
+    g_array_free (date_array, TRUE);
+    g_list_free (acct_list);
+    return result;
+}
+
 GncAccountValue * gnc_scm_to_account_value_ptr (SCM valuearg)
 {
     GncAccountValue *res;
@@ -55,6 +55,13 @@ gnc_commodity * gnc_scm_to_commodity(SCM scm);
 SCM gnc_commodity_to_scm (const gnc_commodity *commodity);
 SCM gnc_book_to_scm (const QofBook *book);
 
+/** Get the balances of a list of accounts at a list of dates, which must
+ *  be sorted in ascending order. Returns a list with for each account
+ *  the list of its balances at the dates, see
+ *  xaccAccountsGetBalancesAtDates. */
+SCM gnc_accounts_get_balances_at_dates (SCM accounts, SCM dates,
+                                        gboolean ignclosing);
+
 /* Conversion routines used with tax tables */
 GncAccountValue * gnc_scm_to_account_value_ptr (SCM valuearg);
 SCM gnc_account_value_ptr_to_scm (GncAccountValue *);
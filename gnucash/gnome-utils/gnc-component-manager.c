@@ -40,8 +40,6 @@ typedef struct
 {
     GHashTable * event_masks;
     GHashTable * entity_events;
-
-    gboolean match;
 } ComponentEventInfo;
 
 typedef struct
@@ -64,8 +62,18 @@ static guint  suspend_counter = 0;
 static gint   next_component_id = 1;
 static GList *components = NULL;
 
-static ComponentEventInfo changes = { NULL, NULL, FALSE };
-static ComponentEventInfo changes_backup = { NULL, NULL, FALSE };
+static ComponentEventInfo changes = { NULL, NULL };
+static ComponentEventInfo changes_backup = { NULL, NULL };
+
+/* The watches of all components inverted, so a refresh only looks at
+ * the components watching what changed: GncGUID --> GList of
+ * ComponentInfo and entity type --> GList of ComponentInfo. */
+static GHashTable *entity_watchers = NULL;
+static GHashTable *type_watchers = NULL;
+
+/* Engine events are collected until this idle handler runs, so a burst
+ * of events costs a single refresh. */
+static guint refresh_idle_id = 0;
 
 
 /* This static indicates the debugging module that this .o belongs to.  */
@@ -252,6 +260,81 @@ add_event_type (ComponentEventInfo *cei, QofIdTypeConst entity_type,
         *mask = event_mask;
 }
 
+static void
+index_watch (GHashTable *index, gpointer key, ComponentInfo *ci,
+             gboolean watched)
+{
+    GList *watchers;
+
+    if (!index)
+        return;
+
+    watchers = g_hash_table_lookup (index, key);
+    if (watched)
+    {
+        if (g_list_find (watchers, ci))
+            return;
+        watchers = g_list_prepend (watchers, ci);
+    }
+    else
+    {
+        if (!g_list_find (watchers, ci))
+            return;
+        watchers = g_list_remove (watchers, ci);
+        if (!watchers)
+        {
+            g_hash_table_remove (index, key);
+            return;
+        }
+    }
+
+    /* an existing key keeps its own copy, the new one is freed; the
+     * tables don't free their lists, which are edited in place */
+    if (index == entity_watchers)
+        key = guid_copy (key);
+    else
+        key = g_strdup (key);
+    g_hash_table_insert (index, key, watchers);
+}
+
+static void
+free_watchers_helper (gpointer key, gpointer value, gpointer user_data)
+{
+    g_list_free (value);
+}
+
+static void
+unindex_entity_helper (gpointer key, gpointer value, gpointer user_data)
+{
+    index_watch (entity_watchers, key, user_data, FALSE);
+}
+
+static void
+unindex_type_helper (gpointer key, gpointer value, gpointer user_data)
+{
+    index_watch (type_watchers, key, user_data, FALSE);
+}
+
+static void
+gnc_cm_refresh_idle_cancel (void)
+{
+    if (refresh_idle_id)
+        g_source_remove (refresh_idle_id);
+    refresh_idle_id = 0;
+}
+
+static gboolean
+gnc_cm_refresh_idle (gpointer user_data)
+{
+    refresh_idle_id = 0;
+
+    /* if refreshes got suspended meanwhile, resuming does the work */
+    if (suspend_counter == 0)
+        gnc_gui_refresh_internal (FALSE);
+
+    return FALSE;
+}
+
 static void
 gnc_cm_event_handler (QofInstance *entity,
                       QofEventId event_type,
@@ -279,8 +362,10 @@ gnc_cm_event_handler (QofInstance *entity,
 
     got_events = TRUE;
 
-    if (suspend_counter == 0)
-        gnc_gui_refresh_internal (FALSE);
+    /* run before GTK redraws, so the refresh is seen in the same frame */
+    if (suspend_counter == 0 && refresh_idle_id == 0)
+        refresh_idle_id = g_idle_add_full (G_PRIORITY_HIGH_IDLE,
+                                           gnc_cm_refresh_idle, NULL, NULL);
 }
 
 static gint handler_id;
@@ -300,6 +385,13 @@ gnc_component_manager_init (void)
     changes_backup.event_masks = g_hash_table_new (g_str_hash, g_str_equal);
     changes_backup.entity_events = guid_hash_table_new ();
 
+    entity_watchers = g_hash_table_new_full (guid_hash_to_guint,
+                                             guid_g_hash_table_equal,
+                                             (GDestroyNotify) guid_free,
+                                             NULL);
+    type_watchers = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+                                           NULL);
+
     handler_id = qof_event_register_handler (gnc_cm_event_handler, NULL);
 }
 
@@ -324,6 +416,16 @@ gnc_component_manager_shutdown (void)
     destroy_event_hash (changes_backup.entity_events);
     changes_backup.entity_events = NULL;
 
+    g_hash_table_foreach (entity_watchers, free_watchers_helper, NULL);
+    g_hash_table_destroy (entity_watchers);
+    entity_watchers = NULL;
+
+    g_hash_table_foreach (type_watchers, free_watchers_helper, NULL);
+    g_hash_table_destroy (type_watchers);
+    type_watchers = NULL;
+
+    gnc_cm_refresh_idle_cancel ();
+
     qof_event_unregister_handler (handler_id);
 }
 
@@ -466,6 +568,7 @@ gnc_gui_component_watch_entity (gint component_id,
     }
 
     add_event (&ci->watch_info, entity, event_mask, FALSE);
+    index_watch (entity_watchers, (gpointer) entity, ci, event_mask != 0);
 }
 
 void
@@ -483,6 +586,7 @@ gnc_gui_component_watch_entity_type (gint component_id,
     }
 
     add_event_type (&ci->watch_info, entity_type, event_mask, FALSE);
+    index_watch (type_watchers, (gpointer) entity_type, ci, event_mask != 0);
 }
 
 const EventInfo *
@@ -506,6 +610,11 @@ gnc_gui_component_clear_watches (gint component_id)
         return;
     }
 
+    g_hash_table_foreach (ci->watch_info.entity_events,
+                          unindex_entity_helper, ci);
+    g_hash_table_foreach (ci->watch_info.event_masks,
+                          unindex_type_helper, ci);
+
     clear_event_info (&ci->watch_info);
 }
 
@@ -599,67 +708,47 @@ gnc_resume_gui_refresh (void)
 static void
 match_type_helper (gpointer key, gpointer value, gpointer user_data)
 {
-    ComponentEventInfo *cei = user_data;
-    QofIdType id_type = key;
+    GHashTable *matched = user_data;
     QofEventId * et = value;
-    QofEventId * et_2;
+    GList *node;
 
-    et_2 = g_hash_table_lookup (cei->event_masks, id_type);
-    if (!et_2)
-        return;
+    for (node = g_hash_table_lookup (type_watchers, key); node; node = node->next)
+    {
+        ComponentInfo *ci = node->data;
+        QofEventId * et_2 = g_hash_table_lookup (ci->watch_info.event_masks, key);
 
-    if (*et & *et_2)
-        cei->match = TRUE;
+        if (et_2 && (*et & *et_2))
+            g_hash_table_add (matched, ci);
+    }
 }
 
 static void
 match_helper (gpointer key, gpointer value, gpointer user_data)
 {
-    GncGUID *guid = key;
+    GHashTable *matched = user_data;
     EventInfo *ei_1 = value;
-    EventInfo *ei_2;
-    ComponentEventInfo *cei = user_data;
+    GList *node;
 
-    ei_2 = g_hash_table_lookup (cei->entity_events, guid);
-    if (!ei_2)
-        return;
+    for (node = g_hash_table_lookup (entity_watchers, key); node; node = node->next)
+    {
+        ComponentInfo *ci = node->data;
+        EventInfo *ei_2 = g_hash_table_lookup (ci->watch_info.entity_events, key);
 
-    if (ei_1->event_mask & ei_2->event_mask)
-        cei->match = TRUE;
+        if (ei_2 && (ei_1->event_mask & ei_2->event_mask))
+            g_hash_table_add (matched, ci);
+    }
 }
 
-static gboolean
-changes_match (ComponentEventInfo *cei, ComponentEventInfo *changes)
+/* Returns the set of components watching any of the changes. */
+static GHashTable *
+changes_match (ComponentEventInfo *changes)
 {
-    ComponentEventInfo *big_cei;
-    GHashTable *smalltable;
+    GHashTable *matched = g_hash_table_new (g_direct_hash, g_direct_equal);
 
-    if (cei == NULL)
-        return FALSE;
+    g_hash_table_foreach (changes->event_masks, match_type_helper, matched);
+    g_hash_table_foreach (changes->entity_events, match_helper, matched);
 
-    /* check types first, for efficiency */
-    cei->match = FALSE;
-    g_hash_table_foreach (changes->event_masks, match_type_helper, cei);
-    if (cei->match)
-        return TRUE;
-
-    if (g_hash_table_size (cei->entity_events) <=
-            g_hash_table_size (changes->entity_events))
-    {
-        smalltable = cei->entity_events;
-        big_cei = changes;
-    }
-    else
-    {
-        smalltable = changes->entity_events;
-        big_cei = cei;
-    }
-
-    big_cei->match = FALSE;
-
-    g_hash_table_foreach (smalltable, match_helper, big_cei);
-
-    return big_cei->match;
+    return matched;
 }
 
 static void
@@ -667,10 +756,13 @@ gnc_gui_refresh_internal (gboolean force)
 {
     GList *list;
     GList *node;
+    GHashTable *matched = NULL;
 
     if (!got_events && !force)
         return;
 
+    gnc_cm_refresh_idle_cancel ();
+
     gnc_suspend_gui_refresh ();
 
     {
@@ -693,6 +785,9 @@ gnc_gui_refresh_internal (gboolean force)
     // reverse the list so class GncPluginPageRegister is before register-single
     list = g_list_reverse (list);
 
+    if (!force)
+        matched = changes_match (&changes_backup);
+
     for (node = list; node; node = node->next)
     {
         ComponentInfo *ci = find_component (GPOINTER_TO_INT (node->data));
@@ -718,7 +813,7 @@ gnc_gui_refresh_internal (gboolean force)
                 ci->refresh_handler (NULL, ci->user_data);
             }
         }
-        else if (changes_match (&ci->watch_info, &changes_backup))
+        else if (g_hash_table_contains (matched, ci))
         {
             if (ci->refresh_handler)
             {
@@ -740,6 +835,8 @@ gnc_gui_refresh_internal (gboolean force)
     got_events = FALSE;
 
     g_list_free (list);
+    if (matched)
+        g_hash_table_destroy (matched);
 
     gnc_resume_gui_refresh ();
 }
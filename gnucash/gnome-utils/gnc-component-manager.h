@@ -47,7 +47,10 @@ typedef struct
  *          the hash, but may not exist anymore.
  *
  *          Note since refreshes may not occur with every change,
- *          an entity may have all three change values.
+ *          an entity may have all three change values. Engine
+ *          events are collected and dispatched from a single idle
+ *          handler per main loop iteration, unless gui refresh is
+ *          resumed first.
  *
  *          The component should use 'changes' to determine whether
  *          or not a refresh is needed. The hash table must not be
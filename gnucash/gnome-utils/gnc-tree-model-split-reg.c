@@ -101,9 +101,11 @@ struct GncTreeModelSplitRegPrivate
     QofBook *book;                   // GNC Book
     Account *anchor;                 // Account of register
 
-    GList *full_tlist;               // List of unique transactions derived from the query slist in same order
-    GList *tlist;                    // List of unique transactions derived from the full_tlist to display in same order
-    gint   tlist_start;              // The position of the first transaction in tlist in the full_tlist
+    GPtrArray *full_tarray;          // Array of unique transactions derived from the query slist in same order
+    GHashTable *full_tindex;         // Position + 1 of each transaction in full_tarray
+    gboolean full_tindex_dirty;      // full_tindex needs rebuilding after an insert or remove
+    GList *tlist;                    // List of unique transactions derived from the full_tarray to display in same order
+    gint   tlist_start;              // The position of the first transaction in tlist in the full_tarray
 
     Transaction *btrans;             // The Blank transaction
 
@@ -373,6 +375,8 @@ gnc_tree_model_split_reg_init (GncTreeModelSplitReg *model)
     }
 
     model->priv = g_new0 (GncTreeModelSplitRegPrivate, 1);
+    model->priv->full_tarray = g_ptr_array_new ();
+    model->priv->full_tindex = g_hash_table_new (g_direct_hash, g_direct_equal);
 
     gnc_prefs_register_cb (GNC_PREFS_GROUP_GENERAL,
                            GNC_PREF_ACCOUNTING_LABELS,
@@ -424,9 +428,13 @@ gnc_tree_model_split_reg_dispose (GObject *object)
     g_list_free (priv->tlist);
     priv->tlist = NULL;
 
-    /* Free the full_tlist */
-    g_list_free (priv->full_tlist);
-    priv->full_tlist = NULL;
+    /* Free the full_tarray */
+    if (priv->full_tarray)
+        g_ptr_array_free (priv->full_tarray, TRUE);
+    priv->full_tarray = NULL;
+    if (priv->full_tindex)
+        g_hash_table_destroy (priv->full_tindex);
+    priv->full_tindex = NULL;
 
     /* Free the blank split */
     priv->bsplit = NULL;
@@ -546,62 +554,142 @@ gtm_sr_remove_all_rows (GncTreeModelSplitReg *model)
     g_list_free (rr_list);
 }
 
+/* Rebuild the transaction to position lookup of the full_tarray */
 static void
-gtm_sr_reg_load (GncTreeModelSplitReg *model, GncTreeModelSplitRegUpdate model_update, gint num_of_rows)
+gtm_sr_full_tindex_rebuild (GncTreeModelSplitRegPrivate *priv)
 {
-    GncTreeModelSplitRegPrivate *priv;
-    GList *node;
-    gint rows = 0;
+    guint i;
 
-    priv = model->priv;
+    g_hash_table_remove_all (priv->full_tindex);
+    for (i = 0; i < priv->full_tarray->len; i++)
+        g_hash_table_insert (priv->full_tindex, g_ptr_array_index (priv->full_tarray, i),
+                             GUINT_TO_POINTER (i + 1));
+    priv->full_tindex_dirty = FALSE;
+}
 
-    if (model_update == VIEW_HOME)
-    {
-        priv->tlist_start = 0;
 
-        for (node = g_list_nth (priv->full_tlist, priv->tlist_start); node; node = node->next)
-        {
-            Transaction *trans = node->data;
+/* Return the position of trans in the full_tarray, -1 if not there */
+static gint
+gtm_sr_full_tarray_index (GncTreeModelSplitRegPrivate *priv, Transaction *trans)
+{
+    if (priv->full_tindex_dirty)
+        gtm_sr_full_tindex_rebuild (priv);
 
-            priv->tlist = g_list_append (priv->tlist, trans);
-            rows++;
+    return GPOINTER_TO_INT (g_hash_table_lookup (priv->full_tindex, trans)) - 1;
+}
+
+
+/* Return the transaction at position in the full_tarray, NULL if out of range */
+static Transaction *
+gtm_sr_full_tarray_nth (GncTreeModelSplitRegPrivate *priv, gint position)
+{
+    if (position < 0 || (guint) position >= priv->full_tarray->len)
+        return NULL;
 
-            if (rows == num_of_rows)
-                break;
-        } 
+    return g_ptr_array_index (priv->full_tarray, position);
+}
+
+
+/* Insert trans into the full_tarray at position, -1 appends. The view
+ * window keeps its transactions when the insert is before it. */
+static void
+gtm_sr_full_tarray_insert (GncTreeModelSplitReg *model, Transaction *trans, gint position)
+{
+    GncTreeModelSplitRegPrivate *priv = model->priv;
+
+    if (gtm_sr_full_tarray_index (priv, trans) != -1)
+        return;
+
+    if (position < 0 || (guint) position >= priv->full_tarray->len)
+    {
+        // Appending does not move anything, just add the new position
+        g_hash_table_insert (priv->full_tindex, trans,
+                             GUINT_TO_POINTER (priv->full_tarray->len + 1));
+        g_ptr_array_add (priv->full_tarray, trans);
     }
-    
-    if (model_update == VIEW_END)
+    else
     {
-        priv->tlist_start = g_list_length (priv->full_tlist) - num_of_rows;
+        g_ptr_array_insert (priv->full_tarray, position, trans);
+        priv->full_tindex_dirty = TRUE;
 
-        for (node = g_list_nth (priv->full_tlist, priv->tlist_start); node; node = node->next)
-        {
-            Transaction *trans = node->data;
+        if (position < priv->tlist_start)
+            priv->tlist_start++;
+    }
+    model->number_of_trans_in_full_tlist = priv->full_tarray->len;
+}
 
-            priv->tlist = g_list_append (priv->tlist, trans);
-            rows++;
 
-            if (rows == num_of_rows)
-                break;
-        } 
-    }
+/* Remove trans from the full_tarray. */
+static void
+gtm_sr_full_tarray_remove (GncTreeModelSplitReg *model, Transaction *trans)
+{
+    GncTreeModelSplitRegPrivate *priv = model->priv;
+    gint position = gtm_sr_full_tarray_index (priv, trans);
+
+    if (position == -1)
+        return;
+
+    g_ptr_array_remove_index (priv->full_tarray, position);
+    if ((guint) position == priv->full_tarray->len)
+        g_hash_table_remove (priv->full_tindex, trans);
+    else
+        priv->full_tindex_dirty = TRUE;
+
+    if (position < priv->tlist_start)
+        priv->tlist_start--;
+    model->number_of_trans_in_full_tlist = priv->full_tarray->len;
+}
+
+
+/* Replace old_trans with new_trans at the same position in the full_tarray. */
+static void
+gtm_sr_full_tarray_replace (GncTreeModelSplitReg *model, Transaction *old_trans, Transaction *new_trans)
+{
+    GncTreeModelSplitRegPrivate *priv = model->priv;
+    gint position = gtm_sr_full_tarray_index (priv, old_trans);
+
+    if (position == -1)
+        return;
+
+    g_ptr_array_index (priv->full_tarray, position) = new_trans;
+    g_hash_table_remove (priv->full_tindex, old_trans);
+    g_hash_table_insert (priv->full_tindex, new_trans, GINT_TO_POINTER (position + 1));
+}
+
+
+static void
+gtm_sr_reg_load (GncTreeModelSplitReg *model, GncTreeModelSplitRegUpdate model_update, gint num_of_rows)
+{
+    GncTreeModelSplitRegPrivate *priv;
+    Transaction *trans;
+    gint rows = 0;
+
+    priv = model->priv;
+
+    if (model_update == VIEW_HOME)
+        priv->tlist_start = 0;
+
+    if (model_update == VIEW_END)
+        priv->tlist_start = priv->full_tarray->len - num_of_rows;
 
     if (model_update == VIEW_GOTO)
     {
         priv->tlist_start = num_of_rows - NUM_OF_TRANS*1.5;
+        num_of_rows = NUM_OF_TRANS*3;
+    }
 
-        for (node = g_list_nth (priv->full_tlist, priv->tlist_start); node; node = node->next)
-        {
-            Transaction *trans = node->data;
+    if (priv->tlist_start < 0)
+        priv->tlist_start = 0;
 
-            priv->tlist = g_list_append (priv->tlist, trans);
-            rows++;
+    for (rows = 0; rows < num_of_rows; rows++)
+    {
+        trans = gtm_sr_full_tarray_nth (priv, priv->tlist_start + rows);
+        if (trans == NULL)
+            break;
 
-            if (rows == (NUM_OF_TRANS*3))
-                break;
-        } 
+        priv->tlist = g_list_prepend (priv->tlist, trans);
     }
+    priv->tlist = g_list_reverse (priv->tlist);
 }
 
 
@@ -610,6 +698,7 @@ void
 gnc_tree_model_split_reg_load (GncTreeModelSplitReg *model, GList *slist, Account *default_account)
 {
     GncTreeModelSplitRegPrivate *priv;
+    GList *tlist, *node;
 
     ENTER("#### Load ModelSplitReg = %p and slist length is %d ####", model, g_list_length (slist));
 
@@ -617,54 +706,59 @@ gnc_tree_model_split_reg_load (GncTreeModelSplitReg *model, GList *slist, Accoun
 
     /* Clear the treeview */
     gtm_sr_remove_all_rows (model);
-    priv->full_tlist = NULL;
     priv->tlist = NULL;
+    priv->tlist_start = 0;
 
     if (model->current_trans == NULL)
         model->current_trans = priv->btrans;
 
+    /* Get a list of Unique Transactions from an slist */
+    tlist = xaccSplitListGetUniqueTransactions (slist);
+
+    g_ptr_array_set_size (priv->full_tarray, 0);
+
     if (model->sort_direction == GTK_SORT_ASCENDING)
     {
-        /* Get a list of Unique Transactions from an slist */
-        priv->full_tlist = xaccSplitListGetUniqueTransactions (slist);
+        for (node = tlist; node; node = node->next)
+            g_ptr_array_add (priv->full_tarray, node->data);
 
-        /* Add the blank transaction to the full_tlist */
-        priv->full_tlist = g_list_append (priv->full_tlist, priv->btrans);
+        /* Add the blank transaction to the full_tarray */
+        g_ptr_array_add (priv->full_tarray, priv->btrans);
     }
     else
     {
-        /* Get a list of Unique Transactions from an slist */
-        priv->full_tlist = xaccSplitListGetUniqueTransactions (slist);
+        /* Reversed, so the blank transaction comes first */
+        g_ptr_array_add (priv->full_tarray, priv->btrans);
 
-        /* Add the blank transaction to the full_tlist */
-        priv->full_tlist = g_list_append (priv->full_tlist, priv->btrans);
-
-        /* Reverse the full_tlist */
-        priv->full_tlist = g_list_reverse (priv->full_tlist);
+        for (node = g_list_last (tlist); node; node = node->prev)
+            g_ptr_array_add (priv->full_tarray, node->data);
     }
+    g_list_free (tlist);
+
+    gtm_sr_full_tindex_rebuild (priv);
 
     // Update the scrollbar
     gnc_tree_model_split_reg_sync_scrollbar (model);
 
-    model->number_of_trans_in_full_tlist = g_list_length (priv->full_tlist);
+    model->number_of_trans_in_full_tlist = priv->full_tarray->len;
 
-    if (g_list_length (priv->full_tlist) < NUM_OF_TRANS*3)
+    if (priv->full_tarray->len < NUM_OF_TRANS*3)
     {
-        // Copy the full_tlist to tlist
-        priv->tlist = g_list_copy (priv->full_tlist);
+        // Copy the full_tarray to tlist
+        gtm_sr_reg_load (model, VIEW_HOME, priv->full_tarray->len);
     }
     else
     {
         if (model->position_of_trans_in_full_tlist < (NUM_OF_TRANS*3))
             gtm_sr_reg_load (model, VIEW_HOME, NUM_OF_TRANS*3);
-        else if (model->position_of_trans_in_full_tlist > g_list_length (priv->full_tlist) - (NUM_OF_TRANS*3))
+        else if (model->position_of_trans_in_full_tlist > priv->full_tarray->len - (NUM_OF_TRANS*3))
             gtm_sr_reg_load (model, VIEW_END, NUM_OF_TRANS*3);
         else
             gtm_sr_reg_load (model, VIEW_GOTO, model->position_of_trans_in_full_tlist);
     }
 
     PINFO("#### Register for Account '%s' has %d transactions and %d splits and tlist is %d ####",
-          default_account ? xaccAccountGetName (default_account) : "NULL", g_list_length (priv->full_tlist), g_list_length (slist), g_list_length (priv->tlist));
+          default_account ? xaccAccountGetName (default_account) : "NULL", priv->full_tarray->len, g_list_length (slist), g_list_length (priv->tlist));
 
     /* Update the completion model liststores */
     g_idle_add ((GSourceFunc) gnc_tree_model_split_reg_update_completion, model);
@@ -680,15 +774,15 @@ void
 gnc_tree_model_split_reg_move (GncTreeModelSplitReg *model, GncTreeModelSplitRegUpdate model_update)
 {
     GncTreeModelSplitRegPrivate *priv;
-    GList *inode, *dnode;
-    gint rows = 0;
+    Transaction *trans;
+    gint i;
     gint icount = 0;
     gint dcount = 0;
 
     priv = model->priv;
 
     // if list is not long enough, return
-    if (g_list_length (priv->full_tlist) < NUM_OF_TRANS*3)
+    if (priv->full_tarray->len < NUM_OF_TRANS*3)
         return;
 
     if ((model_update == VIEW_UP) && (model->current_row < NUM_OF_TRANS) && (priv->tlist_start > 0))
@@ -709,34 +803,21 @@ gnc_tree_model_split_reg_move (GncTreeModelSplitReg *model, GncTreeModelSplitReg
         priv->tlist_start = iblock_start;
 
         // Insert at the front end
-        for (inode = g_list_nth (priv->full_tlist, iblock_end); inode; inode = inode->prev)
+        for (i = iblock_end; i >= iblock_start; i--)
         {
-            Transaction *trans = inode->data;
-
-            gtm_sr_insert_trans (model, trans, TRUE);
-
-            rows++;
-
-            if (rows == icount)
-                break;
+            if ((trans = gtm_sr_full_tarray_nth (priv, i)))
+                gtm_sr_insert_trans (model, trans, TRUE);
         }
-        rows = 0;
         // Delete at the back end
-        for (dnode = g_list_nth (priv->full_tlist, dblock_end); dnode; dnode = dnode->prev)
+        for (i = dblock_end; i >= dblock_start; i--)
         {
-            Transaction *trans = dnode->data;
-
-            gtm_sr_delete_trans (model, trans);
-
-            rows++;
-
-            if (rows == dcount)
-                break;
+            if ((trans = gtm_sr_full_tarray_nth (priv, i)))
+                gtm_sr_delete_trans (model, trans);
         }
         g_signal_emit_by_name (model, "refresh_view");
     }
 
-    if ((model_update == VIEW_DOWN) && (model->current_row > NUM_OF_TRANS*2) && (priv->tlist_start < (g_list_length (priv->full_tlist) - NUM_OF_TRANS*3 )))
+    if ((model_update == VIEW_DOWN) && (model->current_row > NUM_OF_TRANS*2) && (priv->tlist_start < (priv->full_tarray->len - NUM_OF_TRANS*3 )))
     {
         gint dblock_end = 0;
         gint iblock_start = priv->tlist_start + NUM_OF_TRANS*3;
@@ -746,8 +827,8 @@ gnc_tree_model_split_reg_move (GncTreeModelSplitReg *model, GncTreeModelSplitReg
         if (iblock_start < 0)
             iblock_start = 0;
 
-        if (iblock_end > g_list_length (priv->full_tlist))
-            iblock_end = g_list_length (priv->full_tlist) - 1;
+        if (iblock_end >= priv->full_tarray->len)
+            iblock_end = priv->full_tarray->len - 1;
 
         icount = iblock_end - iblock_start + 1;
 
@@ -757,29 +838,16 @@ gnc_tree_model_split_reg_move (GncTreeModelSplitReg *model, GncTreeModelSplitReg
         priv->tlist_start = dblock_end;
 
         // Insert at the back end
-        for (inode = g_list_nth (priv->full_tlist, iblock_start); inode; inode = inode->next)
+        for (i = iblock_start; i <= iblock_end; i++)
         {
-            Transaction *trans = inode->data;
-
-            gtm_sr_insert_trans (model, trans, FALSE);
-
-            rows++;
-
-            if (rows == icount)
-                break;
+            if ((trans = gtm_sr_full_tarray_nth (priv, i)))
+                gtm_sr_insert_trans (model, trans, FALSE);
         }
-        rows = 0;
         // Delete at the front end
-        for (dnode = g_list_nth (priv->full_tlist, dblock_start); dnode; dnode = dnode->next)
+        for (i = dblock_start; i < dblock_end; i++)
         {
-            Transaction *trans = dnode->data;
-
-            gtm_sr_delete_trans (model, trans);
-
-            rows++;
-
-            if (rows == dcount)
-                break;
+            if ((trans = gtm_sr_full_tarray_nth (priv, i)))
+                gtm_sr_delete_trans (model, trans);
         }
         g_signal_emit_by_name (model, "refresh_view");
     }
@@ -791,20 +859,15 @@ Transaction *
 gnc_tree_model_split_reg_get_first_trans (GncTreeModelSplitReg *model)
 {
     GncTreeModelSplitRegPrivate *priv;
-    GList *node;
     Transaction *trans;
 
     priv = model->priv;
 
-    node = g_list_first (priv->full_tlist);
-
-    trans = node->data;
+    trans = gtm_sr_full_tarray_nth (priv, 0);
 
     if (trans == priv->btrans)
-    {
-        node = g_list_last (priv->full_tlist);
-        trans = node->data;
-    }
+        trans = gtm_sr_full_tarray_nth (priv, priv->full_tarray->len - 1);
+
     return trans;
 }
 
@@ -832,29 +895,22 @@ gnc_tree_model_split_reg_get_tooltip (GncTreeModelSplitReg *model, gint position
     Transaction *trans;
     char date_text[MAX_DATE_LENGTH + 1];
     const gchar *desc_text;
-    GList *node;
 
     memset (date_text, 0, sizeof(date_text));
     priv = model->priv;
 
-    node = g_list_nth (priv->full_tlist, position);
-    if (node == NULL)
+    trans = gtm_sr_full_tarray_nth (priv, position);
+    if (trans == NULL)
        return g_strconcat ("Error", NULL);
+    else if (trans == priv->btrans)
+       return g_strconcat ("Blank Transaction", NULL);
     else
     {
-        trans = node->data;
-        if (trans == NULL)
-           return g_strconcat ("Error", NULL);
-        else if (trans == priv->btrans)
-           return g_strconcat ("Blank Transaction", NULL);
-        else
-        {
-            time64 t = xaccTransRetDatePosted (trans);
-            qof_print_date_buff (date_text, MAX_DATE_LENGTH, t);
-            desc_text = xaccTransGetDescription (trans);
-            model->current_trans = trans;
-            return g_strconcat (date_text, "\n", desc_text, NULL);
-        }
+        time64 t = xaccTransRetDatePosted (trans);
+        qof_print_date_buff (date_text, MAX_DATE_LENGTH, t);
+        desc_text = xaccTransGetDescription (trans);
+        model->current_trans = trans;
+        return g_strconcat (date_text, "\n", desc_text, NULL);
     }
 }
 
@@ -864,15 +920,15 @@ void
 gnc_tree_model_split_reg_set_current_trans_by_position (GncTreeModelSplitReg *model, gint position)
 {
     GncTreeModelSplitRegPrivate *priv;
-    GList *node;
+    Transaction *trans;
 
     priv = model->priv;
 
-    node = g_list_nth (priv->full_tlist, position);
-    if (node == NULL)
-        node = g_list_last (priv->full_tlist);
+    trans = gtm_sr_full_tarray_nth (priv, position);
+    if (trans == NULL)
+        trans = gtm_sr_full_tarray_nth (priv, priv->full_tarray->len - 1);
 
-    model->current_trans = node->data;
+    model->current_trans = trans;
 }
 
 
@@ -884,7 +940,7 @@ gnc_tree_model_split_reg_sync_scrollbar (GncTreeModelSplitReg *model)
 
     priv = model->priv;
 
-    model->position_of_trans_in_full_tlist = g_list_index (priv->full_tlist, model->current_trans);
+    model->position_of_trans_in_full_tlist = gtm_sr_full_tarray_index (priv, model->current_trans);
 
     g_signal_emit_by_name (model, "scroll_sync");
 }
@@ -3155,6 +3211,7 @@ gnc_tree_model_split_reg_event_handler (QofInstance *entity,
                     {
                         g_signal_emit_by_name (model, "selection_move_delete", trans);
                         gtm_sr_delete_trans (model, trans);
+                        gtm_sr_full_tarray_remove (model, trans);
                     }
                 }
             }
@@ -3196,7 +3253,10 @@ gnc_tree_model_split_reg_event_handler (QofInstance *entity,
             {
                 DEBUG ("remove split %p from trans %p (%s)", split, trans, name);
                 if (ed->idx == -1)
+                {
                     gtm_sr_delete_trans (model, trans); //Not sure when this would be so
+                    gtm_sr_full_tarray_remove (model, trans);
+                }
                 else
                     gtm_sr_delete_row_at_path (model, path);
                 gtk_tree_path_free (path);
@@ -3211,6 +3271,12 @@ gnc_tree_model_split_reg_event_handler (QofInstance *entity,
                 priv->btrans = xaccMallocTransaction (priv->book);
                 priv->tlist = g_list_append (priv->tlist, priv->btrans);
 
+                /* The blank trans goes where a reload would put it */
+                if (model->sort_direction == GTK_SORT_ASCENDING)
+                    gtm_sr_full_tarray_insert (model, priv->btrans, -1);
+                else
+                    gtm_sr_full_tarray_insert (model, priv->btrans, 0);
+
                 tnode = g_list_find (priv->tlist, priv->btrans);
                 /* Insert a new blank trans */
                 iter1 = gtm_sr_make_iter (model, TROW1 | BLANK, tnode, NULL);
@@ -3234,6 +3300,7 @@ gnc_tree_model_split_reg_event_handler (QofInstance *entity,
                 tnode = g_list_find (priv->tlist, priv->btrans);
                 priv->btrans = xaccMallocTransaction (priv->book);
                 tnode->data = priv->btrans;
+                gtm_sr_full_tarray_replace (model, trans, priv->btrans);
                 iter1 = gtm_sr_make_iter (model, TROW1 | BLANK, tnode, NULL);
                 gtm_sr_changed_row_at (model, &iter1);
                 iter2 = gtm_sr_make_iter (model, TROW2 | BLANK, tnode, NULL);
@@ -3244,6 +3311,7 @@ gnc_tree_model_split_reg_event_handler (QofInstance *entity,
                 DEBUG("destroy trans %p (%s)", trans, name);
                 g_signal_emit_by_name (model, "selection_move_delete", trans);
                 gtm_sr_delete_trans (model, trans);
+                gtm_sr_full_tarray_remove (model, trans);
                 g_signal_emit_by_name (model, "refresh_trans", trans);
             }
             break;
@@ -3269,6 +3337,7 @@ gnc_tree_model_split_reg_event_handler (QofInstance *entity,
                 {
                     DEBUG("Insert trans %p for gl (%s)", trans, name);
                     gtm_sr_insert_trans (model, trans, TRUE);
+                    gtm_sr_full_tarray_insert (model, trans, priv->tlist_start);
                     g_signal_emit_by_name (model, "refresh_trans", trans);
                 }
             }
@@ -3276,6 +3345,7 @@ gnc_tree_model_split_reg_event_handler (QofInstance *entity,
             {
                 DEBUG("Insert trans %p (%s)", trans, name);
                 gtm_sr_insert_trans (model, trans, TRUE);
+                gtm_sr_full_tarray_insert (model, trans, priv->tlist_start);
                 g_signal_emit_by_name (model, "refresh_trans", trans);
             }
             break;
@@ -118,6 +118,7 @@ static void gnc_plugin_page_sx_list_save_page (GncPluginPage *plugin_page, GKeyF
 static GncPluginPage *gnc_plugin_page_sx_list_recreate_page (GtkWidget *window, GKeyFile *file, const gchar *group);
 
 static void gppsl_row_activated_cb(GtkTreeView *tree_view, GtkTreePath *path, GtkTreeViewColumn *column, gpointer user_data);
+static void gppsl_cal_months_changed_cb(GtkComboBox *view_options, gpointer user_data);
 
 static void gnc_plugin_page_sx_list_cmd_new(GtkAction *action, GncPluginPageSxList *page);
 static void gnc_plugin_page_sx_list_cmd_edit(GtkAction *action, GncPluginPageSxList *page);
@@ -332,6 +333,34 @@ gnc_plugin_page_sx_list_close_cb (gpointer user_data)
 }
 
 
+/* Move the instance model's horizon to cover num_months of calendar
+ * rather than regenerating it; the list always needs at least a year to
+ * show the next occurrence of yearly SXs.  Returns TRUE if it moved. */
+static gboolean
+gppsl_set_range_months(GncPluginPageSxListPrivate *priv, guint num_months)
+{
+    GDate end, old_end = priv->instances->range_end;
+
+    g_date_clear(&end, 1);
+    gnc_gdate_set_today (&end);
+    g_date_add_months(&end, MAX(num_months, 12));
+    gnc_sx_instance_model_set_range_end(priv->instances, &end);
+    return g_date_compare(&old_end, &end) != 0;
+}
+
+
+static void
+gppsl_cal_months_changed_cb(GtkComboBox *view_options, gpointer user_data)
+{
+    GncPluginPageSxListPrivate *priv = GNC_PLUGIN_PAGE_SX_LIST_GET_PRIVATE(user_data);
+    guint num_months = gnc_dense_cal_get_num_months(priv->gdcal);
+
+    /* Redraw the marks from the moved range. */
+    if (gppsl_set_range_months(priv, num_months))
+        gnc_dense_cal_set_num_months(priv->gdcal, num_months);
+}
+
+
 static void
 gppsl_selection_changed_cb(GtkTreeSelection *selection, gpointer user_data)
 {
@@ -471,6 +500,9 @@ gnc_plugin_page_sx_list_create_widget (GncPluginPage *plugin_page)
 
         gnc_dense_cal_set_months_per_col(priv->gdcal, 4);
         gnc_dense_cal_set_num_months(priv->gdcal, 12);
+        /* After the calendar's own handler, which drew the old range */
+        g_signal_connect(G_OBJECT(priv->gdcal->view_options), "changed",
+                         (GCallback)gppsl_cal_months_changed_cb, (gpointer)page);
 
         gtk_container_add (GTK_CONTAINER(swin), GTK_WIDGET(priv->gdcal));
     }
@@ -579,7 +611,10 @@ gnc_plugin_page_sx_list_recreate_page (GtkWidget *window,
         GError *err = NULL;
         gint num_months = g_key_file_get_integer(key_file, group_name, "dense_cal_num_months", &err);
         if (err == NULL)
+        {
+            gppsl_set_range_months(priv, num_months);
             gnc_dense_cal_set_num_months(priv->gdcal, num_months);
+        }
         else
             g_error_free(err);
     }
@@ -62,6 +62,11 @@
 // static QofLogModule log_module = GNC_MOD_SX;
 static QofLogModule log_module = GNC_MOD_GUI;
 
+/* Account registers in the standard sort order create rows for this
+ * many splits from the end of their list, and twice as many each time
+ * they are scrolled to the top. */
+#define GSR_LOAD_WINDOW 500
+
 /***** PROTOTYPES ***************************************************/
 void gnc_split_reg_raise( GNCSplitReg *gsr );
 
@@ -89,6 +94,8 @@ static void gsr_update_summary_label( GtkWidget *label,
                                       gboolean euroFlag );
 
 static void gsr_redraw_all_cb (GnucashRegister *g_reg, gpointer data);
+static void gsr_reset_load_window (GNCSplitReg *gsr);
+static void gsr_vadjustment_value_changed_cb (GtkAdjustment *adj, gpointer data);
 
 static void gnc_split_reg_ld_destroy( GNCLedgerDisplay *ledger );
 
@@ -359,6 +366,7 @@ gnc_split_reg_init( GNCSplitReg *gsr )
     gsr->height = -1;
     gsr->numRows = 10;
     gsr->read_only = FALSE;
+    gsr->load_window_idle = 0;
 }
 
 static void
@@ -396,6 +404,7 @@ gsr_setup_table( GNCSplitReg *gsr )
 
     sr = gnc_ledger_display_get_split_register( gsr->ledger );
     gnc_split_register_show_present_divider( sr, TRUE );
+    gsr_reset_load_window( gsr );
     /* events should be sufficient to redraw this */
     /* gnc_ledger_display_refresh( gsr->ledger ); */
 
@@ -439,8 +448,79 @@ gsr_create_table( GNCSplitReg *gsr )
                       G_CALLBACK(gsr_emit_help_changed), gsr);
     g_signal_connect (gsr->reg, "show_popup_menu",
                       G_CALLBACK(gsr_emit_show_popup_menu), gsr);
+    g_signal_connect (gtk_scrollable_get_vadjustment
+                      (GTK_SCROLLABLE(gnucash_register_get_sheet (gsr->reg))),
+                      "value_changed",
+                      G_CALLBACK(gsr_vadjustment_value_changed_cb), gsr);
+
+    LEAVE(" ");
+}
+
+/* Only account registers listing the oldest split first have their
+ * newest splits at the end of the list, where the window is taken from;
+ * the others load everything. */
+static void
+gsr_reset_load_window (GNCSplitReg *gsr)
+{
+    SplitRegister *sr = gnc_ledger_display_get_split_register (gsr->ledger);
+    GNCLedgerDisplayType ld_type = gnc_ledger_display_type (gsr->ledger);
+    gboolean windowed = (ld_type == LD_SINGLE || ld_type == LD_SUBACCOUNT) &&
+                        gsr->sort_type == BY_STANDARD && !gsr->sort_rev;
+
+    gnc_split_register_set_load_window (sr, windowed ? GSR_LOAD_WINDOW : 0);
+}
+
+/* Load more of the register once it has been scrolled to the top,
+ * keeping the rows that were on top in view. */
+static gboolean
+gsr_grow_load_window_idle (gpointer data)
+{
+    GNCSplitReg *gsr = data;
+    SplitRegister *sr = gnc_ledger_display_get_split_register (gsr->ledger);
+    GnucashSheet *sheet = gnucash_register_get_sheet (gsr->reg);
+    GtkAdjustment *vadj = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE(sheet));
+    VirtualCellLocation first_loc = { 1, 0 };
+    VirtualCellLocation old_first_loc = { 1, 0 };
+    SheetBlock *first, *old_first;
+    gint old_rows = sr->table->num_virt_rows;
+
+    gsr->load_window_idle = 0;
+    if (!gnc_split_register_load_truncated (sr) ||
+        gtk_adjustment_get_value (vadj) > gtk_adjustment_get_lower (vadj))
+        return FALSE;
+
+    ENTER("gsr=%p", gsr);
+    gnc_split_register_set_load_window
+        (sr, 2 * gnc_split_register_get_load_window (sr));
+    gnc_ledger_display_refresh (gsr->ledger);
+
+    old_first_loc.virt_row += sr->table->num_virt_rows - old_rows;
+    first = gnucash_sheet_get_block (sheet, first_loc);
+    old_first = gnucash_sheet_get_block (sheet, old_first_loc);
+    if (first && old_first)
+        gtk_adjustment_set_value (vadj, old_first->origin_y - first->origin_y);
 
     LEAVE(" ");
+    return FALSE;
+}
+
+static void
+gsr_vadjustment_value_changed_cb (GtkAdjustment *adj, gpointer data)
+{
+    GNCSplitReg *gsr = data;
+    SplitRegister *sr;
+
+    if (gsr->load_window_idle ||
+        gtk_adjustment_get_value (adj) > gtk_adjustment_get_lower (adj) ||
+        !gtk_widget_get_mapped (GTK_WIDGET(gsr->reg)))
+        return;
+
+    sr = gnc_ledger_display_get_split_register (gsr->ledger);
+    if (!gnc_split_register_load_truncated (sr))
+        return;
+
+    /* Not from here: the adjustment also changes while the sheet loads. */
+    gsr->load_window_idle = g_idle_add (gsr_grow_load_window_idle, gsr);
 }
 
 static
@@ -466,6 +546,10 @@ gnc_split_reg_dispose(GObject *obj)
         g_free (gsr->filter_text);
     gsr->filter_text = NULL;
 
+    if (gsr->load_window_idle)
+        g_source_remove (gsr->load_window_idle);
+    gsr->load_window_idle = 0;
+
     gnc_prefs_remove_cb_by_func (GNC_PREFS_GROUP_GENERAL,
                                  GNC_PREF_ACCOUNTING_LABELS,
                                  gnc_split_reg_pref_acc_labels,
@@ -473,6 +557,8 @@ gnc_split_reg_dispose(GObject *obj)
 
     if (gsr->reg)
     {
+        g_signal_handlers_disconnect_by_data (gtk_scrollable_get_vadjustment
+            (GTK_SCROLLABLE(gnucash_register_get_sheet (gsr->reg))), gsr);
         g_signal_handlers_disconnect_by_data (gsr->reg, gsr);
         gtk_widget_destroy (GTK_WIDGET (gsr->reg));
     }
@@ -1880,6 +1966,14 @@ gnc_split_reg_jump_to_split(GNCSplitReg *gsr, Split *split)
 
     reg = gnc_ledger_display_get_split_register( gsr->ledger );
 
+    /* The split may be before the rows that were loaded. */
+    if (!gnc_split_register_get_split_virt_loc(reg, split, &vcell_loc) &&
+            gnc_split_register_load_truncated (reg))
+    {
+        gnc_split_register_set_load_window (reg, 0);
+        gnc_ledger_display_refresh (gsr->ledger);
+    }
+
     if (gnc_split_register_get_split_virt_loc(reg, split, &vcell_loc))
         gnucash_register_goto_virt_cell( gsr->reg, vcell_loc );
 
@@ -1904,6 +1998,14 @@ gnc_split_reg_jump_to_split_amount(GNCSplitReg *gsr, Split *split)
 
     reg = gnc_ledger_display_get_split_register (gsr->ledger);
 
+    /* The split may be before the rows that were loaded. */
+    if (!gnc_split_register_get_split_amount_virt_loc (reg, split, &virt_loc) &&
+            gnc_split_register_load_truncated (reg))
+    {
+        gnc_split_register_set_load_window (reg, 0);
+        gnc_ledger_display_refresh (gsr->ledger);
+    }
+
     if (gnc_split_register_get_split_amount_virt_loc (reg, split, &virt_loc))
         gnucash_register_goto_virt_loc (gsr->reg, virt_loc);
 
@@ -2195,6 +2297,7 @@ gnc_split_reg_sort_force( GNCSplitReg *gsr, SortType sort_code, gboolean force )
     reg = gnc_ledger_display_get_split_register( gsr->ledger );
     gnc_split_register_show_present_divider( reg, show_present_divider );
     gsr->sort_type = sort_code;
+    gsr_reset_load_window( gsr );
     gnc_ledger_display_refresh( gsr->ledger );
 }
 
@@ -2286,6 +2389,7 @@ gnc_split_reg_set_sort_reversed(GNCSplitReg *gsr, gboolean rev, gboolean refresh
     Query *query = gnc_ledger_display_get_query( gsr->ledger );
     qof_query_set_sort_increasing (query, !rev, !rev, !rev);
     gsr->sort_rev = rev;
+    gsr_reset_load_window( gsr );
     if (refresh)
         gnc_ledger_display_refresh( gsr->ledger );
 }
@@ -93,6 +93,9 @@ struct _GNCSplitReg
     gchar   *filter_text;
 
     gboolean read_only;
+
+    /** Idle source growing the register's load window, 0 if none. **/
+    guint    load_window_idle;
 };
 
 struct _GNCSplitRegClass
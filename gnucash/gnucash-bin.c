@@ -55,6 +55,7 @@
 #include "dialog-new-user.h"
 #include "gnc-session.h"
 #include "gnc-engine-guile.h"
+#include "gnc-guile-utils.h"
 #include "swig-runtime.h"
 #include "guile-mappings.h"
 #include "window-report.h"
@@ -99,6 +100,8 @@ static char        *log_to_filename  = NULL;
 static int          nofile           = 0;
 static const gchar *gsettings_prefix = NULL;
 static const char  *add_quotes_file  = NULL;
+static gchar      **run_reports      = NULL;
+static const char  *report_output    = NULL;
 static char        *namespace_regexp = NULL;
 static const char  *file_to_load     = NULL;
 static gchar      **args_remaining   = NULL;
@@ -151,6 +154,20 @@ static GOptionEntry options[] =
            http://developer.gnome.org/doc/API/2.0/glib/glib-Commandline-option-parser.html */
         N_("FILE")
     },
+    {
+        "run-report", '\0', 0, G_OPTION_ARG_STRING_ARRAY, &run_reports,
+        N_("Render the saved report with the given name or guid of the datafile to html, without starting the user interface.\nThis can be invoked multiple times; the reports are rendered one after the other."),
+        /* Translators: Argument description for autohelp; see
+           http://developer.gnome.org/doc/API/2.0/glib/glib-Commandline-option-parser.html */
+        N_("REPORT")
+    },
+    {
+        "report-output", '\0', 0, G_OPTION_ARG_STRING, &report_output,
+        N_("Directory the reports of --run-report are written to; defaults to the current directory."),
+        /* Translators: Argument description for autohelp; see
+           http://developer.gnome.org/doc/API/2.0/glib/glib-Commandline-option-parser.html */
+        N_("DIRECTORY")
+    },
     {
         "namespace", '\0', 0, G_OPTION_ARG_STRING, &namespace_regexp,
         N_("Regular expression determining which namespace commodities will be retrieved"),
@@ -529,8 +546,10 @@ inner_main_add_price_quotes(void *closure, int argc, char **argv)
     mod = scm_c_resolve_module("gnucash price-quotes");
     scm_set_current_module(mod);
 
-    /* Don't load the modules since the stylesheet module crashes if the
-       GUI is not initialized */
+    /* Price quotes don't need the gnucash modules.  The report modules,
+       stylesheets included, no longer need the GUI though: --run-report
+       loads them without gtk, as do the test-link-module-report and
+       report scheme tests under ctest. */
 #ifdef PRICE_QUOTES_NEED_MODULES
     load_gnucash_modules();
 #endif
@@ -583,6 +602,134 @@ fail:
     gnc_shutdown(1);
 }
 
+typedef struct
+{
+    gchar *filename;
+    gchar *html;
+} ReportOutput;
+
+static gint report_write_failures = 0;
+
+/* Runs on the writer pool, so the next report can be rendered while
+ * the previous one is written out. */
+static void
+write_report_output (gpointer data, gpointer user_data)
+{
+    ReportOutput *output = data;
+    GError *error = NULL;
+
+    if (!g_file_set_contents (output->filename, output->html, -1, &error))
+    {
+        g_printerr ("%s: %s\n", output->filename, error->message);
+        g_error_free (error);
+        g_atomic_int_inc (&report_write_failures);
+    }
+    g_free (output->filename);
+    g_free (output->html);
+    g_free (output);
+}
+
+static gchar *
+report_output_filename (const gchar *report_name)
+{
+    gchar *name = g_strdelimit (g_strconcat (report_name, ".html", NULL),
+                                "/\\:*?\"<>|", '_');
+    gchar *filename = g_build_filename (report_output ? report_output : ".",
+                                        name, NULL);
+    g_free (name);
+    return filename;
+}
+
+static void
+inner_main_run_reports (void *closure, int argc, char **argv)
+{
+    SCM render;
+    QofSession *session = NULL;
+    GThreadPool *writers = NULL;
+    gint64 start;
+    int i, failed = 0;
+
+    scm_c_eval_string("(debug-set! stack 200000)");
+
+    scm_set_current_module(scm_c_resolve_module("gnucash utilities"));
+    scm_c_use_module("gnucash app-utils");
+
+    gnc_prefs_init ();
+    /* Only the report system is needed; the gui modules would require
+       gtk to be initialized.  The report module loads gnome-utils and the
+       stylesheets, which is safe without gtk: test-link-module-report
+       loads it the same way, and the report scheme tests load
+       (gnucash reports) and render with a stylesheet, all headless. */
+    gnc_module_load("gnucash/report", 0);
+    scm_c_use_module("gnucash reports");
+    load_system_config();
+    load_user_config();
+    render = scm_c_eval_string("gnc:report-render-saved");
+
+    if (!file_to_load)
+    {
+        g_printerr("%s", _("No datafile given to run the reports on.\n"));
+        gnc_shutdown(1);
+        return;
+    }
+
+    start = g_get_monotonic_time ();
+    qof_event_suspend();
+    session = gnc_get_current_session();
+    /* The book is only read, so don't bother with (or fail on) the lock */
+    qof_session_begin(session, file_to_load, TRUE, FALSE, FALSE);
+    if (qof_session_get_error(session) == ERR_BACKEND_NO_ERR)
+        qof_session_load(session, NULL);
+    qof_event_resume();
+    if (qof_session_get_error(session) != ERR_BACKEND_NO_ERR)
+    {
+        g_warning("Session Error: %s", qof_session_get_error_message(session));
+        gnc_clear_current_session();
+        gnc_shutdown(1);
+        return;
+    }
+    g_print("%s: %.3fs\n", file_to_load,
+            (g_get_monotonic_time () - start) / (gdouble) G_USEC_PER_SEC);
+
+    /* Rendering runs in guile and walks the engine, neither of which
+       may be entered from several threads, so reports are rendered one
+       after the other while their output is written concurrently. */
+    writers = g_thread_pool_new (write_report_output, NULL,
+                                 g_get_num_processors (), FALSE, NULL);
+
+    for (i = 0; run_reports[i]; i++)
+    {
+        SCM html;
+        gdouble elapsed;
+
+        start = g_get_monotonic_time ();
+        html = scm_call_1(render, scm_from_utf8_string(run_reports[i]));
+        elapsed = (g_get_monotonic_time () - start) / (gdouble) G_USEC_PER_SEC;
+
+        if (scm_is_string (html))
+        {
+            ReportOutput *output = g_new0 (ReportOutput, 1);
+            output->filename = report_output_filename (run_reports[i]);
+            output->html = gnc_scm_to_utf8_string (html);
+            g_print("%s: %.3fs -> %s\n", run_reports[i], elapsed,
+                    output->filename);
+            g_thread_pool_push (writers, output, NULL);
+        }
+        else
+        {
+            g_printerr(_("Report \"%s\" not found or failed to run.\n"),
+                       run_reports[i]);
+            failed++;
+        }
+    }
+
+    /* Wait for all pending output to be written */
+    g_thread_pool_free (writers, FALSE, TRUE);
+    gnc_clear_current_session();
+
+    gnc_shutdown((failed || g_atomic_int_get (&report_write_failures)) ? 1 : 0);
+}
+
 static char *
 get_file_to_load()
 {
@@ -908,6 +1055,14 @@ main(int argc, char ** argv)
         exit(0);  /* never reached */
     }
 
+    /* Reports can be run without the gui as well */
+    if (run_reports)
+    {
+        gnc_module_system_init();
+        scm_boot_guile(argc, argv, inner_main_run_reports, 0);
+        exit(0);  /* never reached */
+    }
+
     /* We need to initialize gtk before looking up all modules */
     if(!gtk_init_check (&argc, &argv))
     {
@@ -30,6 +30,7 @@ extern "C" {
 #endif
 
 #include <glib/gi18n.h>
+#include "gnc-locale-utils.h"
 }
 
 #include <boost/regex.hpp>
@@ -184,7 +185,7 @@ void GncTxImport::base_account (Account* base_account)
                             GncTransPropType::NONE);
 
         /* Set default account for each line's split properties */
-        for (auto line : m_parsed_lines)
+        for (auto& line : m_parsed_lines)
             std::get<PL_PRESPLIT>(line)->set_account (m_settings.m_base_account);
 
 
@@ -390,7 +391,8 @@ void GncTxImport::tokenize (bool guessColTypes)
     uint32_t max_cols = 0;
     m_tokenizer->tokenize();
     m_parsed_lines.clear();
-    for (auto tokenized_line : m_tokenizer->get_tokens())
+    m_parsed_lines.reserve (m_tokenizer->get_tokens().size());
+    for (auto& tokenized_line : m_tokenizer->get_tokens())
     {
         auto length = tokenized_line.size();
         if (length > 0)
@@ -416,7 +418,7 @@ void GncTxImport::tokenize (bool guessColTypes)
         set_column_type (i, m_settings.m_column_types[i], true);
     if (m_settings.m_base_account)
     {
-        for (auto line : m_parsed_lines)
+        for (auto& line : m_parsed_lines)
             std::get<PL_PRESPLIT>(line)->set_account (m_settings.m_base_account);
     }
 
@@ -676,7 +678,9 @@ void GncTxImport::create_transaction (std::vector<parse_line_t>::iterator& parse
         if (draft_trans)
         {
             auto trans_date = xaccTransGetDate (draft_trans->trans);
-            m_transactions.insert (std::pair<time64, std::shared_ptr<DraftTransaction>>(trans_date,std::move(draft_trans)));
+            /* Lines usually come in date order, in which case the end is
+             * the right insert position and this hint saves a tree search. */
+            m_transactions.emplace_hint (m_transactions.end(), trans_date, std::move(draft_trans));
         }
     }
     catch (const std::invalid_argument& e)
@@ -853,51 +857,81 @@ GncTxImport::set_column_type (uint32_t position, GncTransPropType type, bool for
     if (type == GncTransPropType::ACCOUNT)
         base_account (nullptr);
 
+    /* Reset date and currency formats for each trans/split props object
+     * to ensure column updates use the most recent one.
+     * This is done before the lines are updated in parallel below: in
+     * multi-split mode several lines share one GncPreTrans.
+     */
+    for (auto& parsed_line : m_parsed_lines)
+    {
+        std::get<PL_PRETRANS>(parsed_line)->set_date_format (m_settings.m_date_format);
+        std::get<PL_PRESPLIT>(parsed_line)->set_date_format (m_settings.m_date_format);
+        std::get<PL_PRESPLIT>(parsed_line)->set_currency_format (m_settings.m_currency_format);
+    }
+
     /* Update the preparsed data */
     m_parent = nullptr;
-    for (auto parsed_lines_it = m_parsed_lines.begin();
-            parsed_lines_it != m_parsed_lines.end();
-            ++parsed_lines_it)
+    auto update_lines = [this, position, old_type, type](size_t begin, size_t end)
     {
-        /* Reset date and currency formats for each trans/split props object
-         * to ensure column updates use the most recent one
-         */
-        std::get<PL_PRETRANS>(*parsed_lines_it)->set_date_format (m_settings.m_date_format);
-        std::get<PL_PRESPLIT>(*parsed_lines_it)->set_date_format (m_settings.m_date_format);
-        std::get<PL_PRESPLIT>(*parsed_lines_it)->set_currency_format (m_settings.m_currency_format);
-
-        uint32_t row = parsed_lines_it - m_parsed_lines.begin();
-
-        /* If the column type actually changed, first reset the property
-         * represented by the old column type
-         */
-        if (old_type != type)
+        for (auto row = begin; row < end; row++)
         {
-            auto old_col = std::get<PL_INPUT>(*parsed_lines_it).size(); // Deliberately out of bounds to trigger a reset!
-            if ((old_type > GncTransPropType::NONE)
-                    && (old_type <= GncTransPropType::TRANS_PROPS))
-                update_pre_trans_props (row, old_col, old_type);
-            else if ((old_type > GncTransPropType::TRANS_PROPS)
-                    && (old_type <= GncTransPropType::SPLIT_PROPS))
-                update_pre_split_props (row, old_col, old_type);
-        }
+            auto& parsed_line = m_parsed_lines[row];
 
-        /* Then set the property represented by the new column type */
-        if ((type > GncTransPropType::NONE)
-                && (type <= GncTransPropType::TRANS_PROPS))
-            update_pre_trans_props (row, position, type);
-        else if ((type > GncTransPropType::TRANS_PROPS)
-                && (type <= GncTransPropType::SPLIT_PROPS))
-            update_pre_split_props (row, position, type);
-
-        /* Report errors if there are any */
-        auto trans_errors = std::get<PL_PRETRANS>(*parsed_lines_it)->errors();
-        auto split_errors = std::get<PL_PRESPLIT>(*parsed_lines_it)->errors(m_req_mapped_accts);
-        std::get<PL_ERROR>(*parsed_lines_it) =
-                trans_errors +
-                (trans_errors.empty() && split_errors.empty() ? std::string() : "\n") +
-                split_errors;
+            /* If the column type actually changed, first reset the property
+             * represented by the old column type
+             */
+            if (old_type != type)
+            {
+                auto old_col = std::get<PL_INPUT>(parsed_line).size(); // Deliberately out of bounds to trigger a reset!
+                if ((old_type > GncTransPropType::NONE)
+                        && (old_type <= GncTransPropType::TRANS_PROPS))
+                    update_pre_trans_props (row, old_col, old_type);
+                else if ((old_type > GncTransPropType::TRANS_PROPS)
+                        && (old_type <= GncTransPropType::SPLIT_PROPS))
+                    update_pre_split_props (row, old_col, old_type);
+            }
 
+            /* Then set the property represented by the new column type */
+            if ((type > GncTransPropType::NONE)
+                    && (type <= GncTransPropType::TRANS_PROPS))
+                update_pre_trans_props (row, position, type);
+            else if ((type > GncTransPropType::TRANS_PROPS)
+                    && (type <= GncTransPropType::SPLIT_PROPS))
+                update_pre_split_props (row, position, type);
+
+            /* Report errors if there are any */
+            auto trans_errors = std::get<PL_PRETRANS>(parsed_line)->errors();
+            auto split_errors = std::get<PL_PRESPLIT>(parsed_line)->errors(m_req_mapped_accts);
+            std::get<PL_ERROR>(parsed_line) =
+                    trans_errors +
+                    (trans_errors.empty() && split_errors.empty() ? std::string() : "\n") +
+                    split_errors;
+        }
+    };
+
+    /* Parsing the values of one line doesn't depend on any other line,
+     * so large files are parsed in parallel, except when
+     * - an account or commodity column is involved: these are looked up
+     *   in the book and the engine is not thread safe
+     * - transaction properties change in multi-split mode: each line
+     *   then has to be linked to the transaction started by a previous line
+     */
+    auto is_trans_prop = [](GncTransPropType prop_type)
+        { return (prop_type > GncTransPropType::NONE) &&
+                 (prop_type <= GncTransPropType::TRANS_PROPS); };
+    auto uses_book = [](GncTransPropType prop_type)
+        { return (prop_type == GncTransPropType::ACCOUNT) ||
+                 (prop_type == GncTransPropType::TACCOUNT) ||
+                 (prop_type == GncTransPropType::COMMODITY); };
+    if (uses_book (type) || uses_book (old_type) ||
+        (m_settings.m_multi_split && (is_trans_prop (type) || is_trans_prop (old_type))))
+        update_lines (0, m_parsed_lines.size());
+    else
+    {
+        /* Amount parsing reads the cached locale information, make sure it
+         * is set up before any thread starts using it */
+        gnc_localeconv ();
+        gnc_parallel_slices (m_parsed_lines.size(), 1000, update_lines);
     }
 }
 
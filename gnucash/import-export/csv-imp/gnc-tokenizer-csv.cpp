@@ -4,6 +4,7 @@
 #include <fstream>      // fstream
 #include <vector>
 #include <string>
+#include <string_view>
 #include <algorithm>    // copy
 #include <iterator>     // ostream_operator
 
@@ -22,90 +23,197 @@ GncCsvTokenizer::set_separators(const std::string& separators)
 }
 
 
-int GncCsvTokenizer::tokenize()
+/* Only whitespace as recognized by boost::trim in the classic locale */
+static std::string_view
+trim_view (std::string_view str)
 {
-    using Tokenizer = boost::tokenizer< boost::escaped_list_separator<char>>;
-
-    boost::escaped_list_separator<char> sep("\\", m_sep_str, "\"");
+    const char* ws = " \t\n\v\f\r";
+    auto first = str.find_first_not_of (ws);
+    if (first == std::string_view::npos)
+        return std::string_view();
+    auto last = str.find_last_not_of (ws);
+    return str.substr (first, last - first + 1);
+}
 
-    StrVec vec;
-    std::string line;
-    std::string buffer;
+/* Split the contents into records. A record usually is a single line, but
+ * quoted fields may contain line breaks, in which case the record spans
+ * multiple lines. The returned views point into the contents string,
+ * nothing is copied here.
+ * Quote handling is kept identical to what the line based parser
+ * did before: a double quote that is not escaped with a backslash toggles
+ * the "inside quotes" state. A final record with an unterminated quote
+ * is dropped. */
+static std::vector<std::string_view>
+split_records (std::string_view contents)
+{
+    std::vector<std::string_view> records;
+    bool inside_quotes = false;
+    size_t rec_start = 0;
+    size_t line_start = 0;
 
-    bool inside_quotes(false);
-    size_t last_quote(0);
+    while (line_start < contents.size())
+    {
+        auto line_end = contents.find ('\n', line_start);
+        if (line_end == std::string_view::npos)
+            line_end = contents.size();
 
-    m_tokenized_contents.clear();
-    std::istringstream in_stream(m_utf8_contents);
+        for (auto pos = contents.find ('"', line_start);
+             pos < line_end; pos = contents.find ('"', pos + 1))
+            if (pos == line_start || contents[pos - 1] != '\\')
+                inside_quotes = !inside_quotes;
 
-    try
-    {
-        while (std::getline (in_stream, buffer))
+        if (!inside_quotes)
         {
-            // --- deal with line breaks in quoted strings
-            buffer = boost::trim_copy (buffer); // Removes trailing newline and spaces
-            last_quote = buffer.find_first_of('"');
-            while (last_quote != std::string::npos)
-            {
-                if (last_quote == 0) // Test separately because last_quote - 1 would be out of range
-                    inside_quotes = !inside_quotes;
-                else if (buffer[ last_quote - 1 ] != '\\')
-                    inside_quotes = !inside_quotes;
+            records.push_back (contents.substr (rec_start, line_end - rec_start));
+            rec_start = line_end + 1;
+        }
+        line_start = line_end + 1;
+    }
 
-                last_quote = buffer.find_first_of('"',last_quote+1);
-            }
+    return records;
+}
 
-            line.append(buffer);
-            if (inside_quotes)
-            {
-                line.append(" ");
-                continue;
-            }
-            // ---
+/* Tokenize a record that has no line breaks, backslashes or doubled
+ * quotes. Fields without quotes are copied straight out of the record.
+ * This yields the same fields as boost's escaped_list_separator would,
+ * including no fields at all for a blank line. */
+static StrVec
+tokenize_simple_record (std::string_view record, const std::string& separators)
+{
+    StrVec vec;
+    auto line = trim_view (record);
+    if (line.empty())
+        return vec;
 
-            // Deal with backslashes that are not meant to be escapes
-            // The boost::tokenizer with escaped_list_separator as we use
-            // it would choke on this.
-            auto bs_pos = line.find ('\\');
-            while (bs_pos != std::string::npos)
-            {
-                if ((bs_pos == line.size()) ||                                 // got trailing single backslash
-                    (line.find_first_of ("\"\\n", bs_pos + 1) != bs_pos + 1))  // backslash is not part of known escapes \\, \" or \n
-                    line = line.substr(0, bs_pos) + "\\\\" + line.substr(bs_pos + 1);
-                bs_pos += 2;
-                bs_pos = line.find ('\\', bs_pos);
-            }
+    size_t field_start = 0;
 
-            // Deal with repeated " ("") in strings.
-            // This is commonly used as escape mechanism for double quotes in csv files.
-            // However boost just eats them.
-            bs_pos = line.find ("\"\"");
-            while (bs_pos != std::string::npos)
+    while (true)
+    {
+        bool inside_quotes = false;
+        bool has_quotes = false;
+        auto pos = field_start;
+        for (; pos < line.size(); pos++)
+        {
+            if (line[pos] == '"')
             {
-                // Only make changes in case the double quotes are part of a larger field
-                // In other words a field which only contains two double quotes represent an
-                // empty field. We don't need to touch those.
-                // The way to determine whether the double quotes represent an empty string
-                // is by checking whether the character in front or after are either
-                // a field separator or the beginning or end of of the string.
-                if (!(((bs_pos == 0) ||                                          // quotes are at start of line
-                       (m_sep_str.find (line[bs_pos-1]) != std::string::npos))    // quotes preceded by field separator
-                      &&
-                      ((bs_pos + 2 >= line.length()) ||                          // quotes are at end of line
-                       (m_sep_str.find (line[bs_pos+2]) != std::string::npos))))   // quotes followed by field separator
-                    // Only make changes in case the double quotes are not an empty field
-                    line.replace (bs_pos, 2, "\\\"");
-                bs_pos = line.find ("\"\"", bs_pos + 2);
+                inside_quotes = !inside_quotes;
+                has_quotes = true;
             }
+            else if (!inside_quotes && separators.find (line[pos]) != std::string::npos)
+                break;
+        }
 
-            Tokenizer tok(line, sep);
-            vec.assign(tok.begin(),tok.end());
-            m_tokenized_contents.push_back(vec);
-            line.clear();
+        auto field = line.substr (field_start, pos - field_start);
+        if (!has_quotes)
+            vec.emplace_back (field);
+        else
+        {
+            vec.emplace_back ();
+            vec.back().reserve (field.size());
+            for (auto c : field)
+                if (c != '"')
+                    vec.back().push_back (c);
         }
+
+        if (pos >= line.size())
+            break;
+        field_start = pos + 1;
+    }
+
+    return vec;
+}
+
+/* Tokenize any other record. Its physical lines are joined, the contents
+ * is massaged to work around boost::tokenizer's idiosyncrasies and the
+ * result is split by boost's escaped_list_separator. */
+static StrVec
+tokenize_complex_record (std::string_view record, const std::string& separators)
+{
+    using Tokenizer = boost::tokenizer< boost::escaped_list_separator<char>>;
+
+    boost::escaped_list_separator<char> sep("\\", separators, "\"");
+
+    // --- deal with line breaks in quoted strings
+    std::string line;
+    size_t line_start = 0;
+    while (true)
+    {
+        auto line_end = record.find ('\n', line_start);
+        line.append (trim_view (record.substr (line_start, line_end - line_start)));
+        if (line_end == std::string_view::npos)
+            break;
+        line.append (" ");
+        line_start = line_end + 1;
+    }
+
+    // Deal with backslashes that are not meant to be escapes
+    // The boost::tokenizer with escaped_list_separator as we use
+    // it would choke on this.
+    auto bs_pos = line.find ('\\');
+    while (bs_pos != std::string::npos)
+    {
+        if ((bs_pos == line.size()) ||                                 // got trailing single backslash
+            (line.find_first_of ("\"\\n", bs_pos + 1) != bs_pos + 1))  // backslash is not part of known escapes \\, \" or \n
+            line = line.substr(0, bs_pos) + "\\\\" + line.substr(bs_pos + 1);
+        bs_pos += 2;
+        bs_pos = line.find ('\\', bs_pos);
+    }
+
+    // Deal with repeated " ("") in strings.
+    // This is commonly used as escape mechanism for double quotes in csv files.
+    // However boost just eats them.
+    bs_pos = line.find ("\"\"");
+    while (bs_pos != std::string::npos)
+    {
+        // Only make changes in case the double quotes are part of a larger field
+        // In other words a field which only contains two double quotes represent an
+        // empty field. We don't need to touch those.
+        // The way to determine whether the double quotes represent an empty string
+        // is by checking whether the character in front or after are either
+        // a field separator or the beginning or end of of the string.
+        if (!(((bs_pos == 0) ||                                          // quotes are at start of line
+               (separators.find (line[bs_pos-1]) != std::string::npos))    // quotes preceded by field separator
+              &&
+              ((bs_pos + 2 >= line.length()) ||                          // quotes are at end of line
+               (separators.find (line[bs_pos+2]) != std::string::npos))))   // quotes followed by field separator
+            // Only make changes in case the double quotes are not an empty field
+            line.replace (bs_pos, 2, "\\\"");
+        bs_pos = line.find ("\"\"", bs_pos + 2);
+    }
+
+    Tokenizer tok(line, sep);
+    return StrVec (tok.begin(), tok.end());
+}
+
+/* Records are independent once their boundaries are known, so they are
+ * tokenized in parallel slices. The bulk of a typical bank export only
+ * consists of simple records, which are split without intermediate copies. */
+int GncCsvTokenizer::tokenize()
+{
+    auto records = split_records (m_utf8_contents);
+
+    m_tokenized_contents.clear();
+    m_tokenized_contents.resize (records.size());
+
+    try
+    {
+        gnc_parallel_slices (records.size(), 1000,
+            [this, &records](size_t begin, size_t end)
+            {
+                for (auto i = begin; i < end; i++)
+                {
+                    auto record = records[i];
+                    if (record.find_first_of ("\n\\") == std::string_view::npos &&
+                        record.find ("\"\"") == std::string_view::npos)
+                        m_tokenized_contents[i] = tokenize_simple_record (record, m_sep_str);
+                    else
+                        m_tokenized_contents[i] = tokenize_complex_record (record, m_sep_str);
+                }
+            });
     }
     catch (boost::escaped_list_error &e)
     {
+        m_tokenized_contents.clear();
         throw (std::range_error N_("There was an error parsing the file."));
     }
 
@@ -44,6 +44,9 @@ extern "C" {
 #include <vector>
 #include <string>
 #include <memory>
+#include <thread>
+#include <exception>
+#include <algorithm>
 
 using StrVec = std::vector<std::string>;
 
@@ -88,4 +91,56 @@ private:
 // Function to instantiate specializations of the GncTokenizer
 std::unique_ptr<GncTokenizer> gnc_tokenizer_factory(GncImpFileFormat fmt);
 
+/** Run func(begin, end) over consecutive slices of the range [0, count)
+ *  using one thread per available cpu core. Slices are never made
+ *  smaller than min_slice, so small inputs are handled on the calling
+ *  thread without starting any threads.
+ *  func must only touch data belonging to its own slice.
+ *  @exception rethrows the first exception thrown by any slice, after
+ *             all slices have finished.
+ */
+template <typename Func> void
+gnc_parallel_slices (size_t count, size_t min_slice, Func func)
+{
+    size_t num_threads = std::max (1u, std::thread::hardware_concurrency());
+    num_threads = std::min (num_threads, std::max<size_t> (1, count / std::max<size_t> (1, min_slice)));
+    if (num_threads <= 1)
+    {
+        func (0, count);
+        return;
+    }
+
+    auto slice = (count + num_threads - 1) / num_threads;
+    std::vector<std::exception_ptr> errors (num_threads);
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < num_threads; i++)
+        threads.emplace_back ([&, i]()
+            {
+                try
+                {
+                    func (std::min (count, i * slice), std::min (count, (i + 1) * slice));
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                }
+            });
+
+    // The calling thread handles the first slice itself
+    try
+    {
+        func (0, std::min (count, slice));
+    }
+    catch (...)
+    {
+        errors[0] = std::current_exception();
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+    for (auto& error : errors)
+        if (error)
+            std::rethrow_exception (error);
+}
+
 #endif
@@ -199,6 +199,65 @@ TEST_F (GncTokenizerTest, tokenize_semicolon_sep)
 }
 
 
+/* Blank lines, including one at the end of the file, yield empty
+ * records rather than a single empty field. */
+TEST_F (GncTokenizerTest, tokenize_blank_lines)
+{
+    GncCsvTokenizer *csvtok = dynamic_cast<GncCsvTokenizer*>(csv_tok.get());
+    csvtok->set_separators (",");
+
+    set_utf8_contents (csv_tok, "a,b\n\nc,d\n  \t\n");
+    csv_tok->tokenize();
+
+    auto tokens = csv_tok->get_tokens();
+    ASSERT_EQ (4ul, tokens.size());
+    EXPECT_EQ (2ul, tokens[0].size());
+    EXPECT_TRUE (tokens[1].empty());
+    EXPECT_EQ (2ul, tokens[2].size());
+    EXPECT_EQ (std::string ("d"), tokens[2][1]);
+    EXPECT_TRUE (tokens[3].empty());
+}
+
+/* Quoted fields can span lines. Use enough records for the tokenizer
+ * to process them in multiple slices and check the order is preserved. */
+TEST_F (GncTokenizerTest, tokenize_many_records)
+{
+    GncCsvTokenizer *csvtok = dynamic_cast<GncCsvTokenizer*>(csv_tok.get());
+    csvtok->set_separators (",");
+
+    std::string contents;
+    const auto num_records = 10000;
+    for (auto i = 0; i < num_records; i++)
+    {
+        auto num = std::to_string (i);
+        if (i % 100 == 0)
+            contents += num + ",\"multi\nline\",\"\"\n";
+        else
+            contents += num + ",\"quoted, with separator\",plain\n";
+    }
+    set_utf8_contents (csv_tok, contents);
+    csv_tok->tokenize();
+
+    auto tokens = csv_tok->get_tokens();
+    ASSERT_EQ (static_cast<size_t>(num_records), tokens.size());
+    for (auto i = 0; i < num_records; i++)
+    {
+        auto& line_tok = tokens[i];
+        ASSERT_EQ (3ul, line_tok.size());
+        EXPECT_EQ (std::to_string (i), line_tok[0]);
+        if (i % 100 == 0)
+        {
+            EXPECT_EQ (std::string ("multi line"), line_tok[1]);
+            EXPECT_EQ (std::string (""), line_tok[2]);
+        }
+        else
+        {
+            EXPECT_EQ (std::string ("quoted, with separator"), line_tok[1]);
+            EXPECT_EQ (std::string ("plain"), line_tok[2]);
+        }
+    }
+}
+
 
 void
 GncTokenizerTest::test_gnc_tokenize_helper (tokenize_fw_test_data* test_data)
@@ -40,6 +40,7 @@
 #include "Account.h"
 #include "Query.h"
 #include "gnc-engine.h"
+#include "gnc-event.h"
 #include "engine-helpers.h"
 #include "gnc-prefs.h"
 #include "gnc-ui-util.h"
@@ -70,6 +71,8 @@ matchmap_store_destination (GncImportMatchMap *matchmap,
                             GNCImportTransInfo *trans_info,
                             gboolean use_match);
 
+static void online_id_index_update_split (Split *split);
+
 
 /********************************************************************\
  *               Structures passed between the functions            *
@@ -590,9 +593,14 @@ matchmap_store_destination (GncImportMatchMap *matchmap,
 
 
 /** @brief The transaction matching heuristics are here.
+ *
+ * The amounts of the downloaded and the candidate split are passed in
+ * as doubles, so callers can convert them only once.
  */
 static void split_find_match (GNCImportTransInfo * trans_info,
                               Split * split,
+                              double downloaded_split_amount,
+                              double match_split_amount,
                               gint display_threshold,
                               double fuzzy_amount_difference)
 {
@@ -605,7 +613,6 @@ static void split_find_match (GNCImportTransInfo * trans_info,
         GNCImportMatchInfo * match_info;
         gint prob = 0;
         gboolean update_proposed;
-        double downloaded_split_amount, match_split_amount;
         time64 match_time, download_time;
         int datediff_day;
         Transaction *new_trans = gnc_import_TransInfo_get_trans (trans_info);
@@ -614,10 +621,7 @@ static void split_find_match (GNCImportTransInfo * trans_info,
         /* Matching heuristics */
 
         /* Amount heuristics */
-        downloaded_split_amount =
-            gnc_numeric_to_double (xaccSplitGetAmount(new_trans_fsplit));
         /*DEBUG(" downloaded_split_amount=%f", downloaded_split_amount);*/
-        match_split_amount = gnc_numeric_to_double(xaccSplitGetAmount(split));
         /*DEBUG(" match_split_amount=%f", match_split_amount);*/
         if (fabs(downloaded_split_amount - match_split_amount) < 1e-6)
             /* bug#347791: Double type shouldn't be compared for exact
@@ -811,6 +815,7 @@ void gnc_import_find_split_matches(GNCImportTransInfo *trans_info,
 {
     GList * list_element;
     Query *query = qof_query_create_for(GNC_ID_SPLIT);
+    double downloaded_split_amount;
     g_assert (trans_info);
 
     /* Get list of splits of the originating account. */
@@ -834,25 +839,23 @@ void gnc_import_find_split_matches(GNCImportTransInfo *trans_info,
                                  QOF_QUERY_AND);
         list_element = qof_query_run (query);
         /* Sigh. Doesn't help too much. We still create and run one query
-           for each imported transaction. Maybe it would improve
-           performance further if there is one single (master-)query at
-           the beginning, matching the full date range and all accounts in
-           question. However, this doesn't quite work because this function
-           here is called from each gnc_gen_trans_list_add_trans(), which
-           is called one at a time. Therefore the whole importer would
-           have to change its behaviour: Accept the imported txns via
-           gnc_gen_trans_list_add_trans(), and only when
-           gnc_gen_trans_list_run() is called, then calculate all the
-           different match candidates. That's too much work for now.
+           for each imported transaction. Callers matching many
+           transactions should use gnc_import_find_split_matches_indexed
+           instead, which sorts the candidate splits of an account only
+           once per import.
         */
     }
 
     /* Traverse that list, calling split_find_match on each one. Note
        that xaccAccountForEachSplit is declared in Account.h but
        implemented nowhere :-( */
+    downloaded_split_amount =
+        gnc_numeric_to_double (xaccSplitGetAmount (gnc_import_TransInfo_get_fsplit (trans_info)));
     while (list_element != NULL)
     {
-        split_find_match (trans_info, list_element->data,
+        Split *split = list_element->data;
+        split_find_match (trans_info, split, downloaded_split_amount,
+                          gnc_numeric_to_double (xaccSplitGetAmount (split)),
                           process_threshold, fuzzy_amount_difference);
         list_element = g_list_next (list_element);
     }
@@ -860,6 +863,196 @@ void gnc_import_find_split_matches(GNCImportTransInfo *trans_info,
     qof_query_destroy (query);
 }
 
+/********************************************************************\
+ * Match candidate index.
+ *
+ * Running a QofQuery over the import account for each imported
+ * transaction is expensive for large statements. A GNCImportMatchIndex
+ * instead holds, per account, all splits sorted by date posted with
+ * their amounts already converted to double. It is built once per
+ * account and import session and finding the candidates for a
+ * transaction is a binary search on the date window. When splits are
+ * added to or removed from an indexed account, or a transaction with a
+ * split in it is modified, its entry is dropped and rebuilt on next
+ * use.
+\********************************************************************/
+
+typedef struct
+{
+    time64 date;
+    double amount;
+    Split *split;
+} MatchCandidate;
+
+struct _matchindex
+{
+    GHashTable *accounts;  /* Account* -> GArray* of MatchCandidate */
+    gint event_handler_id;
+};
+
+static gint
+match_candidate_compare (gconstpointer a, gconstpointer b)
+{
+    const MatchCandidate *ca = a, *cb = b;
+
+    if (ca->date != cb->date)
+        return ca->date < cb->date ? -1 : 1;
+    /* Same order as the query's default sort for equal dates */
+    return xaccSplitOrder (ca->split, cb->split);
+}
+
+static void
+match_index_handle_event (QofInstance *entity, QofEventId event_type,
+                          gpointer user_data, gpointer event_data)
+{
+    GNCImportMatchIndex *index = user_data;
+
+    if (GNC_IS_ACCOUNT (entity))
+    {
+        if (event_type & (GNC_EVENT_ITEM_ADDED | GNC_EVENT_ITEM_REMOVED |
+                          GNC_EVENT_ITEM_CHANGED | QOF_EVENT_DESTROY))
+            g_hash_table_remove (index->accounts, entity);
+        return;
+    }
+
+    if (!(event_type & QOF_EVENT_MODIFY))
+        return;
+
+    /* The date or amount of an indexed split may have changed */
+    if (GNC_IS_SPLIT (entity))
+        g_hash_table_remove (index->accounts,
+                             xaccSplitGetAccount (GNC_SPLIT (entity)));
+    else if (GNC_IS_TRANSACTION (entity))
+    {
+        GList *node;
+        for (node = xaccTransGetSplitList (GNC_TRANSACTION (entity));
+             node; node = node->next)
+            g_hash_table_remove (index->accounts,
+                                 xaccSplitGetAccount (node->data));
+    }
+}
+
+static void
+match_candidates_free (gpointer data)
+{
+    g_array_free (data, TRUE);
+}
+
+GNCImportMatchIndex *
+gnc_import_MatchIndex_new (void)
+{
+    GNCImportMatchIndex *index = g_new0 (GNCImportMatchIndex, 1);
+
+    index->accounts = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                             NULL, match_candidates_free);
+    index->event_handler_id =
+        qof_event_register_handler (match_index_handle_event, index);
+    return index;
+}
+
+void
+gnc_import_MatchIndex_delete (GNCImportMatchIndex *index)
+{
+    if (!index)
+        return;
+
+    qof_event_unregister_handler (index->event_handler_id);
+    g_hash_table_destroy (index->accounts);
+    g_free (index);
+}
+
+static GArray *
+match_index_get_candidates (GNCImportMatchIndex *index, Account *account)
+{
+    GArray *candidates = g_hash_table_lookup (index->accounts, account);
+    GList *node;
+
+    if (candidates)
+        return candidates;
+
+    candidates = g_array_new (FALSE, FALSE, sizeof (MatchCandidate));
+    for (node = xaccAccountGetSplitList (account); node; node = node->next)
+    {
+        MatchCandidate candidate;
+
+        candidate.split = node->data;
+        candidate.date = xaccTransGetDate (xaccSplitGetParent (candidate.split));
+        candidate.amount = gnc_numeric_to_double (xaccSplitGetAmount (candidate.split));
+        g_array_append_val (candidates, candidate);
+    }
+    g_array_sort (candidates, match_candidate_compare);
+    g_hash_table_insert (index->accounts, account, candidates);
+
+    return candidates;
+}
+
+/* Returns the position of the first candidate dated at or after date */
+static guint
+match_candidates_lower_bound (GArray *candidates, time64 date)
+{
+    guint lo = 0, hi = candidates->len;
+
+    while (lo < hi)
+    {
+        guint mid = lo + (hi - lo) / 2;
+        if (g_array_index (candidates, MatchCandidate, mid).date < date)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* Score the candidates from position start on which are dated on or
+ * before end_time. */
+static void
+match_candidates_score (GNCImportTransInfo *trans_info, GArray *candidates,
+                        guint start, time64 end_time, gint process_threshold,
+                        double fuzzy_amount_difference)
+{
+    double downloaded_split_amount =
+        gnc_numeric_to_double (xaccSplitGetAmount (gnc_import_TransInfo_get_fsplit (trans_info)));
+    guint i;
+
+    for (i = start; i < candidates->len; i++)
+    {
+        MatchCandidate *candidate = &g_array_index (candidates, MatchCandidate, i);
+
+        if (candidate->date > end_time)
+            break;
+        split_find_match (trans_info, candidate->split, downloaded_split_amount,
+                          candidate->amount, process_threshold,
+                          fuzzy_amount_difference);
+    }
+}
+
+void
+gnc_import_find_split_matches_indexed (GNCImportTransInfo *trans_info,
+                                       GNCImportMatchIndex *index,
+                                       gint process_threshold,
+                                       double fuzzy_amount_difference,
+                                       gint match_date_hardlimit)
+{
+    Account *importaccount;
+    GArray *candidates;
+    time64 download_time;
+
+    g_assert (trans_info);
+    g_assert (index);
+
+    importaccount = xaccSplitGetAccount (gnc_import_TransInfo_get_fsplit (trans_info));
+    if (!importaccount)
+        return;
+
+    candidates = match_index_get_candidates (index, importaccount);
+    download_time = xaccTransGetDate (gnc_import_TransInfo_get_trans (trans_info));
+    match_candidates_score (trans_info, candidates,
+                            match_candidates_lower_bound (candidates,
+                                                          download_time - match_date_hardlimit * 86400),
+                            download_time + match_date_hardlimit * 86400,
+                            process_threshold, fuzzy_amount_difference);
+}
+
 
 /***********************************************************************
  */
@@ -1005,6 +1198,7 @@ gnc_import_process_trans_item (GncImportMatchMap *matchmap,
             /* Done editing. */
             /*DEBUG("CommitEdit selected_match")*/
             xaccTransCommitEdit(selected_match->trans);
+            online_id_index_update_split (selected_match->split);
 
             /* Store the mapping to the other account in the MatchMap. */
             matchmap_store_destination(matchmap, trans_info, TRUE);
@@ -1061,6 +1255,7 @@ gnc_import_process_trans_item (GncImportMatchMap *matchmap,
             /*DEBUG("CommitEdit selected_match")*/
             xaccTransCommitEdit
             (selected_match->trans);
+            online_id_index_update_split (selected_match->split);
 
             /* Store the mapping to the other account in the MatchMap. */
             matchmap_store_destination (matchmap, trans_info, TRUE);
@@ -1083,48 +1278,251 @@ gnc_import_process_trans_item (GncImportMatchMap *matchmap,
 }
 
 /********************************************************************\
- * check_trans_online_id() Callback function used by
- * gnc_import_exists_online_id.  Takes pointers to transaction and split,
- * returns 0 if their online_ids  do NOT match, or if the split
- * belongs to the transaction
+ * Index of online_ids per account.
+ *
+ * Checking every imported transaction against all splits of the
+ * destination account is O(n) per transaction. Instead we keep, per
+ * book, a table for each account mapping an online_id to the GUIDs of
+ * the splits carrying it. The table for an account is built on first
+ * use and then kept up to date from the engine events sent when splits
+ * are added to or removed from the account, or when transactions and
+ * splits are modified.
+ *
+ * Events may be suspended, so the index only yields candidates: a hit
+ * is looked up again by GUID and its account and online_id are checked
+ * before it counts as a duplicate. The index lives in the book's data
+ * and goes away, together with its event handler, when the book does.
 \********************************************************************/
-static gint check_trans_online_id(Transaction *trans1, void *user_data)
+
+#define IMPORT_ONLINE_ID_INDEX "gnc-import-online-id-index"
+
+typedef struct
 {
-    Account *account;
-    Split *split1;
-    Split *split2 = user_data;
-    const gchar *online_id1;
-    const gchar *online_id2;
-
-    account = xaccSplitGetAccount(split2);
-    split1 = xaccTransFindSplitByAccount(trans1, account);
-    if (split1 == split2)
-        return 0;
+    QofBook *book;
+    GHashTable *accounts;   /* Account* -> GHashTable* (online_id -> GList* of GncGUID*) */
+    gint handler_id;
+} OnlineIdIndex;
+
+static void
+online_id_table_free (gpointer data)
+{
+    GHashTable *table = data;
+    GHashTableIter iter;
+    gpointer value;
+
+    g_hash_table_iter_init (&iter, table);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+        g_list_free_full (value, (GDestroyNotify)guid_free);
+    g_hash_table_destroy (table);
+}
+
+static void
+online_id_index_free (QofBook *book, gpointer key, gpointer user_data)
+{
+    OnlineIdIndex *idx = user_data;
+
+    if (!idx) return;
+    qof_event_unregister_handler (idx->handler_id);
+    g_hash_table_destroy (idx->accounts);
+    g_free (idx);
+    qof_book_set_data (book, IMPORT_ONLINE_ID_INDEX, NULL);
+}
+
+/* Returns a newly allocated string with the online_id of the split,
+ * falling back to the transaction's online_id for older data. */
+static gchar *
+split_get_online_id (Split *split)
+{
+    gchar *online_id = (gchar*)gnc_import_get_split_online_id (split);
+
+    if (online_id && *online_id)
+        return online_id;
+
+    g_free (online_id);
+    online_id = (gchar*)gnc_import_get_trans_online_id (xaccSplitGetParent (split));
+    if (online_id && *online_id)
+        return online_id;
+
+    g_free (online_id);
+    return NULL;
+}
+
+static GList *
+guid_list_find (GList *guids, const GncGUID *guid)
+{
+    for (; guids; guids = guids->next)
+        if (guid_equal (guids->data, guid))
+            return guids;
+    return NULL;
+}
 
-    /* hack - we really want to iterate over the _splits_ of the account
-       instead of the transactions */
-    g_assert(split1 != NULL);
+static void
+online_id_table_add_split (GHashTable *table, Split *split)
+{
+    gchar *online_id = split_get_online_id (split);
+    const GncGUID *guid = xaccSplitGetGUID (split);
+    GList *guids;
 
-    if (gnc_import_split_has_online_id(split1))
-        online_id1 = gnc_import_get_split_online_id(split1);
+    if (!online_id)
+        return;
+
+    guids = g_hash_table_lookup (table, online_id);
+    if (guid_list_find (guids, guid))
+    {
+        g_free (online_id);
+        return;
+    }
+    /* Insert after the head to keep the list pointer stored in the
+     * table valid. */
+    if (guids)
+    {
+        guids = g_list_insert (guids, guid_copy (guid), 1);
+        g_free (online_id);
+    }
     else
-        online_id1 = gnc_import_get_trans_online_id(trans1);
+        g_hash_table_insert (table, online_id,
+                             g_list_prepend (NULL, guid_copy (guid)));
+}
+
+static void
+online_id_table_remove_split (GHashTable *table, Split *split)
+{
+    gchar *online_id = split_get_online_id (split);
+    GList *guids, *node;
 
-    online_id2 = gnc_import_get_split_online_id(split2);
+    if (!online_id)
+        return;
 
-    if ((online_id1 == NULL) ||
-            (online_id2 == NULL) ||
-            (strcmp(online_id1, online_id2) != 0))
+    guids = g_hash_table_lookup (table, online_id);
+    node = guid_list_find (guids, xaccSplitGetGUID (split));
+    if (node)
     {
-        return 0;
+        guid_free (node->data);
+        guids = g_list_delete_link (guids, node);
+        if (guids)
+            g_hash_table_replace (table, online_id, guids);
+        else
+        {
+            g_hash_table_remove (table, online_id);
+            g_free (online_id);
+        }
     }
     else
+        g_free (online_id);
+}
+
+/* Re-read the online_id of a split whose transaction changed */
+static void
+online_id_index_refresh_split (OnlineIdIndex *idx, Split *split)
+{
+    Account *account = xaccSplitGetAccount (split);
+    GHashTable *table;
+
+    if (!account)
+        return;
+
+    table = g_hash_table_lookup (idx->accounts, account);
+    if (table)
+        online_id_table_add_split (table, split);
+}
+
+static void
+online_id_index_handle_event (QofInstance *entity, QofEventId event_type,
+                              gpointer user_data, gpointer event_data)
+{
+    OnlineIdIndex *idx = user_data;
+    GHashTable *table;
+
+    if (qof_instance_get_book (entity) != idx->book)
+        return;
+
+    if (GNC_IS_ACCOUNT (entity))
+    {
+        table = g_hash_table_lookup (idx->accounts, entity);
+        if (!table)
+            return;
+
+        /* After a batch commit all splits may have changed */
+        if ((event_type & QOF_EVENT_DESTROY) ||
+            ((event_type & GNC_EVENT_ITEM_CHANGED) && !event_data))
+            g_hash_table_remove (idx->accounts, entity);
+        else if (event_type & GNC_EVENT_ITEM_ADDED)
+            online_id_table_add_split (table, event_data);
+        else if (event_type & GNC_EVENT_ITEM_REMOVED)
+            online_id_table_remove_split (table, event_data);
+        return;
+    }
+
+    if (!(event_type & QOF_EVENT_MODIFY))
+        return;
+
+    /* The online_id may have been set on the split or transaction */
+    if (GNC_IS_SPLIT (entity))
+        online_id_index_refresh_split (idx, GNC_SPLIT (entity));
+    else if (GNC_IS_TRANSACTION (entity))
     {
-        /*printf("test_trans_online_id(): Duplicate found\n");*/
-        return 1;
+        GList *node;
+        for (node = xaccTransGetSplitList (GNC_TRANSACTION (entity));
+             node; node = node->next)
+            online_id_index_refresh_split (idx, node->data);
     }
 }
 
+static OnlineIdIndex *
+online_id_index_lookup (QofBook *book)
+{
+    OnlineIdIndex *idx = qof_book_get_data (book, IMPORT_ONLINE_ID_INDEX);
+
+    if (idx)
+        return idx;
+
+    idx = g_new0 (OnlineIdIndex, 1);
+    idx->book = book;
+    idx->accounts = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                           NULL, online_id_table_free);
+    idx->handler_id = qof_event_register_handler (online_id_index_handle_event,
+                                                  idx);
+    qof_book_set_data_fin (book, IMPORT_ONLINE_ID_INDEX, idx,
+                           online_id_index_free);
+    return idx;
+}
+
+static GHashTable *
+online_id_index_get_table (Account *account)
+{
+    OnlineIdIndex *idx = online_id_index_lookup (gnc_account_get_book (account));
+    GHashTable *table;
+    GList *node;
+
+    table = g_hash_table_lookup (idx->accounts, account);
+    if (table)
+        return table;
+
+    table = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    for (node = xaccAccountGetSplitList (account); node; node = node->next)
+        online_id_table_add_split (table, node->data);
+    g_hash_table_insert (idx->accounts, account, table);
+
+    return table;
+}
+
+/* Make sure the index knows about a changed online_id of a split which
+ * already is in its account. */
+static void
+online_id_index_update_split (Split *split)
+{
+    OnlineIdIndex *idx;
+    Account *account = xaccSplitGetAccount (split);
+
+    if (!account)
+        return;
+
+    idx = qof_book_get_data (gnc_account_get_book (account),
+                             IMPORT_ONLINE_ID_INDEX);
+    if (idx)
+        online_id_index_refresh_split (idx, split);
+}
+
 /** Checks whether the given transaction's online_id already exists in
   its parent account. */
 gboolean gnc_import_exists_online_id (Transaction *trans)
@@ -1132,6 +1530,7 @@ gboolean gnc_import_exists_online_id (Transaction *trans)
     gboolean online_id_exists = FALSE;
     Account *dest_acct;
     Split *source_split;
+    gchar *online_id;
 
     /* Look for an online_id in the first split */
     source_split = xaccTransGetSplit(trans, 0);
@@ -1139,9 +1538,30 @@ gboolean gnc_import_exists_online_id (Transaction *trans)
 
     /* DEBUG("%s%d%s","Checking split ",i," for duplicates"); */
     dest_acct = xaccSplitGetAccount(source_split);
-    online_id_exists = xaccAccountForEachTransaction(dest_acct,
-                       check_trans_online_id,
-                       source_split);
+    online_id = (gchar*)gnc_import_get_split_online_id (source_split);
+    if (dest_acct && online_id)
+    {
+        QofBook *book = gnc_account_get_book (dest_acct);
+        GList *node = g_hash_table_lookup (online_id_index_get_table (dest_acct),
+                                           online_id);
+
+        /* Any split other than the source split which still is in the
+         * account and still carries the online_id is a duplicate */
+        for (; node && !online_id_exists; node = node->next)
+        {
+            Split *split = xaccSplitLookup (node->data, book);
+            gchar *split_online_id;
+
+            if (!split || split == source_split ||
+                xaccSplitGetAccount (split) != dest_acct)
+                continue;
+            split_online_id = split_get_online_id (split);
+            online_id_exists = (split_online_id &&
+                                g_strcmp0 (split_online_id, online_id) == 0);
+            g_free (split_online_id);
+        }
+    }
+    g_free (online_id);
 
     /* If it does, abort the process for this transaction, since it is
        already in the system. */
@@ -1191,23 +1611,14 @@ static gint compare_probability (gconstpointer a,
            ((GNCImportMatchInfo *)a)->probability);
 }
 
-/** Iterates through all splits of the originating account of
- * trans_info. Sorts the resulting list and sets the selected_match
- * and action fields in the trans_info.
+/** Sorts the match list of trans_info and sets the selected_match
+ * and action fields accordingly.
  */
-void
-gnc_import_TransInfo_init_matches (GNCImportTransInfo *trans_info,
-                                   GNCImportSettings *settings)
+static void
+trans_info_select_best_match (GNCImportTransInfo *trans_info,
+                              GNCImportSettings *settings)
 {
     GNCImportMatchInfo * best_match = NULL;
-    g_assert (trans_info);
-
-
-    /* Find all split matches in originating account. */
-    gnc_import_find_split_matches(trans_info,
-                                  gnc_import_Settings_get_display_threshold (settings),
-                                  gnc_import_Settings_get_fuzzy_amount (settings),
-                                  gnc_import_Settings_get_match_date_hardlimit (settings));
 
     if (trans_info->match_list != NULL)
     {
@@ -1258,6 +1669,38 @@ gnc_import_TransInfo_init_matches (GNCImportTransInfo *trans_info,
 }
 
 
+/** Iterates through all splits of the originating account of
+ * trans_info. Sorts the resulting list and sets the selected_match
+ * and action fields in the trans_info.
+ */
+void
+gnc_import_TransInfo_init_matches (GNCImportTransInfo *trans_info,
+                                   GNCImportSettings *settings)
+{
+    g_assert (trans_info);
+
+    /* Find all split matches in originating account. */
+    gnc_import_find_split_matches(trans_info,
+                                  gnc_import_Settings_get_display_threshold (settings),
+                                  gnc_import_Settings_get_fuzzy_amount (settings),
+                                  gnc_import_Settings_get_match_date_hardlimit (settings));
+    trans_info_select_best_match (trans_info, settings);
+}
+
+void
+gnc_import_TransInfo_init_matches_indexed (GNCImportTransInfo *trans_info,
+                                           GNCImportSettings *settings,
+                                           GNCImportMatchIndex *index)
+{
+    g_assert (trans_info);
+
+    gnc_import_find_split_matches_indexed (trans_info, index,
+                                           gnc_import_Settings_get_display_threshold (settings),
+                                           gnc_import_Settings_get_fuzzy_amount (settings),
+                                           gnc_import_Settings_get_match_date_hardlimit (settings));
+    trans_info_select_best_match (trans_info, settings);
+}
+
 /* Try to automatch a transaction to a destination account if the */
 /* transaction hasn't already been manually assigned to another account */
 gboolean
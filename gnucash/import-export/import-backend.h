@@ -33,6 +33,7 @@
 
 typedef struct _transactioninfo GNCImportTransInfo;
 typedef struct _selected_match_info GNCImportSelectedMatchInfo;
+typedef struct _matchindex GNCImportMatchIndex;
 typedef struct _matchinfo
 {
     Transaction * trans;
@@ -66,6 +67,17 @@ typedef enum _action
  * online_id. */
 gboolean gnc_import_exists_online_id (Transaction *trans);
 
+/** Create a new match index. A match index caches the candidate splits
+ * of the import accounts, sorted by date, for the duration of an import
+ * session. The cached splits of an account are dropped when the engine
+ * reports splits added to or removed from it, or a modified transaction
+ * with a split in it. Changes made while engine events are suspended
+ * go unnoticed, so don't keep an index across such code. */
+GNCImportMatchIndex *gnc_import_MatchIndex_new (void);
+
+/** Destroy a match index. */
+void gnc_import_MatchIndex_delete (GNCImportMatchIndex *index);
+
 /** Iterate through all splits of the originating account of the given
  * transaction, find all matching splits there, and store them in the
  * GNCImportTransInfo structure.
@@ -95,6 +107,14 @@ void gnc_import_find_split_matches(GNCImportTransInfo *trans_info,
                                    double fuzzy_amount_difference,
                                    gint match_date_hardlimit);
 
+/** Same as gnc_import_find_split_matches, but uses the given match
+ * index to find the candidate splits. */
+void gnc_import_find_split_matches_indexed (GNCImportTransInfo *trans_info,
+                                            GNCImportMatchIndex *index,
+                                            gint process_threshold,
+                                            double fuzzy_amount_difference,
+                                            gint match_date_hardlimit);
+
 /** Iterates through all splits of the originating account of
  * trans_info. Sorts the resulting list and sets the selected_match
  * and action fields in the trans_info.
@@ -108,6 +128,22 @@ void
 gnc_import_TransInfo_init_matches (GNCImportTransInfo *trans_info,
                                    GNCImportSettings *settings);
 
+/** Same as gnc_import_TransInfo_init_matches, but finds the candidate
+ * splits using the given match index instead of running a query for
+ * each transaction. The match results are identical.
+ *
+ * @param trans_info The TransInfo for which the matches should be
+ * found, sorted, and selected.
+ *
+ * @param settings The structure that holds all the user preferences.
+ *
+ * @param index The match index of the current import session.
+ */
+void
+gnc_import_TransInfo_init_matches_indexed (GNCImportTransInfo *trans_info,
+                                           GNCImportSettings *settings,
+                                           GNCImportMatchIndex *index);
+
 /** This function is intended to be called when the importer dialog is
  * finished. It should be called once for each imported transaction
  * and processes each ImportTransInfo according to its selected action:
@@ -359,8 +359,54 @@ static void dump_split_record(split_record record)
     }
 }
 
+/* The replayed transactions are committed together, up to this many
+ * at a time, with xaccTransCommitEditBatch. */
+#define REPLAY_BATCH_SIZE 1000
+
+typedef struct
+{
+    GList *trans_list;     /* Transactions waiting for the commit, last first */
+    guint length;
+    GHashTable *pending;   /* The same transactions, for lookups */
+} ReplayBatch;
+
+static void replay_batch_commit (ReplayBatch *batch)
+{
+    GList *trans_list = g_list_reverse (batch->trans_list);
+
+    batch->trans_list = NULL;
+    batch->length = 0;
+    g_hash_table_remove_all (batch->pending);
+    xaccTransCommitEditBatch (trans_list);
+    g_list_free (trans_list);
+}
+
+static void replay_batch_add (ReplayBatch *batch, Transaction *trans)
+{
+    batch->trans_list = g_list_prepend (batch->trans_list, trans);
+    batch->length++;
+    g_hash_table_add (batch->pending, trans);
+    if (batch->length >= REPLAY_BATCH_SIZE)
+        replay_batch_commit (batch);
+}
+
+/* A record for a transaction still waiting in the batch is replayed on
+ * top of its committed state, so commit the batch first. */
+static Transaction *replay_batch_lookup (ReplayBatch *batch,
+                                         const GncGUID *guid, QofBook *book)
+{
+    Transaction *trans = xaccTransLookup (guid, book);
+
+    if (trans && g_hash_table_contains (batch->pending, trans))
+    {
+        replay_batch_commit (batch);
+        trans = xaccTransLookup (guid, book);
+    }
+    return trans;
+}
+
 /* File pointer must already be at the beginning of a record */
-static void  process_trans_record(  FILE *log_file)
+static void  process_trans_record(  FILE *log_file, ReplayBatch *batch)
 {
     char read_buf[2048];
     char *read_retval;
@@ -400,8 +446,8 @@ static void  process_trans_record(  FILE *log_file)
                     break;
                 case LOG_DELETE:
                     DEBUG("process_trans_record(): Playing back LOG_DELETE");
-                    if ((trans = xaccTransLookup (&(record.trans_guid), book)) != NULL
-                            && first_record == TRUE)
+                    if (first_record == TRUE &&
+                            (trans = replay_batch_lookup (batch, &(record.trans_guid), book)) != NULL)
                     {
                         first_record = FALSE;
                         if (xaccTransGetReadOnly(trans))
@@ -424,7 +470,7 @@ static void  process_trans_record(  FILE *log_file)
                     if (record.trans_guid_present == TRUE
                             && first_record == TRUE)
                     {
-                        trans = xaccTransLookupDirect (record.trans_guid, book);
+                        trans = replay_batch_lookup (batch, &(record.trans_guid), book);
                         if (trans != NULL)
                         {
                             DEBUG("process_trans_record(): Transaction to be edited was found");
@@ -535,11 +581,11 @@ static void  process_trans_record(  FILE *log_file)
         {
             record_ended = TRUE;
             DEBUG("process_trans_record(): Record ended\n");
-            if (trans != NULL) /*If we played with a transaction, commit it here*/
+            if (trans != NULL) /*If we played with a transaction, commit it with the batch*/
             {
                 xaccTransScrubCurrency(trans);
                 xaccTransSetReadOnly(trans, trans_ro);
-                xaccTransCommitEdit(trans);
+                replay_batch_add(batch, trans);
                 g_free(trans_ro);
             }
         }
@@ -636,16 +682,22 @@ void gnc_file_log_replay (GtkWindow *parent)
                     }
                     else
                     {
+                        ReplayBatch batch = { NULL, 0, NULL };
+
+                        batch.pending = g_hash_table_new (g_direct_hash,
+                                                          g_direct_equal);
                         do
                         {
                             read_retval = fgets(read_buf, sizeof(read_buf), log_file);
                             /*DEBUG("Chunk read: %s",read_retval);*/
                             if (read_retval && strncmp(record_start_str, read_buf, strlen(record_start_str)) == 0) /* If a record started */
                             {
-                                process_trans_record(log_file);
+                                process_trans_record(log_file, &batch);
                             }
                         }
                         while (feof(log_file) == 0);
+                        replay_batch_commit (&batch);
+                        g_hash_table_destroy (batch.pending);
                     }
                 }
                 fclose(log_file);
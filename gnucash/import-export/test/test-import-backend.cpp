@@ -0,0 +1,295 @@
+/********************************************************************
+ * test-import-backend.cpp: test suite for the import matcher.      *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+extern "C" {
+#include <config.h>
+#include <unittest-support.h>
+
+#include <glib.h>
+#include <gtk/gtk.h> /* for references in import-backend.h */
+#include "import-backend.h"
+#include "cashobjects.h"
+#include "gnc-ui-util.h"
+#include "Account.h"
+#include "Split.h"
+#include "Transaction.h"
+}
+
+static const gchar *suitename = "/import-export/import-backend";
+
+/* Matching parameters as used by the OFX importer */
+static const gint display_threshold = 1;
+static const double fuzzy_amount = 3.0;
+static const gint date_hardlimit = 42;
+
+typedef struct
+{
+    guint num_book_txns;
+    guint num_imported_txns;
+} StatementSize;
+
+typedef struct
+{
+    QofBook *book;
+    gnc_commodity *currency;
+    Account *import_acc;
+    Account *other_acc;
+    GList *imported;  /* GNCImportTransInfo's */
+} Fixture;
+
+static const time64 base_date = 1420113600; /* 2015-01-01 12:00 UTC */
+
+static gnc_numeric
+synthetic_amount (guint i)
+{
+    return gnc_numeric_create (((i * 7919) % 50000) - 25000, 100);
+}
+
+static Transaction *
+synthetic_txn (Fixture *fixture, guint i, gboolean commit)
+{
+    Transaction *txn = xaccMallocTransaction (fixture->book);
+    Split *split = xaccMallocSplit (fixture->book);
+    gnc_numeric amount = synthetic_amount (i);
+    gchar *desc = g_strdup_printf ("Payee %u", i % 97);
+    gchar *num = g_strdup_printf ("%u", i % 211);
+
+    xaccTransBeginEdit (txn);
+    xaccTransSetCurrency (txn, fixture->currency);
+    xaccTransSetDatePostedSecs (txn, base_date + (i % 730) * 86400);
+    xaccTransSetDescription (txn, desc);
+    xaccTransSetNum (txn, num);
+
+    xaccSplitSetParent (split, txn);
+    xaccSplitSetAccount (split, fixture->import_acc);
+    xaccSplitSetAmount (split, amount);
+    xaccSplitSetValue (split, amount);
+    xaccSplitSetMemo (split, desc);
+
+    if (commit)
+    {
+        Split *other = xaccMallocSplit (fixture->book);
+        xaccSplitSetParent (other, txn);
+        xaccSplitSetAccount (other, fixture->other_acc);
+        xaccSplitSetAmount (other, gnc_numeric_neg (amount));
+        xaccSplitSetValue (other, gnc_numeric_neg (amount));
+        xaccTransCommitEdit (txn);
+    }
+
+    g_free (desc);
+    g_free (num);
+    return txn;
+}
+
+static void
+setup (Fixture *fixture, gconstpointer pData)
+{
+    const StatementSize *size = static_cast<const StatementSize*>(pData);
+    guint i;
+
+    /* gnc_import_find_split_matches queries the current book */
+    fixture->book = gnc_get_current_book ();
+    fixture->currency = gnc_commodity_new (fixture->book, "US Dollar",
+                                           "CURRENCY", "USD", "840", 100);
+    fixture->import_acc = xaccMallocAccount (fixture->book);
+    fixture->other_acc = xaccMallocAccount (fixture->book);
+    xaccAccountSetCommodity (fixture->import_acc, fixture->currency);
+    xaccAccountSetCommodity (fixture->other_acc, fixture->currency);
+    fixture->imported = NULL;
+
+    xaccAccountBeginEdit (fixture->import_acc);
+    for (i = 0; i < size->num_book_txns; i++)
+        synthetic_txn (fixture, i, TRUE);
+    xaccAccountCommitEdit (fixture->import_acc);
+
+    /* The statement partly repeats existing transactions, partly is new */
+    for (i = 0; i < size->num_imported_txns; i++)
+    {
+        Transaction *txn = synthetic_txn (fixture, i * 3, FALSE);
+        fixture->imported = g_list_prepend (fixture->imported,
+                                            gnc_import_TransInfo_new (txn, NULL));
+    }
+}
+
+static void
+teardown (Fixture *fixture, gconstpointer pData)
+{
+    for (GList *node = fixture->imported; node; node = node->next)
+    {
+        auto trans_info = static_cast<GNCImportTransInfo*>(node->data);
+        g_list_foreach (gnc_import_TransInfo_get_match_list (trans_info),
+                        (GFunc)g_free, NULL);
+    }
+    g_list_free_full (fixture->imported,
+                      (GDestroyNotify)gnc_import_TransInfo_delete);
+    gnc_clear_current_session ();
+    test_clear_error_list ();
+}
+
+/* Runs the matcher on all trans_infos, with the query if index is
+ * NULL, and returns the matches found by this run. */
+static GList *
+collect_matches (GList *trans_infos, GNCImportMatchIndex *index)
+{
+    GList *result = NULL;
+
+    for (GList *node = trans_infos; node; node = node->next)
+    {
+        auto trans_info = static_cast<GNCImportTransInfo*>(node->data);
+        GList *before = gnc_import_TransInfo_get_match_list (trans_info);
+
+        if (index)
+            gnc_import_find_split_matches_indexed (trans_info, index,
+                                                   display_threshold,
+                                                   fuzzy_amount,
+                                                   date_hardlimit);
+        else
+            gnc_import_find_split_matches (trans_info, display_threshold,
+                                           fuzzy_amount, date_hardlimit);
+
+        /* New matches are prepended, take only those added by this run */
+        for (GList *m = gnc_import_TransInfo_get_match_list (trans_info);
+             m && m != before; m = m->next)
+            result = g_list_prepend (result, m->data);
+    }
+
+    return g_list_reverse (result);
+}
+
+static void
+assert_matches_equal (GList *plain, GList *indexed)
+{
+    GList *p, *i;
+
+    g_assert_cmpuint (g_list_length (plain), >, 0);
+    g_assert_cmpuint (g_list_length (plain), ==, g_list_length (indexed));
+    for (p = plain, i = indexed; p && i; p = p->next, i = i->next)
+    {
+        auto mp = static_cast<GNCImportMatchInfo*>(p->data);
+        auto mi = static_cast<GNCImportMatchInfo*>(i->data);
+        g_assert (mp->split == mi->split);
+        g_assert_cmpint (mp->probability, ==, mi->probability);
+        g_assert_cmpint (mp->update_proposed, ==, mi->update_proposed);
+    }
+}
+
+static void
+test_indexed_matches_equal (Fixture *fixture, gconstpointer pData)
+{
+    GNCImportMatchIndex *index = gnc_import_MatchIndex_new ();
+    GList *plain = collect_matches (fixture->imported, NULL);
+    GList *indexed = collect_matches (fixture->imported, index);
+
+    assert_matches_equal (plain, indexed);
+    g_list_free (plain);
+    g_list_free (indexed);
+    gnc_import_MatchIndex_delete (index);
+}
+
+/* Editing dates and amounts of existing transactions must not leave the
+ * index with stale candidates. */
+static void
+test_indexed_matches_after_edit (Fixture *fixture, gconstpointer pData)
+{
+    GNCImportMatchIndex *index = gnc_import_MatchIndex_new ();
+    GList *plain, *indexed, *splits;
+    guint i = 0;
+
+    /* Fill the index */
+    g_list_free (collect_matches (fixture->imported, index));
+
+    /* Changing dates resorts the account's split list, walk a copy */
+    splits = g_list_copy (xaccAccountGetSplitList (fixture->import_acc));
+    for (GList *node = splits; node; node = node->next, i++)
+    {
+        auto split = static_cast<Split*>(node->data);
+        auto txn = xaccSplitGetParent (split);
+
+        if (i % 3)
+            continue;
+        xaccTransBeginEdit (txn);
+        if (i % 2)
+            xaccTransSetDatePostedSecs (txn, xaccTransGetDate (txn) + 90 * 86400);
+        else
+            xaccSplitSetAmount (split, gnc_numeric_neg (xaccSplitGetAmount (split)));
+        xaccTransCommitEdit (txn);
+    }
+    g_list_free (splits);
+
+    plain = collect_matches (fixture->imported, NULL);
+    indexed = collect_matches (fixture->imported, index);
+    assert_matches_equal (plain, indexed);
+    g_list_free (plain);
+    g_list_free (indexed);
+    gnc_import_MatchIndex_delete (index);
+}
+
+static void
+test_match_performance (Fixture *fixture, gconstpointer pData)
+{
+    const StatementSize *size = static_cast<const StatementSize*>(pData);
+    GList *matches;
+    gdouble query_time, indexed_time;
+
+    GNCImportMatchIndex *index;
+
+    g_test_timer_start ();
+    matches = collect_matches (fixture->imported, NULL);
+    query_time = g_test_timer_elapsed ();
+    g_list_free (matches);
+
+    g_test_timer_start ();
+    index = gnc_import_MatchIndex_new ();
+    matches = collect_matches (fixture->imported, index);
+    gnc_import_MatchIndex_delete (index);
+    indexed_time = g_test_timer_elapsed ();
+    g_list_free (matches);
+
+    g_test_message ("%u imported against %u existing transactions: "
+                    "query %.3fs, indexed %.3fs", size->num_imported_txns,
+                    size->num_book_txns, query_time, indexed_time);
+    g_test_minimized_result (indexed_time, "indexed matching %.3fs",
+                             indexed_time);
+}
+
+int
+main (int argc, char *argv[])
+{
+    static StatementSize small = { 500, 100 };
+    static StatementSize large = { 20000, 2000 };
+    int result;
+
+    qof_init ();
+    cashobjects_register ();
+    g_test_init (&argc, &argv, NULL);
+
+    GNC_TEST_ADD (suitename, "indexed matches equal query matches", Fixture,
+                  &small, setup, test_indexed_matches_equal, teardown);
+    GNC_TEST_ADD (suitename, "indexed matches after edits", Fixture,
+                  &small, setup, test_indexed_matches_after_edit, teardown);
+    if (g_test_perf ())
+        GNC_TEST_ADD (suitename, "match performance", Fixture, &large, setup,
+                      test_match_performance, teardown);
+
+    result = g_test_run ();
+
+    qof_close ();
+    return result;
+}
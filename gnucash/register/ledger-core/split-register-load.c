@@ -259,6 +259,38 @@ static void add_quickfill_completions(TableLayout *layout, Transaction *trans,
     }
 }
 
+/* Find the first split of slist that gets rows when the register has a
+ * load window.  The transactions under the cursor and being edited are
+ * always loaded, even when they are further up the list.  The list is
+ * walked once, with start trailing load_window splits behind. */
+static GList *
+load_window_start (SRInfo *info, GList *slist, Transaction *find_trans,
+                   Transaction *pending_trans)
+{
+    GList *lead, *start = slist;
+    gint count;
+
+    info->load_truncated = FALSE;
+    if (info->load_window <= 0)
+        return slist;
+
+    lead = slist;
+    for (count = 0; lead && count < info->load_window; count++)
+        lead = lead->next;
+
+    for (; lead; lead = lead->next, start = start->next)
+    {
+        Transaction *trans = xaccSplitGetParent (start->data);
+
+        if ((find_trans && trans == find_trans) ||
+            (pending_trans && trans == pending_trans))
+            break;
+    }
+
+    info->load_truncated = (start != slist);
+    return start;
+}
+
 static Split*
 create_blank_split (Account *default_account, SRInfo *info)
 {
@@ -363,6 +395,7 @@ gnc_split_register_load (SplitRegister *reg, GList * slist,
     Split *split;
     Table *table;
     GList *node;
+    GList *load_start;
 
     gboolean start_primary_color = TRUE;
     gboolean found_pending = FALSE;
@@ -549,8 +582,30 @@ gnc_split_register_load (SplitRegister *reg, GList * slist,
     if (multi_line)
         trans_table = g_hash_table_new (g_direct_hash, g_direct_equal);
 
+    load_start = load_window_start (info, slist, find_trans, pending_trans);
+
+    /* The splits before the load window get no rows, but on the first
+     * load they still fill up the quickfill cells. */
+    if (info->first_pass)
+    {
+        for (node = slist; node != load_start; node = node->next)
+        {
+            split = node->data;
+            trans = xaccSplitGetParent (split);
+
+            if (trans == blank_trans || !xaccTransStillHasSplit (trans, split))
+                continue;
+            if (xaccTransCountSplits (trans) == 1 &&
+                    xaccSplitGetAccount (split) == NULL)
+                continue;
+
+            add_quickfill_completions (reg->table->layout, trans, split,
+                                       has_last_num);
+        }
+    }
+
     /* populate the table */
-    for (node = slist; node; node = node->next)
+    for (node = load_start; node; node = node->next)
     {
         split = node->data;
         trans = xaccSplitGetParent (split);
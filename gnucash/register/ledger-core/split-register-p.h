@@ -133,6 +133,13 @@ struct sr_info
 
     /** true if the account separator has changed */
     gboolean separator_changed;
+
+    /** The number of splits to load from the end of the split list,
+     * zero to load all of them */
+    gint load_window;
+
+    /** true if the last load left out splits before the window */
+    gboolean load_truncated;
 };
 
 
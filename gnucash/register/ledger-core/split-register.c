@@ -2577,6 +2577,39 @@ gnc_split_register_show_present_divider (SplitRegister *reg,
     info->show_present_divider = show_present;
 }
 
+void
+gnc_split_register_set_load_window (SplitRegister *reg, gint num_splits)
+{
+    SRInfo *info = gnc_split_register_get_info (reg);
+
+    if (!info)
+        return;
+
+    info->load_window = MAX (num_splits, 0);
+}
+
+gint
+gnc_split_register_get_load_window (SplitRegister *reg)
+{
+    SRInfo *info = gnc_split_register_get_info (reg);
+
+    if (!info)
+        return 0;
+
+    return info->load_window;
+}
+
+gboolean
+gnc_split_register_load_truncated (SplitRegister *reg)
+{
+    SRInfo *info = gnc_split_register_get_info (reg);
+
+    if (!info)
+        return FALSE;
+
+    return info->load_truncated;
+}
+
 gboolean
 gnc_split_register_full_refresh_ok (SplitRegister *reg)
 {
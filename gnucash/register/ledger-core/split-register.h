@@ -523,6 +523,20 @@ gboolean gnc_split_register_changed (SplitRegister *reg);
 void gnc_split_register_show_present_divider (SplitRegister *reg,
         gboolean show_present);
 
+/** Only create rows for the last num_splits splits of the list given to
+ * gnc_split_register_load, plus those of the transaction under the
+ * cursor and of the pending transaction, so that opening a register
+ * on a huge account doesn't build rows for all of its splits. The
+ * window is kept across reloads. Zero, the default, loads everything. */
+void gnc_split_register_set_load_window (SplitRegister *reg, gint num_splits);
+
+/** Return the number of splits loaded from the end of the split list,
+ * zero if all of them are. */
+gint gnc_split_register_get_load_window (SplitRegister *reg);
+
+/** Return TRUE if the last load left out splits before the load window. */
+gboolean gnc_split_register_load_truncated (SplitRegister *reg);
+
 /** Expand the current transaction if it is collapsed. */
 void gnc_split_register_expand_current_trans (SplitRegister *reg,
         gboolean expand);
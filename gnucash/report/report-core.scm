@@ -287,6 +287,17 @@ not found.")))
 
 (define (gnc:report-set-dirty?! report val)
   (gnc:report-set-dirty?-internal! report val)
+  ;; something not captured by the render cache key may have changed,
+  ;; eg. the contents of the report's style sheet, so drop the cached
+  ;; renderings for this report's key. Style sheet edits dirty every
+  ;; report using the sheet, and reports with embedded reports are not
+  ;; cached at all.
+  (when val
+    (for-each
+     (lambda (headers?)
+       (let ((key (gnc:report-render-cache-key report headers?)))
+         (if key (hash-remove! *gnc:_report-render-cache_* key))))
+     '(#t #f)))
   (let* ((template (hash-ref *gnc:_report-templates_*
                              (gnc:report-type report)))
          (cb (gnc:report-template-options-changed-cb template)))
@@ -704,6 +715,41 @@ not found.")))
           (gnc:custom-report-templates-list))))
 
 
+;; Rendered html stays valid as long as the report isn't dirty, the
+;; book hasn't changed (as told by its generation counter) and it's
+;; still the same day, because many report options are relative to
+;; today. The render stamp captures the last two.
+(define (gnc:report-render-stamp)
+  (cons (qof-book-get-generation (gnc-get-current-book))
+        (gnc-time64-get-today-start)))
+
+;; the render stamp of each report's ctext
+(define *gnc:_report-ctext-stamps_* (make-weak-key-hash-table))
+
+;; html rendered at the current render stamp, keyed by report id, type
+;; and options, so a report switched back to earlier options reuses its
+;; earlier rendering.
+(define *gnc:_report-render-cache_* (make-hash-table))
+(define *gnc:_report-render-cache-stamp_* #f)
+
+;; the report id is part of the key because renderers embed it in
+;; option and drill-down links. reports with embedded reports are not
+;; cached: their options don't describe their embedded reports' options.
+(define (gnc:report-render-cache-key report headers?)
+  (and (not (gnc:report-embedded-list (gnc:report-options report)))
+       (string-append
+        (format #f "~a/" (gnc:report-id report))
+        (gnc:report-type report) "/"
+        (gnc:report-custom-template report) "/"
+        (if headers? "headers" "") "/"
+        (gnc:generate-restore-forms (gnc:report-options report) "options"))))
+
+(define (gnc:report-render-cache-ref key stamp)
+  (unless (equal? stamp *gnc:_report-render-cache-stamp_*)
+    (hash-clear! *gnc:_report-render-cache_*)
+    (set! *gnc:_report-render-cache-stamp_* stamp))
+  (and key (hash-ref *gnc:_report-render-cache_* key)))
+
 ;; gets the renderer from the report template;
 ;; gets the stylesheet from the report;
 ;; renders the html doc and caches the resulting string;
@@ -711,22 +757,36 @@ not found.")))
 ;; Now accepts either an html-doc or finished HTML from the renderer -
 ;; the former requires further processing, the latter is just returned.
 (define (gnc:report-render-html report headers?)
+  (define stamp (gnc:report-render-stamp))
+  (define (cache-html! html)
+    (gnc:report-set-ctext! report html) ;; cache the html
+    (hashq-set! *gnc:_report-ctext-stamps_* report stamp)
+    (gnc:report-set-dirty?! report #f)  ;; mark it clean
+    html)
   (if (and (not (gnc:report-dirty? report))
-           (gnc:report-ctext report))
+           (gnc:report-ctext report)
+           (equal? stamp (hashq-ref *gnc:_report-ctext-stamps_* report)))
       (gnc:report-ctext report)
-      (let ((template (hash-ref *gnc:_report-templates_* (gnc:report-type report))))
-        (and template
-             (let* ((renderer (gnc:report-template-renderer template))
-                    (stylesheet (gnc:report-stylesheet report))
-                    (doc (renderer report))
-                    (html (cond
-                           ((string? doc) doc)
-                           (else
-                            (gnc:html-document-set-style-sheet! doc stylesheet)
-                            (gnc:html-document-render doc headers?)))))
-               (gnc:report-set-ctext! report html) ;; cache the html
-               (gnc:report-set-dirty?! report #f)  ;; mark it clean
-               html)))))
+      (let* ((key (gnc:report-render-cache-key report headers?))
+             (cached (gnc:report-render-cache-ref key stamp))
+             (template (hash-ref *gnc:_report-templates_* (gnc:report-type report))))
+        (cond
+         (cached (cache-html! cached))
+         (template
+          (let* ((renderer (gnc:report-template-renderer template))
+                 (stylesheet (gnc:report-stylesheet report))
+                 (doc (renderer report))
+                 (html (cond
+                        ((string? doc) doc)
+                        (else
+                         (gnc:html-document-set-style-sheet! doc stylesheet)
+                         (gnc:html-document-render doc headers?)))))
+            ;; the stamp is taken before rendering, so the output of a
+            ;; renderer that changes the book is never reused.
+            (if (and key html)
+                (hash-set! *gnc:_report-render-cache_* key html))
+            (cache-html! html)))
+         (else #f)))))
 
 ;; looks up the report by id and renders it with gnc:report-render-html
 ;; marks the cursor busy during rendering; returns the html
@@ -749,6 +809,25 @@ not found.")))
     (gnc-unset-busy-cursor '())
     html))
 
+;; Render a saved report, given by its template guid or name, without
+;; any gui.  The report instance only lives for the duration of the
+;; call.  Returns the html, or #f if the report is unknown or failed.
+(define (gnc:report-render-saved template-id)
+  (define (template-guid)
+    (if (gnc:find-report-template template-id)
+        template-id
+        (any (lambda (tmpl)
+               (and (equal? (gnc:report-template-name (cdr tmpl)) template-id)
+                    (car tmpl)))
+             (gnc:custom-report-templates-list))))
+  (let ((guid (template-guid)))
+    (and guid
+         (let* ((id (gnc:make-report guid))
+                (html (gnc:backtrace-if-exception
+                       gnc:report-render-html (gnc-report-find id) #t)))
+           (gnc-report-remove-by-id id)
+           html))))
+
 
 ;; "thunk" should take the report-type and the report template record
 (define (gnc:report-templates-for-each thunk)
@@ -358,12 +358,36 @@
   (define (amount->monetary bal)
     (gnc:make-gnc-monetary (xaccAccountGetCommodity account) (or bal 0)))
   (define balance 0)
-  (map amount->monetary
-       (gnc:account-accumulate-at-dates
-        account dates-list #:split->elt
-        (lambda (s)
-          (if s (set! balance (+ balance (or (split->amount s) 0))))
-          balance))))
+  (if (eq? split->amount xaccSplitGetAmount)
+      (cdar (gnc:accounts-get-balances-at-dates (list account) dates-list))
+      (map amount->monetary
+           (gnc:account-accumulate-at-dates
+            account dates-list #:split->elt
+            (lambda (s)
+              (if s (set! balance (+ balance (or (split->amount s) 0))))
+              balance)))))
+
+;; this function gets the balances of several accounts at the dates
+;; specified in dates-list. it is computed natively, walking each
+;; account's splitlist only once. a balance at a date includes all
+;; splits posted at or before that date; unlike
+;; gnc:account-accumulate-at-dates, which stops after the first split
+;; posted exactly at a date, this includes all splits sharing that
+;; posted time.
+;; in:  accounts
+;;      dates-list (list of time64) - NOTE: IT WILL BE SORTED
+;;      ignore-closing? - #t to leave closing transactions out
+;; out: (list (list acc0 bal0 bal1 ...) (list acc1 bal0 bal1 ...) ...)
+;;      each balance is a gnc-monetary object in the account commodity
+(define* (gnc:accounts-get-balances-at-dates
+          accounts dates-list #:key ignore-closing?)
+  (map
+   (lambda (acc balances)
+     (let ((comm (xaccAccountGetCommodity acc)))
+       (cons acc (map (lambda (bal) (gnc:make-gnc-monetary comm bal)) balances))))
+   accounts
+   (gnc-accounts-get-balances-at-dates
+    accounts (sort dates-list <) ignore-closing?)))
 
 
 ;; this function will scan through account splitlist, building a list
@@ -184,6 +184,7 @@
 (export gnc:report-to-template-update)
 (export gnc:report-render-html)
 (export gnc:report-run)
+(export gnc:report-render-saved)
 (export gnc:report-templates-for-each)
 (export gnc:report-embedded-list)
 (export gnc:report-template-is-custom/template-guid?)
@@ -678,6 +679,7 @@
 (export gnc:account-accumulate-at-dates)
 (export gnc:account-get-balance-at-date)
 (export gnc:account-get-balances-at-dates)
+(export gnc:accounts-get-balances-at-dates)
 (export gnc:account-get-comm-balance-at-date)
 (export gnc:account-get-comm-value-interval)
 (export gnc:account-get-comm-value-at-date)
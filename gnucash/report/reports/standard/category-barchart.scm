@@ -345,23 +345,16 @@ developing over time"))
           ;; whereby each balance is a gnc-monetary
           (define account-balances-alist
             (map
-             (lambda (acc)
-               (let* ((comm (xaccAccountGetCommodity acc))
-                      (split->elt (if reverse-bal?
-                                      (lambda (s)
-                                        (gnc:make-gnc-monetary
-                                         comm (- (xaccSplitGetNoclosingBalance s))))
-                                      (lambda (s)
-                                        (gnc:make-gnc-monetary
-                                         comm (xaccSplitGetNoclosingBalance s))))))
-                 (cons acc
-                       (gnc:account-accumulate-at-dates
-                        acc dates-list
-                        #:split->elt split->elt
-                        #:nosplit->elt (gnc:make-gnc-monetary comm 0)))))
+             (lambda (acc-balances)
+               (if reverse-bal?
+                   (cons (car acc-balances)
+                         (map gnc:monetary-neg (cdr acc-balances)))
+                   acc-balances))
              ;; all selected accounts (of report-specific type), *and*
              ;; their descendants (of any type) need to be scanned.
-             (gnc:accounts-and-all-descendants accounts)))
+             (gnc:accounts-get-balances-at-dates
+              (gnc:accounts-and-all-descendants accounts) dates-list
+              #:ignore-closing? #t)))
 
           ;; Creates the <balance-list> to be used in the function
           ;; below.
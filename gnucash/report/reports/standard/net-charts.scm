@@ -234,18 +234,6 @@
        c report-currency
        (lambda (a b) (exchange-fn a b date))))
 
-    ;; gets an account alist balances
-    ;; output: (list acc bal0 bal1 bal2 ...)
-    (define (account->balancelist account)
-      (let ((comm (xaccAccountGetCommodity account)))
-        (cons account
-              (gnc:account-accumulate-at-dates
-               account dates-list
-               #:split->elt (lambda (s)
-                              (gnc:make-gnc-monetary
-                               comm (xaccSplitGetNoclosingBalance s)))
-               #:nosplit->elt (gnc:make-gnc-monetary comm 0)))))
-
     ;; This calculates the balances for all the 'account-balances' for
     ;; each element of the list 'dates'. Uses the collector->monetary
     ;; conversion function above. Returns a list of gnc-monetary.
@@ -306,7 +294,8 @@
 
     (if
      (not (null? accounts))
-     (let* ((account-balancelist (map account->balancelist accounts))
+     (let* ((account-balancelist (gnc:accounts-get-balances-at-dates
+                                  accounts dates-list #:ignore-closing? #t))
             (dummy (gnc:report-percent-done 60))
 
             (minuend-balances (process-datelist account-balancelist dates-list #t))
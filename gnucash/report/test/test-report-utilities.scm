@@ -655,5 +655,34 @@
 
       (test-equal "1 txn in early slot"
         '(#f 10 10 10)
-        (gnc:account-accumulate-at-dates bank4 dates)))
+        (gnc:account-accumulate-at-dates bank4 dates))
+
+      (test-equal "accounts-get-balances-at-dates"
+        '((("USD" . 0) ("USD" . 10) ("USD" . 20) ("USD" . 40))
+          (("USD" . 20) ("USD" . 20) ("USD" . 30) ("USD" . 30))
+          (("USD" . 0) ("USD" . 0) ("USD" . 0) ("USD" . 10)))
+        (map (lambda (acc-balances) (map monetary->pair (cdr acc-balances)))
+             (gnc:accounts-get-balances-at-dates (list bank1 bank2 bank3) dates)))
+
+      (test-equal "accounts-get-balances-at-dates, ignoring closing"
+        '(("USD" . 0) ("USD" . 10) ("USD" . 20) ("USD" . 30))
+        (map monetary->pair
+             (cdar (gnc:accounts-get-balances-at-dates
+                    (list bank1) dates #:ignore-closing? #t))))
+
+      ;; a balance at a date includes every split posted at that very
+      ;; time, and none posted after it.
+      (let* ((txn (env-transfer env 15 05 1970 income bank4 10))
+             (posted (xaccTransGetDate txn)))
+        (env-transfer env 15 05 1970 income bank4 5)
+        (test-equal "accounts-get-balances-at-dates, splits on the date"
+          '(("USD" . 10) ("USD" . 25))
+          (map monetary->pair
+               (cdar (gnc:accounts-get-balances-at-dates
+                      (list bank4) (list (1- posted) posted)))))
+        (test-equal "account-get-balances-at-dates, splits on the date"
+          '(("USD" . 10) ("USD" . 25))
+          (map monetary->pair
+               (gnc:account-get-balances-at-dates
+                bank4 (list (1- posted) posted))))))
     (teardown)))
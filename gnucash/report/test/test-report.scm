@@ -16,6 +16,7 @@
   (test-report-template-getters)
   (test-make-report)
   (test-report)
+  (test-render-cache)
   (test-end "Testing/Temporary/test-report"))
 
 (define test4-guid "54c2fc051af64a08ba2334c2e9179e24")
@@ -211,3 +212,23 @@
     (test-assert "gnc:report-serialize = string"
       (string?
        (gnc:report-serialize report)))))
+
+(define (test-render-cache)
+  (define test-uuid "render-cache-report-guid")
+  (test-begin "test-render-cache")
+  (gnc:define-report
+   'version 1
+   'name "render cache report"
+   'report-guid test-uuid
+   'options-generator gnc:new-options
+   'renderer (lambda (obj)
+               (format #f "report ~a" (gnc:report-id obj))))
+  (let* ((report1 (gnc-report-find (gnc:make-report test-uuid)))
+         (report2 (gnc-report-find (gnc:make-report test-uuid))))
+    (test-equal "first report renders its own id"
+      (format #f "report ~a" (gnc:report-id report1))
+      (gnc:report-render-html report1 #t))
+    (test-equal "identical options don't share another report's id"
+      (format #f "report ~a" (gnc:report-id report2))
+      (gnc:report-render-html report2 #t)))
+  (test-end "test-render-cache"))
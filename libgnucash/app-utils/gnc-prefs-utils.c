@@ -26,6 +26,7 @@
 #include "gnc-gsettings.h"
 #include "gnc-prefs-utils.h"
 #include "gnc-prefs.h"
+#include "TransLog.h"
 #include "xml/gnc-backend-xml.h"
 
 static QofLogModule log_module = G_LOG_DOMAIN;
@@ -36,6 +37,8 @@ static QofLogModule log_module = G_LOG_DOMAIN;
 #define GNC_PREF_RETAIN_TYPE_DAYS    "retain-type-days"
 #define GNC_PREF_RETAIN_TYPE_FOREVER "retain-type-forever"
 #define GNC_PREF_RETAIN_DAYS         "retain-days"
+#define GNC_PREF_TRANSLOG_RECORDS    "translog-flush-records"
+#define GNC_PREF_TRANSLOG_INTERVAL   "translog-flush-interval"
 
 /***************************************************************
  * Initialization                                              *
@@ -78,6 +81,17 @@ file_compression_changed_cb(gpointer gsettings, gchar *key, gpointer user_data)
     }
 }
 
+static void
+translog_flush_changed_cb(gpointer gsettings, gchar *key, gpointer user_data)
+{
+    if (gnc_prefs_is_set_up())
+    {
+        gint records = gnc_prefs_get_int(GNC_PREFS_GROUP_GENERAL, GNC_PREF_TRANSLOG_RECORDS);
+        gint msec = gnc_prefs_get_int(GNC_PREFS_GROUP_GENERAL, GNC_PREF_TRANSLOG_INTERVAL);
+        xaccLogSetFlushPolicy (MAX (records, 0), MAX (msec, 0));
+    }
+}
+
 
 void gnc_prefs_init (void)
 {
@@ -89,6 +103,7 @@ void gnc_prefs_init (void)
     file_retain_changed_cb (NULL, NULL, NULL);
     file_retain_type_changed_cb (NULL, NULL, NULL);
     file_compression_changed_cb (NULL, NULL, NULL);
+    translog_flush_changed_cb (NULL, NULL, NULL);
 
     /* Check for invalid retain_type (days)/retain_days (0) combo.
      * This can happen either because a user changed the preferences
@@ -122,6 +137,10 @@ void gnc_prefs_init (void)
                            file_retain_type_changed_cb, NULL);
     gnc_prefs_register_cb (GNC_PREFS_GROUP_GENERAL, GNC_PREF_FILE_COMPRESSION,
                            file_compression_changed_cb, NULL);
+    gnc_prefs_register_cb (GNC_PREFS_GROUP_GENERAL, GNC_PREF_TRANSLOG_RECORDS,
+                           translog_flush_changed_cb, NULL);
+    gnc_prefs_register_cb (GNC_PREFS_GROUP_GENERAL, GNC_PREF_TRANSLOG_INTERVAL,
+                           translog_flush_changed_cb, NULL);
 
 }
 
@@ -139,4 +158,8 @@ gnc_prefs_remove_registered (void)
                            file_retain_type_changed_cb, NULL);
     gnc_prefs_remove_cb_by_func (GNC_PREFS_GROUP_GENERAL, GNC_PREF_FILE_COMPRESSION,
                            file_compression_changed_cb, NULL);
+    gnc_prefs_remove_cb_by_func (GNC_PREFS_GROUP_GENERAL, GNC_PREF_TRANSLOG_RECORDS,
+                           translog_flush_changed_cb, NULL);
+    gnc_prefs_remove_cb_by_func (GNC_PREFS_GROUP_GENERAL, GNC_PREF_TRANSLOG_INTERVAL,
+                           translog_flush_changed_cb, NULL);
 }
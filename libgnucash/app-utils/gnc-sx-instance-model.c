@@ -70,6 +70,7 @@ static void gnc_sx_instance_model_init(GTypeInstance *instance, gpointer klass);
 static GncSxInstanceModel* gnc_sx_instance_model_new(void);
 
 static GncSxInstance* gnc_sx_instance_new(GncSxInstances *parent, GncSxInstanceState state, GDate *date, void *temporal_state, gint sequence_num);
+static void gnc_sx_instance_free(GncSxInstance *instance);
 
 static gint _get_vars_helper(Transaction *txn, void *var_hash_data);
 
@@ -411,6 +412,49 @@ gnc_sx_instance_get_variables(GncSxInstance *inst)
     return vars;
 }
 
+static void
+_gnc_sx_instance_range(const SchedXaction *sx, const GDate *range_end,
+                       GDate *creation_end, GDate *remind_end)
+{
+    *creation_end = *range_end;
+    g_date_add_days(creation_end, xaccSchedXactionGetAdvanceCreation(sx));
+    *remind_end = *creation_end;
+    g_date_add_days(remind_end, xaccSchedXactionGetAdvanceReminder(sx));
+}
+
+/* Appends the instances from temporal_state on up to remind_end; those up
+ * to creation_end are to-create, the rest reminders.  Returns the date of
+ * the first instance considered. */
+static GDate
+_gnc_sx_append_instances(GncSxInstances *instances, SXTmpStateData *temporal_state,
+                         const GDate *creation_end, const GDate *remind_end)
+{
+    SchedXaction *sx = instances->sx;
+    GList *new_instances = NULL;
+    GDate first_date, cur_date;
+
+    g_date_clear(&cur_date, 1);
+    cur_date = xaccSchedXactionGetNextInstance(sx, temporal_state);
+    first_date = cur_date;
+    while (g_date_valid(&cur_date) && g_date_compare(&cur_date, remind_end) <= 0)
+    {
+        GncSxInstance *inst;
+        GncSxInstanceState state;
+        int seq_num;
+
+        state = (g_date_compare(&cur_date, creation_end) <= 0
+                 ? SX_INSTANCE_STATE_TO_CREATE : SX_INSTANCE_STATE_REMINDER);
+        seq_num = gnc_sx_get_instance_count(sx, temporal_state);
+        inst = gnc_sx_instance_new(instances, state, &cur_date, temporal_state, seq_num);
+        new_instances = g_list_prepend(new_instances, inst);
+        gnc_sx_incr_temporal_state(sx, temporal_state);
+        cur_date = xaccSchedXactionGetNextInstance(sx, temporal_state);
+    }
+    instances->instance_list = g_list_concat(instances->instance_list,
+                                             g_list_reverse(new_instances));
+    return first_date;
+}
+
 static GncSxInstances*
 _gnc_sx_gen_instances(gpointer *data, gpointer user_data)
 {
@@ -418,19 +462,16 @@ _gnc_sx_gen_instances(gpointer *data, gpointer user_data)
     SchedXaction *sx = (SchedXaction*)data;
     const GDate *range_end = (const GDate*)user_data;
     GDate creation_end, remind_end;
-    GDate cur_date;
     SXTmpStateData *temporal_state = gnc_sx_create_temporal_state(sx);
 
     instances->sx = sx;
 
-    creation_end = *range_end;
-    g_date_add_days(&creation_end, xaccSchedXactionGetAdvanceCreation(sx));
-    remind_end = creation_end;
-    g_date_add_days(&remind_end, xaccSchedXactionGetAdvanceReminder(sx));
+    _gnc_sx_instance_range(sx, range_end, &creation_end, &remind_end);
 
     /* postponed */
     {
         GList *postponed = gnc_sx_get_defer_instances(sx);
+        GList *postponed_instances = NULL;
         for ( ; postponed != NULL; postponed = postponed->next)
         {
             GDate inst_date;
@@ -442,46 +483,73 @@ _gnc_sx_gen_instances(gpointer *data, gpointer user_data)
             seq_num = gnc_sx_get_instance_count(sx, postponed->data);
             inst = gnc_sx_instance_new(instances, SX_INSTANCE_STATE_POSTPONED,
                                        &inst_date, postponed->data, seq_num);
-            instances->instance_list =
-                g_list_append(instances->instance_list, inst);
+            postponed_instances = g_list_prepend(postponed_instances, inst);
             gnc_sx_destroy_temporal_state(temporal_state);
             temporal_state = gnc_sx_clone_temporal_state(postponed->data);
             gnc_sx_incr_temporal_state(sx, temporal_state);
         }
+        instances->instance_list = g_list_reverse(postponed_instances);
     }
 
-    /* to-create */
-    g_date_clear(&cur_date, 1);
-    cur_date = xaccSchedXactionGetNextInstance(sx, temporal_state);
-    instances->next_instance_date = cur_date;
-    while (g_date_valid(&cur_date) && g_date_compare(&cur_date, &creation_end) <= 0)
+    /* to-create and reminders */
+    instances->next_instance_date
+        = _gnc_sx_append_instances(instances, temporal_state,
+                                   &creation_end, &remind_end);
+    gnc_sx_destroy_temporal_state(temporal_state);
+
+    return instances;
+}
+
+/* Brings the instances of one SX in line with a new range end, keeping
+ * the ones still inside it. */
+static void
+_gnc_sx_instances_set_range_end(GncSxInstances *instances, const GDate *range_end)
+{
+    SchedXaction *sx = instances->sx;
+    GDate creation_end, remind_end;
+    GList *iter, *last = NULL;
+    SXTmpStateData *temporal_state;
+
+    _gnc_sx_instance_range(sx, range_end, &creation_end, &remind_end);
+
+    for (iter = instances->instance_list; iter != NULL; iter = iter->next)
     {
-        GncSxInstance *inst;
-        int seq_num;
-        seq_num = gnc_sx_get_instance_count(sx, temporal_state);
-        inst = gnc_sx_instance_new(instances, SX_INSTANCE_STATE_TO_CREATE,
-                                   &cur_date, temporal_state, seq_num);
-        instances->instance_list = g_list_append(instances->instance_list, inst);
-        gnc_sx_incr_temporal_state(sx, temporal_state);
-        cur_date = xaccSchedXactionGetNextInstance(sx, temporal_state);
+        GncSxInstance *inst = (GncSxInstance*)iter->data;
+        GncSxInstanceState state;
+
+        /* postponed instances stay regardless of the range */
+        if (inst->orig_state != SX_INSTANCE_STATE_POSTPONED)
+        {
+            if (g_date_compare(&inst->date, &remind_end) > 0)
+                break;
+            state = (g_date_compare(&inst->date, &creation_end) <= 0
+                     ? SX_INSTANCE_STATE_TO_CREATE : SX_INSTANCE_STATE_REMINDER);
+            if (inst->state == inst->orig_state)
+                inst->state = state;
+            inst->orig_state = state;
+        }
+        last = iter;
     }
 
-    /* reminders */
-    while (g_date_valid(&cur_date) &&
-           g_date_compare(&cur_date, &remind_end) <= 0)
+    if (iter != NULL)
     {
-        GncSxInstance *inst;
-        int seq_num;
-        seq_num = gnc_sx_get_instance_count(sx, temporal_state);
-        inst = gnc_sx_instance_new(instances, SX_INSTANCE_STATE_REMINDER,
-                                   &cur_date, temporal_state, seq_num);
-        instances->instance_list = g_list_append(instances->instance_list,
-                                                 inst);
-        gnc_sx_incr_temporal_state(sx, temporal_state);
-        cur_date = xaccSchedXactionGetNextInstance(sx, temporal_state);
+        gnc_g_list_cut(&instances->instance_list, iter);
+        g_list_free_full(iter, (GDestroyNotify)gnc_sx_instance_free);
+        return;
     }
 
-    return instances;
+    if (last != NULL)
+    {
+        GncSxInstance *inst = (GncSxInstance*)last->data;
+        temporal_state = gnc_sx_clone_temporal_state(inst->temporal_state);
+        gnc_sx_incr_temporal_state(sx, temporal_state);
+    }
+    else
+    {
+        temporal_state = gnc_sx_create_temporal_state(sx);
+    }
+    _gnc_sx_append_instances(instances, temporal_state, &creation_end, &remind_end);
+    gnc_sx_destroy_temporal_state(temporal_state);
 }
 
 GncSxInstanceModel*
@@ -520,15 +588,45 @@ gnc_sx_get_instances(const GDate *range_end, gboolean include_disabled)
             SchedXaction *sx = (SchedXaction*)sx_iter->data;
             if (xaccSchedXactionGetEnabled(sx))
             {
-                enabled_sxes = g_list_append(enabled_sxes, sx);
+                enabled_sxes = g_list_prepend(enabled_sxes, sx);
             }
         }
+        enabled_sxes = g_list_reverse(enabled_sxes);
         instances->sx_instance_list = gnc_g_list_map(enabled_sxes, (GncGMapFunc)_gnc_sx_gen_instances, (gpointer)range_end);
         g_list_free(enabled_sxes);
     }
 
+    {
+        GList *iter;
+        for (iter = instances->sx_instance_list; iter != NULL; iter = iter->next)
+        {
+            GncSxInstances *sx_instances = (GncSxInstances*)iter->data;
+            g_hash_table_insert(instances->sx_instances_by_guid,
+                                guid_copy(xaccSchedXactionGetGUID(sx_instances->sx)),
+                                sx_instances);
+        }
+        for (iter = all_sxes; iter != NULL; iter = iter->next)
+            g_hash_table_add(instances->book_sxes, iter->data);
+    }
+
     return instances;
 }
+
+void
+gnc_sx_instance_model_set_range_end(GncSxInstanceModel *model, const GDate *range_end)
+{
+    GList *iter;
+
+    g_return_if_fail(GNC_IS_SX_INSTANCE_MODEL(model));
+    g_return_if_fail(range_end != NULL && g_date_valid(range_end));
+
+    if (g_date_compare(&model->range_end, range_end) == 0)
+        return;
+
+    model->range_end = *range_end;
+    for (iter = model->sx_instance_list; iter != NULL; iter = iter->next)
+        _gnc_sx_instances_set_range_end((GncSxInstances*)iter->data, range_end);
+}
 static GncSxInstanceModel*
 gnc_sx_instance_model_new(void)
 {
@@ -629,6 +727,10 @@ gnc_sx_instance_model_finalize (GObject *object)
     }
     g_list_free(model->sx_instance_list);
     model->sx_instance_list = NULL;
+    g_hash_table_destroy(model->sx_instances_by_guid);
+    model->sx_instances_by_guid = NULL;
+    g_hash_table_destroy(model->book_sxes);
+    model->book_sxes = NULL;
 
     G_OBJECT_CLASS(parent_class)->finalize(object);
 }
@@ -687,15 +789,28 @@ gnc_sx_instance_model_init(GTypeInstance *instance, gpointer klass)
 
     g_date_clear(&inst->range_end, 1);
     inst->sx_instance_list = NULL;
+    inst->sx_instances_by_guid = g_hash_table_new_full(guid_hash_to_guint,
+                                                       guid_g_hash_table_equal,
+                                                       (GDestroyNotify)guid_free,
+                                                       NULL);
+    inst->book_sxes = g_hash_table_new(g_direct_hash, g_direct_equal);
     inst->qof_event_handler_id = qof_event_register_handler(_gnc_sx_instance_event_handler, inst);
 }
 
-static gint
-_gnc_sx_instance_find_by_sx(GncSxInstances *in_list_instances, SchedXaction *sx_to_find)
+static GncSxInstances*
+_gnc_sx_instance_model_lookup(GncSxInstanceModel *model, SchedXaction *sx)
+{
+    return (GncSxInstances*)g_hash_table_lookup(model->sx_instances_by_guid,
+                                                xaccSchedXactionGetGUID(sx));
+}
+
+static void
+_gnc_sx_instance_model_add(GncSxInstanceModel *model, SchedXaction *sx)
 {
-    if (in_list_instances->sx == sx_to_find)
-        return 0;
-    return -1;
+    GncSxInstances *instances = _gnc_sx_gen_instances((gpointer)sx, (gpointer)&model->range_end);
+    model->sx_instance_list = g_list_append(model->sx_instance_list, instances);
+    g_hash_table_insert(model->sx_instances_by_guid,
+                        guid_copy(xaccSchedXactionGetGUID(sx)), instances);
 }
 
 static void
@@ -718,7 +833,7 @@ _gnc_sx_instance_event_handler(QofInstance *ent, QofEventId event_type, gpointer
 
         sx = GNC_SX(ent);
         // only send `updated` if it's actually in the model
-        sx_is_in_model = (g_list_find_custom(instances->sx_instance_list, sx, (GCompareFunc)_gnc_sx_instance_find_by_sx) != NULL);
+        sx_is_in_model = (_gnc_sx_instance_model_lookup(instances, sx) != NULL);
         if (event_type & QOF_EVENT_MODIFY)
         {
             if (sx_is_in_model)
@@ -736,13 +851,10 @@ _gnc_sx_instance_event_handler(QofInstance *ent, QofEventId event_type, gpointer
             else
             {
                 /* determine if this is a legitimate SX or just a "one-off" / being created */
-                GList *all_sxes = gnc_book_get_schedxactions(gnc_get_current_book())->sx_list;
-                if (g_list_find(all_sxes, sx) && (!instances->include_disabled && xaccSchedXactionGetEnabled(sx)))
+                if (g_hash_table_contains(instances->book_sxes, sx) && (!instances->include_disabled && xaccSchedXactionGetEnabled(sx)))
                 {
                     /* it's moved from disabled to enabled, add the instances */
-                    instances->sx_instance_list
-                        = g_list_append(instances->sx_instance_list,
-                                        _gnc_sx_gen_instances((gpointer)sx, (gpointer) & instances->range_end));
+                    _gnc_sx_instance_model_add(instances, sx);
                     g_signal_emit_by_name(instances, "added", (gpointer)sx);
                 }
             }
@@ -755,9 +867,8 @@ _gnc_sx_instance_event_handler(QofInstance *ent, QofEventId event_type, gpointer
 
         if (event_type & GNC_EVENT_ITEM_REMOVED)
         {
-            GList *instances_link;
-            instances_link = g_list_find_custom(instances->sx_instance_list, sx, (GCompareFunc)_gnc_sx_instance_find_by_sx);
-            if (instances_link != NULL)
+            g_hash_table_remove(instances->book_sxes, sx);
+            if (_gnc_sx_instance_model_lookup(instances, sx) != NULL)
             {
                 g_signal_emit_by_name(instances, "removing", (gpointer)sx);
             }
@@ -768,12 +879,11 @@ _gnc_sx_instance_event_handler(QofInstance *ent, QofEventId event_type, gpointer
         }
         else if (event_type & GNC_EVENT_ITEM_ADDED)
         {
+            g_hash_table_add(instances->book_sxes, sx);
             if (instances->include_disabled || xaccSchedXactionGetEnabled(sx))
             {
                 /* generate instances, add to instance list, emit update. */
-                instances->sx_instance_list
-                    = g_list_append(instances->sx_instance_list,
-                                    _gnc_sx_gen_instances((gpointer)sx, (gpointer) & instances->range_end));
+                _gnc_sx_instance_model_add(instances, sx);
                 g_signal_emit_by_name(instances, "added", (gpointer)sx);
             }
         }
@@ -804,17 +914,15 @@ void
 gnc_sx_instance_model_update_sx_instances(GncSxInstanceModel *model, SchedXaction *sx)
 {
     GncSxInstances *existing, *new_instances;
-    GList *link;
 
-    link = g_list_find_custom(model->sx_instance_list, sx, (GCompareFunc)_gnc_sx_instance_find_by_sx);
-    if (link == NULL)
+    existing = _gnc_sx_instance_model_lookup(model, sx);
+    if (existing == NULL)
     {
         g_critical("couldn't find sx [%p]\n", sx);
         return;
     }
 
     // merge the new instance data into the existing structure, mutating as little as possible.
-    existing = (GncSxInstances*)link->data;
     new_instances = _gnc_sx_gen_instances((gpointer)sx, &model->range_end);
     existing->sx = new_instances->sx;
     existing->next_instance_date = new_instances->next_instance_date;
@@ -859,9 +967,8 @@ gnc_sx_instance_model_update_sx_instances(GncSxInstanceModel *model, SchedXactio
             {
                 GncSxInstance *inst = (GncSxInstance*)new_iter_iter->data;
                 inst->parent = existing;
-                existing->instance_list = g_list_append(existing->instance_list, new_iter_iter->data);
             }
-            g_list_free(new_iter);
+            existing->instance_list = g_list_concat(existing->instance_list, new_iter);
         }
     }
 
@@ -931,17 +1038,18 @@ gnc_sx_instance_model_update_sx_instances(GncSxInstanceModel *model, SchedXactio
 void
 gnc_sx_instance_model_remove_sx_instances(GncSxInstanceModel *model, SchedXaction *sx)
 {
-    GList *instance_link = NULL;
+    GncSxInstances *instances;
 
-    instance_link = g_list_find_custom(model->sx_instance_list, sx, (GCompareFunc)_gnc_sx_instance_find_by_sx);
-    if (instance_link == NULL)
+    instances = _gnc_sx_instance_model_lookup(model, sx);
+    if (instances == NULL)
     {
         g_warning("instance not found!\n");
         return;
     }
 
-    model->sx_instance_list = g_list_remove_link(model->sx_instance_list, instance_link);
-    gnc_sx_instances_free((GncSxInstances*)instance_link->data);
+    g_hash_table_remove(model->sx_instances_by_guid, xaccSchedXactionGetGUID(sx));
+    model->sx_instance_list = g_list_remove(model->sx_instance_list, instances);
+    gnc_sx_instances_free(instances);
 }
 
 static void
@@ -1617,14 +1725,46 @@ GHashTable* gnc_g_hash_new_guid_numeric()
                                   NULL, gnc_numeric_free);
 }
 
+/* The cash flow of one template split for a single occurrence of its
+ * SX, see create_cashflow_helper().  The account is kept by GUID: the
+ * cache is only flushed by events, and an account destroyed while they
+ * are suspended must not leave a dangling pointer behind. */
 typedef struct
 {
-    GHashTable *hash;
+    GncGUID account;
+    gnc_numeric amount;
+} SxCashflowSplit;
+
+/* The template transactions of one SX evaluated once, so that each call
+ * of gnc_sx_all_instantiate_cashflow() only has to count occurrences. */
+typedef struct
+{
+    const SchedXaction *sx;     /* the caller's, set on every lookup */
+    GArray *splits;             /* <SxCashflowSplit> */
+    GList *errors;              /* translated messages from the evaluation */
+} SxCashflowTemplate;
+
+/* The per-book cache of SxCashflowTemplates, flushed whenever an SX,
+ * account, transaction or split of the book changes. */
+typedef struct
+{
+    QofBook *book;
+    GHashTable *templates;      /* <GncGUID*,SxCashflowTemplate*> */
+    gint listener;
+} SxCashflowCache;
+
+#define SX_CASHFLOW_CACHE "gnc-sx-cashflow-cache"
+
+typedef struct
+{
+    GArray *splits;
     GList **creation_errors;
     const SchedXaction *sx;
-    gnc_numeric count;
 } SxCashflowData;
 
+/* Called from the threads of gnc_sx_all_instantiate_cashflow() too, so
+ * the messages use gnc_numeric_to_string() rather than the static
+ * buffer of gnc_num_dbg_to_string(). */
 static void add_to_hash_amount(GHashTable* hash, const GncGUID* guid, const gnc_numeric* amount)
 {
     /* Do we have a number belonging to this GUID in the hash? If yes,
@@ -1632,6 +1772,7 @@ static void add_to_hash_amount(GHashTable* hash, const GncGUID* guid, const gnc_
      * hash. */
     gnc_numeric* elem = g_hash_table_lookup(hash, guid);
     gchar guidstr[GUID_ENCODING_LENGTH+1];
+    gchar *amount_str, *elem_str;
     guid_to_string_buff(guid, guidstr);
     if (!elem)
     {
@@ -1643,18 +1784,22 @@ static void add_to_hash_amount(GHashTable* hash, const GncGUID* guid, const gnc_
     /* Check input arguments for sanity */
     if (gnc_numeric_check(*amount) != GNC_ERROR_OK)
     {
+        amount_str = gnc_numeric_to_string(*amount);
         g_critical("Oops, the given amount [%s] has the error code %d, at guid [%s].",
-                   gnc_num_dbg_to_string(*amount),
+                   amount_str,
                    gnc_numeric_check(*amount),
                    guidstr);
+        g_free(amount_str);
         return;
     }
     if (gnc_numeric_check(*elem) != GNC_ERROR_OK)
     {
+        elem_str = gnc_numeric_to_string(*elem);
         g_critical("Oops, the account's amount [%s] has the error code %d, at guid [%s].",
-                   gnc_num_dbg_to_string(*elem),
+                   elem_str,
                    gnc_numeric_check(*elem),
                    guidstr);
+        g_free(elem_str);
         return;
     }
 
@@ -1669,19 +1814,25 @@ static void add_to_hash_amount(GHashTable* hash, const GncGUID* guid, const gnc_
     /* Check for sanity of the output. */
     if (gnc_numeric_check(*elem) != GNC_ERROR_OK)
     {
-        g_critical("Oops, after addition at guid [%s] the resulting amount [%s] has the error code %d; added amount = [%s].",
+        amount_str = gnc_numeric_to_string(*amount);
+        g_critical("Oops, after addition at guid [%s] the resulting amount has the error code %d; added amount = [%s].",
                    guidstr,
-                   gnc_num_dbg_to_string(*elem),
                    gnc_numeric_check(*elem),
-                   gnc_num_dbg_to_string(*amount));
+                   amount_str);
+        g_free(amount_str);
         return;
     }
 
     /* In case anyone wants to see this in the debug log. */
-    g_debug("Adding to guid [%s] the value [%s]. Value now [%s].",
-            guidstr,
-            gnc_num_dbg_to_string(*amount),
-            gnc_num_dbg_to_string(*elem));
+    if (qof_log_check(G_LOG_DOMAIN, QOF_LOG_DEBUG))
+    {
+        amount_str = gnc_numeric_to_string(*amount);
+        elem_str = gnc_numeric_to_string(*elem);
+        g_debug("Adding to guid [%s] the value [%s]. Value now [%s].",
+                guidstr, amount_str, elem_str);
+        g_free(amount_str);
+        g_free(elem_str);
+    }
 }
 
 static gboolean
@@ -1730,8 +1881,7 @@ create_cashflow_helper(Transaction *template_txn, void *user_data)
         {
             gnc_numeric credit_num = gnc_numeric_zero();
             gnc_numeric debit_num = gnc_numeric_zero();
-            gnc_numeric final_once, final;
-            gint gncn_error;
+            SxCashflowSplit cashflow_split;
 
             /* Credit value */
             _get_sx_formula_value(creation_data->sx, template_split,
@@ -1743,22 +1893,10 @@ create_cashflow_helper(Transaction *template_txn, void *user_data)
 				  &debit_num, creation_data->creation_errors,
 				  "sx-debit-formula", "sx-debit-numeric", NULL);
 
-            /* The resulting cash flow number: debit minus credit,
-             * multiplied with the count factor. */
-            final_once = gnc_numeric_sub_fixed( debit_num, credit_num );
-            /* Multiply with the count factor. */
-            final = gnc_numeric_mul(final_once, creation_data->count,
-                                    gnc_numeric_denom(final_once),
-                                    GNC_HOW_RND_ROUND_HALF_UP);
-
-            gncn_error = gnc_numeric_check(final);
-            if (gncn_error != GNC_ERROR_OK)
-            {
-                gchar* err = N_("Error %d in SX [%s] final gnc_numeric value, using 0 instead.");
-                REPORT_ERROR(creation_data->creation_errors, err,
-                             gncn_error, xaccSchedXactionGetName(creation_data->sx));
-                final = gnc_numeric_zero();
-            }
+            /* The cash flow number of one occurrence: debit minus
+             * credit. */
+            cashflow_split.account = *xaccAccountGetGUID(split_acct);
+            cashflow_split.amount = gnc_numeric_sub_fixed( debit_num, credit_num );
 
             /* Print error message if we would have needed an exchange rate */
             if (! gnc_commodity_equal(split_cmdty, first_cmdty))
@@ -1768,11 +1906,10 @@ create_cashflow_helper(Transaction *template_txn, void *user_data)
                              xaccSchedXactionGetName(creation_data->sx),
                              gnc_commodity_get_mnemonic(split_cmdty),
                              gnc_commodity_get_mnemonic(first_cmdty));
-                final = gnc_numeric_zero();
+                cashflow_split.amount = gnc_numeric_zero();
             }
 
-            /* And add the resulting value to the hash */
-            add_to_hash_amount(creation_data->hash, xaccAccountGetGUID(split_acct), &final);
+            g_array_append_val(creation_data->splits, cashflow_split);
         }
     }
 
@@ -1780,82 +1917,255 @@ create_cashflow_helper(Transaction *template_txn, void *user_data)
 }
 
 static void
-instantiate_cashflow_internal(const SchedXaction* sx,
-                              GHashTable* map,
-                              GList **creation_errors, gint count)
+sx_cashflow_template_free(SxCashflowTemplate *tmpl)
+{
+    g_array_free(tmpl->splits, TRUE);
+    g_list_free_full(tmpl->errors, g_free);
+    g_free(tmpl);
+}
+
+static SxCashflowTemplate*
+sx_cashflow_template_new(const SchedXaction* sx)
 {
+    SxCashflowTemplate *tmpl = g_new0(SxCashflowTemplate, 1);
     SxCashflowData create_cashflow_data;
     Account* sx_template_account = gnc_sx_get_template_transaction_account(sx);
 
+    tmpl->sx = sx;
+    tmpl->splits = g_array_new(FALSE, FALSE, sizeof(SxCashflowSplit));
+
     if (!sx_template_account)
     {
         g_critical("Huh? No template account for the SX %s", xaccSchedXactionGetName(sx));
-        return;
-    }
-
-    if (!xaccSchedXactionGetEnabled(sx))
-    {
-        g_debug("Skipping non-enabled SX [%s]",
-                xaccSchedXactionGetName(sx));
-        return;
+        return tmpl;
     }
 
-    create_cashflow_data.hash = map;
-    create_cashflow_data.creation_errors = creation_errors;
+    create_cashflow_data.splits = tmpl->splits;
+    create_cashflow_data.creation_errors = &tmpl->errors;
     create_cashflow_data.sx = sx;
-    create_cashflow_data.count = gnc_numeric_create(count, 1);
 
     /* The cash flow numbers are in the transactions of the template
      * account, so run this foreach on the transactions. */
     xaccAccountForEachTransaction(sx_template_account,
                                   create_cashflow_helper,
                                   &create_cashflow_data);
+    return tmpl;
+}
+
+static void
+sx_cashflow_cache_event_handler(QofInstance *ent, QofEventId event_type,
+                                gpointer user_data, gpointer evt_data)
+{
+    SxCashflowCache *cache = user_data;
+
+    if (!(GNC_IS_SX(ent) || GNC_IS_SXES(ent) || GNC_IS_ACCOUNT(ent)
+          || GNC_IS_TRANS(ent) || GNC_IS_SPLIT(ent)))
+        return;
+    if (qof_instance_get_book(ent) != cache->book)
+        return;
+
+    g_hash_table_remove_all(cache->templates);
+}
+
+static void
+sx_cashflow_cache_destroy(QofBook *book, gpointer key, gpointer user_data)
+{
+    SxCashflowCache *cache = user_data;
+    qof_event_unregister_handler(cache->listener);
+    g_hash_table_destroy(cache->templates);
+    g_free(cache);
+}
+
+static SxCashflowTemplate*
+sx_cashflow_template_lookup(const SchedXaction *sx)
+{
+    QofBook *book = qof_instance_get_book(sx);
+    SxCashflowCache *cache = qof_book_get_data(book, SX_CASHFLOW_CACHE);
+    const GncGUID *guid = xaccSchedXactionGetGUID(sx);
+    SxCashflowTemplate *tmpl;
+
+    if (!cache)
+    {
+        cache = g_new0(SxCashflowCache, 1);
+        cache->book = book;
+        cache->templates =
+            g_hash_table_new_full(guid_hash_to_guint, guid_g_hash_table_equal,
+                                  (GDestroyNotify)guid_free,
+                                  (GDestroyNotify)sx_cashflow_template_free);
+        cache->listener =
+            qof_event_register_handler(sx_cashflow_cache_event_handler, cache);
+        qof_book_set_data_fin(book, SX_CASHFLOW_CACHE, cache,
+                              sx_cashflow_cache_destroy);
+    }
+
+    tmpl = g_hash_table_lookup(cache->templates, guid);
+    if (!tmpl)
+    {
+        tmpl = sx_cashflow_template_new(sx);
+        g_hash_table_insert(cache->templates, guid_copy(guid), tmpl);
+    }
+    tmpl->sx = sx;
+    return tmpl;
+}
+
+/* Adds count occurrences of the SX's cash flow to the hash. */
+static void
+sx_cashflow_template_apply(const SxCashflowTemplate *tmpl, gint count,
+                           GHashTable *hash, GList **creation_errors)
+{
+    gnc_numeric count_num = gnc_numeric_create(count, 1);
+    GList *iter;
+    guint i;
+
+    if (creation_errors != NULL)
+    {
+        for (iter = tmpl->errors; iter != NULL; iter = iter->next)
+            *creation_errors = g_list_append(*creation_errors,
+                                             g_strdup(iter->data));
+    }
+
+    for (i = 0; i < tmpl->splits->len; i++)
+    {
+        const SxCashflowSplit *cashflow_split =
+            &g_array_index(tmpl->splits, SxCashflowSplit, i);
+        gnc_numeric final;
+        gint gncn_error;
+
+        /* Multiply with the count factor. */
+        final = gnc_numeric_mul(cashflow_split->amount, count_num,
+                                gnc_numeric_denom(cashflow_split->amount),
+                                GNC_HOW_RND_ROUND_HALF_UP);
+
+        gncn_error = gnc_numeric_check(final);
+        if (gncn_error != GNC_ERROR_OK)
+        {
+            gchar* err = N_("Error %d in SX [%s] final gnc_numeric value, using 0 instead.");
+            REPORT_ERROR(creation_errors, err,
+                         gncn_error, xaccSchedXactionGetName(tmpl->sx));
+            final = gnc_numeric_zero();
+        }
+
+        /* And add the resulting value to the hash */
+        add_to_hash_amount(hash, &cashflow_split->account, &final);
+    }
 }
 
+/* Below this many SXs per thread the projection isn't worth a thread. */
+#define SX_CASHFLOW_MIN_PER_THREAD 32
+
+/* A slice of the SXs of one gnc_sx_all_instantiate_cashflow() call,
+ * accumulated into its own hash and error list. */
 typedef struct
 {
-    GHashTable *hash;
-    GList **creation_errors;
+    GPtrArray *templates;
+    guint start, end;
     const GDate *range_start;
     const GDate *range_end;
-} SxAllCashflow;
+    GHashTable *hash;
+    GList *errors;
+    gboolean want_errors;
+} SxCashflowChunk;
 
-static void instantiate_cashflow_cb(gpointer data, gpointer _user_data)
+static gpointer
+sx_cashflow_chunk_run(gpointer data)
 {
-    const SchedXaction* sx = (const SchedXaction*) data;
-    SxAllCashflow* userdata = (SxAllCashflow*) _user_data;
-    gint count;
-
-    g_assert(sx);
-    g_assert(userdata);
+    SxCashflowChunk *chunk = data;
+    GList **creation_errors = chunk->want_errors ? &chunk->errors : NULL;
+    guint i;
 
-    /* How often does this particular SX occur in the date range? */
-    count = gnc_sx_get_num_occur_daterange(sx, userdata->range_start,
-                                           userdata->range_end);
-    if (count > 0)
+    for (i = chunk->start; i < chunk->end; i++)
     {
-        /* If it occurs at least once, calculate ("instantiate") its
-         * cash flow and add it to the result
-         * g_hash<GUID,gnc_numeric> */
-        instantiate_cashflow_internal(sx,
-                                      userdata->hash,
-                                      userdata->creation_errors,
-                                      count);
+        const SxCashflowTemplate *tmpl = g_ptr_array_index(chunk->templates, i);
+        gint count;
+
+        /* How often does this particular SX occur in the date range?
+         * This only reads the SX, so it is safe on any thread. */
+        count = gnc_sx_get_num_occur_daterange(tmpl->sx, chunk->range_start,
+                                               chunk->range_end);
+        if (count > 0)
+            sx_cashflow_template_apply(tmpl, count, chunk->hash, creation_errors);
     }
+    return NULL;
+}
+
+static void
+sx_cashflow_merge_cb(gpointer key, gpointer value, gpointer user_data)
+{
+    add_to_hash_amount((GHashTable*)user_data, (const GncGUID*)key,
+                       (const gnc_numeric*)value);
 }
 
 void gnc_sx_all_instantiate_cashflow(GList *all_sxes,
                                      const GDate *range_start, const GDate *range_end,
                                      GHashTable* map, GList **creation_errors)
 {
-    SxAllCashflow userdata;
-    userdata.hash = map;
-    userdata.creation_errors = creation_errors;
-    userdata.range_start = range_start;
-    userdata.range_end = range_end;
+    GPtrArray *templates = g_ptr_array_new();
+    SxCashflowChunk *chunks;
+    GThread **threads;
+    guint n_chunks, per_chunk, i;
+    GList *iter;
+
+    /* Evaluating the templates uses the expression parser and the
+     * engine, so it stays on this thread. */
+    for (iter = all_sxes; iter != NULL; iter = iter->next)
+    {
+        const SchedXaction *sx = (const SchedXaction*)iter->data;
+
+        if (!xaccSchedXactionGetEnabled(sx))
+        {
+            g_debug("Skipping non-enabled SX [%s]",
+                    xaccSchedXactionGetName(sx));
+            continue;
+        }
+        g_ptr_array_add(templates, sx_cashflow_template_lookup(sx));
+    }
+
+    /* Counting the occurrences is spread over threads, each
+     * accumulating into its own hash; the first slice runs here and
+     * accumulates straight into the result. */
+    n_chunks = MIN(g_get_num_processors(),
+                   templates->len / SX_CASHFLOW_MIN_PER_THREAD);
+    n_chunks = MAX(n_chunks, 1);
+    per_chunk = (templates->len + n_chunks - 1) / n_chunks;
+    chunks = g_new0(SxCashflowChunk, n_chunks);
+    threads = g_new0(GThread*, n_chunks);
+
+    for (i = 0; i < n_chunks; i++)
+    {
+        SxCashflowChunk *chunk = &chunks[i];
+        chunk->templates = templates;
+        chunk->start = MIN(i * per_chunk, templates->len);
+        chunk->end = MIN(chunk->start + per_chunk, templates->len);
+        chunk->range_start = range_start;
+        chunk->range_end = range_end;
+        chunk->hash = i == 0 ? map : gnc_g_hash_new_guid_numeric();
+        chunk->want_errors = creation_errors != NULL;
+        if (i > 0)
+            threads[i] = g_thread_try_new("gnc-sx-cashflow",
+                                          sx_cashflow_chunk_run, chunk, NULL);
+    }
+
+    sx_cashflow_chunk_run(&chunks[0]);
+
+    for (i = 0; i < n_chunks; i++)
+    {
+        SxCashflowChunk *chunk = &chunks[i];
+        if (i > 0)
+        {
+            if (threads[i])
+                g_thread_join(threads[i]);
+            else
+                sx_cashflow_chunk_run(chunk);
+            g_hash_table_foreach(chunk->hash, sx_cashflow_merge_cb, map);
+            g_hash_table_destroy(chunk->hash);
+        }
+        if (creation_errors != NULL)
+            *creation_errors = g_list_concat(*creation_errors, chunk->errors);
+    }
 
-    /* The work is done in the callback for each SX */
-    g_list_foreach(all_sxes, instantiate_cashflow_cb, &userdata);
+    g_free(threads);
+    g_free(chunks);
+    g_ptr_array_free(templates, TRUE);
 }
 
 
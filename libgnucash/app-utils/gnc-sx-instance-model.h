@@ -48,6 +48,8 @@ typedef struct _GncSxInstanceModel
 
     /* private */
     gint qof_event_handler_id;
+    GHashTable *sx_instances_by_guid; /* <GncGUID*,GncSxInstances*> */
+    GHashTable *book_sxes; /* <SchedXaction*>, the book's list, for events */
 
     /* signals */
     /* void (*added)(SchedXaction *sx); // gpointer user_data */
@@ -134,6 +136,14 @@ GncSxInstanceModel* gnc_sx_get_instances(const GDate *range_end, gboolean includ
  * finishing an iteration over an existing GncSxInstances*.
  **/
 void gnc_sx_instance_model_update_sx_instances(GncSxInstanceModel *model, SchedXaction *sx);
+
+/**
+ * Moves the end of the model's range.  Each SX's instances are trimmed
+ * or extended from their last instance rather than regenerated, and the
+ * states of untouched instances follow the new creation and reminder
+ * windows.  No signals are emitted; consumers refresh their views.
+ **/
+void gnc_sx_instance_model_set_range_end(GncSxInstanceModel *model, const GDate *range_end);
 void gnc_sx_instance_model_remove_sx_instances(GncSxInstanceModel *model, SchedXaction *sx);
 
 /** Fix up numerics where they've gotten out-of-sync with the formulas.
@@ -240,6 +250,12 @@ GHashTable* gnc_g_hash_new_guid_numeric(void);
  * given date range. Each SX is counted with multiplicity as it has
  * occurrences in the given date range.
  *
+ * The template transactions of each SX are evaluated once and cached
+ * with the book until an SX, account, transaction or split changes;
+ * changes made while events are suspended are only seen after the next
+ * such event.  The occurrences of many SXs are counted on several
+ * threads.
+ *
  * The creation_errors list, if non-NULL, receive any errors that
  * occurred during creation, similar as in
  * gnc_sx_instance_model_effect_change(). */
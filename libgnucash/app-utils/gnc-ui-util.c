@@ -1472,19 +1472,285 @@ gnc_integral_print_info (void)
     return info;
 }
 
+/* The locale's conventions and the commodity's symbol for one
+ * GNCPrintAmountInfo, see gnc_amount_formatter_new(). */
+struct _GNCAmountFormatter
+{
+    GNCPrintAmountInfo info;
+
+    /* These point into gnc_localeconv(), which is never freed. */
+    const char *decimal_point;
+    const char *thousands_sep;
+    const char *grouping;
+    const char *sign[2];        /* [0] positive, [1] negative */
+    const char *ignore_sign;
+    int decimal_point_len;
+    int thousands_sep_len;
+    char sign_posn[2];
+    char cs_precedes[2];
+    char sep_by_space[2];
+
+    gunichar negative_char;
+    gunichar decimal_point_char;
+    gunichar thousands_sep_char;
+
+    const char *currency_symbol;
+    gchar *symbol_copy;         /* owns currency_symbol if set */
+};
+
+/* The byte length of the first UTF-8 character of str. */
+static int
+first_char_len (const char *str)
+{
+    if (!str || !*str)
+        return 0;
+    return g_utf8_skip[*(const guchar *) str];
+}
+
+static void
+gnc_amount_formatter_init (GNCAmountFormatter *fmt,
+                           const GNCPrintAmountInfo *info)
+{
+    struct lconv *lc = gnc_localeconv ();
+
+    fmt->info = *info;
+
+    if (info->monetary)
+    {
+        fmt->decimal_point = lc->mon_decimal_point;
+        fmt->thousands_sep = lc->mon_thousands_sep;
+        fmt->grouping = lc->mon_grouping;
+    }
+    else
+    {
+        fmt->decimal_point = lc->decimal_point;
+        fmt->thousands_sep = lc->thousands_sep;
+        fmt->grouping = lc->grouping;
+    }
+    fmt->decimal_point_len = first_char_len (fmt->decimal_point);
+    fmt->thousands_sep_len = first_char_len (fmt->thousands_sep);
+
+    fmt->sign[0] = lc->positive_sign;
+    fmt->sign[1] = lc->negative_sign;
+    fmt->sign_posn[0] = lc->p_sign_posn;
+    fmt->sign_posn[1] = lc->n_sign_posn;
+
+    /* An empty positive sign means "+" is accepted when parsing */
+    fmt->ignore_sign = lc->positive_sign;
+    if (!fmt->ignore_sign || !*fmt->ignore_sign)
+        fmt->ignore_sign = "+";
+
+    fmt->negative_char = g_utf8_get_char (lc->negative_sign);
+    fmt->decimal_point_char = g_utf8_get_char (fmt->decimal_point);
+    fmt->thousands_sep_char = g_utf8_get_char (fmt->thousands_sep);
+
+    if (info->use_locale)
+    {
+        fmt->cs_precedes[0] = lc->p_cs_precedes;
+        fmt->sep_by_space[0] = lc->p_sep_by_space;
+        fmt->cs_precedes[1] = lc->n_cs_precedes;
+        fmt->sep_by_space[1] = lc->n_sep_by_space;
+    }
+    else
+    {
+        fmt->cs_precedes[0] = fmt->cs_precedes[1] = TRUE;
+        fmt->sep_by_space[0] = fmt->sep_by_space[1] = TRUE;
+    }
+
+    fmt->currency_symbol = "";
+    fmt->symbol_copy = NULL;
+    if (info->commodity && info->use_symbol)
+    {
+        const char *symbol = gnc_commodity_get_nice_symbol (info->commodity);
+        if (symbol)
+            fmt->currency_symbol = symbol;
+        if (!gnc_commodity_is_iso (info->commodity))
+        {
+            fmt->cs_precedes[0] = fmt->cs_precedes[1] = FALSE;
+            fmt->sep_by_space[0] = fmt->sep_by_space[1] = TRUE;
+        }
+    }
+}
+
+GNCAmountFormatter *
+gnc_amount_formatter_new (GNCPrintAmountInfo info)
+{
+    GNCAmountFormatter *fmt = g_new0 (GNCAmountFormatter, 1);
+
+    gnc_amount_formatter_init (fmt, &info);
+    fmt->symbol_copy = g_strdup (fmt->currency_symbol);
+    fmt->currency_symbol = fmt->symbol_copy;
+
+    return fmt;
+}
+
+void
+gnc_amount_formatter_free (GNCAmountFormatter *fmt)
+{
+    if (!fmt)
+        return;
+
+    g_free (fmt->symbol_copy);
+    g_free (fmt);
+}
+
+/* Writes the decimal digits of the non-negative n and returns their
+ * number. */
+static int
+print_digits (char *buf, gint64 n)
+{
+    char digits[20];
+    int count = 0, i;
+
+    do
+    {
+        digits[count++] = '0' + n % 10;
+        n /= 10;
+    }
+    while (n);
+
+    for (i = 0; i < count; i++)
+        buf[i] = digits[count - 1 - i];
+    buf[count] = '\0';
+
+    return count;
+}
+
+/* Copies num_digits digits to buf, separating the groups of thousands
+ * as the locale's grouping says, and returns the end of the string. */
+static char *
+print_grouped (char *buf, const char *digits, int num_digits,
+               const GNCAmountFormatter *fmt)
+{
+    gboolean sep_after[128] = { FALSE };
+    const char *group = fmt->grouping;
+    int group_count = 0;
+    int r, i;
+
+    if (!fmt->info.use_separators || num_digits > 127)
+    {
+        memcpy (buf, digits, num_digits);
+        buf[num_digits] = '\0';
+        return buf + num_digits;
+    }
+
+    /* Mark where separators go, counting the digits from the right */
+    for (r = 1; r < num_digits && *group != CHAR_MAX; r++)
+    {
+        if (++group_count != *group)
+            continue;
+
+        sep_after[r] = TRUE;
+        group_count = 0;
+
+        /* A null char repeats the last group indefinitely, CHAR_MAX
+         * means no more grouping and anything else is the next size */
+        if (group[1] != '\0')
+            group++;
+    }
+
+    for (i = 0; i < num_digits; i++)
+    {
+        *buf++ = digits[i];
+        r = num_digits - 1 - i;
+        if (r > 0 && sep_after[r])
+        {
+            memcpy (buf, fmt->thousands_sep, fmt->thousands_sep_len);
+            buf += fmt->thousands_sep_len;
+        }
+    }
+    *buf = '\0';
+
+    return buf;
+}
+
+/* Prints a non-negative amount whose denominator is a power of ten
+ * with integer arithmetic only. Returns FALSE for any other amount. */
+static gboolean
+print_decimal_amount (char *buf, gnc_numeric val,
+                      const GNCAmountFormatter *fmt, int *len)
+{
+    const GNCPrintAmountInfo *info = &fmt->info;
+    char whole_buf[24];
+    char *buf_ptr;
+    gint64 whole, frac;
+    int frac_digits = 0, min_dp, max_dp, i;
+
+    if (val.num < 0 || val.denom <= 0)
+        return FALSE;
+
+    while (frac_digits <= maximum_decimals && pow_10[frac_digits] < val.denom)
+        frac_digits++;
+    if (frac_digits > maximum_decimals || pow_10[frac_digits] != val.denom)
+        return FALSE;
+
+    whole = val.num / val.denom;
+    frac = val.num % val.denom;
+
+    min_dp = info->min_decimal_places;
+    max_dp = info->force_fit ? info->max_decimal_places : 99;
+
+    if (frac_digits > max_dp)
+    {
+        gint64 scale = pow_10[frac_digits - max_dp];
+
+        /* rounding? -- can only ROUND if force_fit is also true */
+        if (info->round)
+            frac += scale / 2;
+        frac /= scale;
+        frac_digits = max_dp;
+
+        if (frac >= pow_10[frac_digits])
+        {
+            if (whole == G_MAXINT64)
+                return FALSE;
+            whole++;
+            frac -= pow_10[frac_digits];
+        }
+    }
+
+    /* Strip the trailing zeros, then pad to the minimum again */
+    while (frac_digits > 0 && frac % 10 == 0)
+    {
+        frac /= 10;
+        frac_digits--;
+    }
+
+    buf_ptr = print_grouped (buf, whole_buf, print_digits (whole_buf, whole),
+                             fmt);
+
+    if (frac_digits > 0 || min_dp > 0)
+    {
+        memcpy (buf_ptr, fmt->decimal_point, fmt->decimal_point_len);
+        buf_ptr += fmt->decimal_point_len;
+
+        for (i = frac_digits - 1; i >= 0; i--)
+        {
+            buf_ptr[i] = '0' + frac % 10;
+            frac /= 10;
+        }
+        buf_ptr += frac_digits;
+
+        for (i = frac_digits; i < min_dp; i++)
+            *buf_ptr++ = '0';
+    }
+    *buf_ptr = '\0';
+
+    *len = buf_ptr - buf;
+    return TRUE;
+}
+
 /* Utility function for printing non-negative amounts */
 static int
-PrintAmountInternal(char *buf, gnc_numeric val, const GNCPrintAmountInfo *info)
+PrintAmountInternal(char *buf, gnc_numeric val, const GNCAmountFormatter *fmt)
 {
-    struct lconv *lc = gnc_localeconv();
-    int num_whole_digits;
+    const GNCPrintAmountInfo *info = &fmt->info;
+    int num_whole_digits, len;
     char temp_buf[128];
     gnc_numeric whole, rounding;
     int min_dp, max_dp;
     gboolean value_is_negative, value_is_decimal;
 
-    g_return_val_if_fail (info != NULL, 0);
-
     if (gnc_numeric_check (val))
     {
         PWARN ("Bad numeric: %s.",
@@ -1497,6 +1763,10 @@ PrintAmountInternal(char *buf, gnc_numeric val, const GNCPrintAmountInfo *info)
     value_is_negative = gnc_numeric_negative_p (val);
     val = gnc_numeric_abs (val);
 
+    /* Most amounts already have a decimal denominator. */
+    if (print_decimal_amount (buf, val, fmt, &len))
+        return len;
+
     /* Try to print as decimal. */
     value_is_decimal = gnc_numeric_to_decimal(&val, NULL);
     if (!value_is_decimal && info->force_fit && info->round)
@@ -1550,75 +1820,9 @@ PrintAmountInternal(char *buf, gnc_numeric val, const GNCPrintAmountInfo *info)
         return 0;
     }
 
-    /* print the integer part without separators */
-    sprintf(temp_buf, "%" G_GINT64_FORMAT, whole.num);
-    num_whole_digits = strlen (temp_buf);
-
-    if (!info->use_separators)
-        strcpy (buf, temp_buf);
-    else
-    {
-        int group_count;
-        char *separator;
-        char *temp_ptr;
-        char *buf_ptr;
-        char *group;
-        gchar *rev_buf;
-
-        if (info->monetary)
-        {
-            separator = lc->mon_thousands_sep;
-            group = lc->mon_grouping;
-        }
-        else
-        {
-            separator = lc->thousands_sep;
-            group = lc->grouping;
-        }
-
-        buf_ptr = buf;
-        temp_ptr = &temp_buf[num_whole_digits - 1];
-        group_count = 0;
-
-        while (temp_ptr != temp_buf)
-        {
-            *buf_ptr++ = *temp_ptr--;
-
-            if (*group != CHAR_MAX)
-            {
-                group_count++;
-
-                if (group_count == *group)
-                {
-                    g_utf8_strncpy(buf_ptr, separator, 1);
-                    buf_ptr = g_utf8_find_next_char(buf_ptr, NULL);
-                    group_count = 0;
-
-                    /* Peek ahead at the next group code */
-                    switch (group[1])
-                    {
-                        /* A null char means repeat the last group indefinitely */
-                    case '\0':
-                        break;
-                        /* CHAR_MAX means no more grouping allowed */
-                    case CHAR_MAX:
-                        /* fall through */
-                        /* Anything else means another group size */
-                    default:
-                        group++;
-                        break;
-                    }
-                }
-            }
-        }
-
-        /* We built the string backwards, now reverse */
-        *buf_ptr++ = *temp_ptr;
-        *buf_ptr = '\0';
-        rev_buf = g_utf8_strreverse(buf, -1);
-        strcpy (buf, rev_buf);
-        g_free(rev_buf);
-    } /* endif */
+    /* print the integer part, with separators if wanted */
+    num_whole_digits = print_digits (temp_buf, whole.num);
+    print_grouped (buf, temp_buf, num_whole_digits, fmt);
 
     /* at this point, buf contains the whole part of the number */
 
@@ -1645,15 +1849,11 @@ PrintAmountInternal(char *buf, gnc_numeric val, const GNCPrintAmountInfo *info)
     }
     else
     {
-        char *decimal_point;
         guint8 num_decimal_places = 0;
         char *temp_ptr = temp_buf;
 
-        decimal_point = info->monetary
-                        ? lc->mon_decimal_point
-                        : lc->decimal_point;
-        g_utf8_strncpy(temp_ptr, decimal_point, 1);
-        temp_ptr = g_utf8_find_next_char(temp_ptr, NULL);
+        memcpy (temp_ptr, fmt->decimal_point, fmt->decimal_point_len);
+        temp_ptr += fmt->decimal_point_len;
 
         while (!gnc_numeric_zero_p (val)
                 && (val.denom != 1)
@@ -1700,17 +1900,13 @@ PrintAmountInternal(char *buf, gnc_numeric val, const GNCPrintAmountInfo *info)
     return strlen(buf);
 }
 
-/**
- * @param bufp Should be at least 64 chars.
- **/
 int
-xaccSPrintAmount (char * bufp, gnc_numeric val, GNCPrintAmountInfo info)
+gnc_amount_formatter_print (const GNCAmountFormatter *fmt, gnc_numeric val,
+                            char *bufp)
 {
-    struct lconv *lc;
-
     char *orig_bufp = bufp;
-    const char *currency_symbol;
     const char *sign;
+    int negative;
 
     char cs_precedes;
     char sep_by_space;
@@ -1719,49 +1915,15 @@ xaccSPrintAmount (char * bufp, gnc_numeric val, GNCPrintAmountInfo info)
     gboolean print_sign = TRUE;
     gboolean print_absolute = FALSE;
 
+    g_return_val_if_fail (fmt != NULL, 0);
     if (!bufp)
         return 0;
 
-    lc = gnc_localeconv();
-    if (info.use_locale)
-        if (gnc_numeric_negative_p (val))
-        {
-            cs_precedes  = lc->n_cs_precedes;
-            sep_by_space = lc->n_sep_by_space;
-        }
-        else
-        {
-            cs_precedes  = lc->p_cs_precedes;
-            sep_by_space = lc->p_sep_by_space;
-        }
-    else
-    {
-        cs_precedes = TRUE;
-        sep_by_space = TRUE;
-    }
-
-    if (info.commodity && info.use_symbol)
-    {
-        currency_symbol = gnc_commodity_get_nice_symbol (info.commodity);
-        if (!gnc_commodity_is_iso (info.commodity))
-        {
-            cs_precedes  = FALSE;
-            sep_by_space = TRUE;
-        }
-    }
-    else /* !info.use_symbol || !info.commodity */
-        currency_symbol = "";
-
-    if (gnc_numeric_negative_p (val))
-    {
-        sign = lc->negative_sign;
-        sign_posn = lc->n_sign_posn;
-    }
-    else
-    {
-        sign = lc->positive_sign;
-        sign_posn = lc->p_sign_posn;
-    }
+    negative = gnc_numeric_negative_p (val) ? 1 : 0;
+    cs_precedes  = fmt->cs_precedes[negative];
+    sep_by_space = fmt->sep_by_space[negative];
+    sign = fmt->sign[negative];
+    sign_posn = fmt->sign_posn[negative];
 
     if (gnc_numeric_zero_p (val) || (sign == NULL) || (sign[0] == 0))
         print_sign = FALSE;
@@ -1777,9 +1939,9 @@ xaccSPrintAmount (char * bufp, gnc_numeric val, GNCPrintAmountInfo info)
         if (print_sign && (sign_posn == 3))
             bufp = g_stpcpy(bufp, sign);
 
-        if (info.use_symbol)
+        if (fmt->info.use_symbol)
         {
-            bufp = g_stpcpy(bufp, currency_symbol);
+            bufp = g_stpcpy(bufp, fmt->currency_symbol);
             if (sep_by_space)
                 bufp = g_stpcpy(bufp, " ");
         }
@@ -1799,7 +1961,7 @@ xaccSPrintAmount (char * bufp, gnc_numeric val, GNCPrintAmountInfo info)
     /* Now print the value */
     bufp += PrintAmountInternal(bufp,
                                 print_absolute ? gnc_numeric_abs(val) : val,
-                                &info);
+                                fmt);
 
     /* Now see if we print parentheses */
     if (print_sign && (sign_posn == 0))
@@ -1812,11 +1974,11 @@ xaccSPrintAmount (char * bufp, gnc_numeric val, GNCPrintAmountInfo info)
         if (print_sign && (sign_posn == 3))
             bufp = g_stpcpy(bufp, sign);
 
-        if (info.use_symbol)
+        if (fmt->info.use_symbol)
         {
             if (sep_by_space)
                 bufp = g_stpcpy(bufp, " ");
-            bufp = g_stpcpy(bufp, currency_symbol);
+            bufp = g_stpcpy(bufp, fmt->currency_symbol);
         }
 
         /* See if we print sign now */
@@ -1832,16 +1994,52 @@ xaccSPrintAmount (char * bufp, gnc_numeric val, GNCPrintAmountInfo info)
     return (bufp - orig_bufp);
 }
 
+gboolean
+gnc_amount_formatter_parse (const GNCAmountFormatter *fmt, const char *in_str,
+                            gnc_numeric *result, char **endstr, gboolean skip)
+{
+    g_return_val_if_fail (fmt != NULL, FALSE);
+
+    return xaccParseAmountExtended (in_str, fmt->info.monetary,
+                                    fmt->negative_char,
+                                    fmt->decimal_point_char,
+                                    fmt->thousands_sep_char, fmt->grouping,
+                                    skip ? fmt->ignore_sign : NULL,
+                                    result, endstr);
+}
+
+/**
+ * @param bufp Should be at least 64 chars.
+ **/
+int
+xaccSPrintAmount (char * bufp, gnc_numeric val, GNCPrintAmountInfo info)
+{
+    GNCAmountFormatter fmt;
+
+    if (!bufp)
+        return 0;
+
+    gnc_amount_formatter_init (&fmt, &info);
+    return gnc_amount_formatter_print (&fmt, val, bufp);
+}
+
+/* Each thread gets its own buffer for xaccPrintAmount. */
+static GPrivate print_amount_buf = G_PRIVATE_INIT (g_free);
+
 const char *
 xaccPrintAmount (gnc_numeric val, GNCPrintAmountInfo info)
 {
-    /* hack alert -- this is not thread safe ... */
-    static char buf[1024];
+    char *buf = g_private_get (&print_amount_buf);
+
+    if (!buf)
+    {
+        buf = g_malloc (1024);
+        g_private_set (&print_amount_buf, buf);
+    }
 
     if (!xaccSPrintAmount (buf, val, info))
         buf[0] = '\0';
 
-    /* its OK to return buf, since we declared it static */
     return buf;
 }
 
@@ -311,10 +311,33 @@ GNCPrintAmountInfo gnc_integral_print_info (void);
 
 /* WARNING: Garbage in, garbage out.  You must check the validity of
    the supplied gnc_numeric.  If it's invalid, the returned string
-   could point to ANYTHING. */
+   could point to ANYTHING.  xaccPrintAmount returns a per-thread
+   buffer that is overwritten by the thread's next call. */
 const char * xaccPrintAmount (gnc_numeric val, GNCPrintAmountInfo info);
 int xaccSPrintAmount (char *buf, gnc_numeric val, GNCPrintAmountInfo info);
 
+/* A GNCAmountFormatter keeps a GNCPrintAmountInfo together with the
+ *   locale's separators and signs and the commodity's symbol, looked
+ *   up once when it is created, for printing or parsing many amounts.
+ *   Using it touches no global state, so one formatter may be shared
+ *   by several threads; create it on the main thread, and not before
+ *   the locale is set up.
+ *
+ * gnc_amount_formatter_print prints like xaccSPrintAmount into a
+ *   buffer of at least 64 chars and returns the length printed.
+ *
+ * gnc_amount_formatter_parse parses like xaccParseAmountPosSign with
+ *   the formatter's monetary flag. */
+typedef struct _GNCAmountFormatter GNCAmountFormatter;
+
+GNCAmountFormatter *gnc_amount_formatter_new (GNCPrintAmountInfo info);
+void gnc_amount_formatter_free (GNCAmountFormatter *fmt);
+int gnc_amount_formatter_print (const GNCAmountFormatter *fmt,
+                                gnc_numeric val, char *buf);
+gboolean gnc_amount_formatter_parse (const GNCAmountFormatter *fmt,
+                                     const char *in_str, gnc_numeric *result,
+                                     char **endstr, gboolean skip);
+
 const gchar *printable_value(gdouble val, gint denom);
 gchar *number_to_words(gdouble val, gint64 denom);
 gchar *numeric_to_words(gnc_numeric val);
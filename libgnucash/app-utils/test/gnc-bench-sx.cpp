@@ -0,0 +1,164 @@
+/********************************************************************
+ * gnc-bench-sx.cpp: Benchmark of the SX cash-flow projection.      *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+/**
+ * @file gnc-bench-sx.cpp
+ * @brief Times the cash-flow projection of the balance forecast report.
+ *
+ * A number of daily SXs are projected over ten years.  Like gnc-bench
+ * in the engine, every benchmark prints one JSON object per line on
+ * stdout, e.g.
+ *
+ *   gnc-bench-sx --sxes 300 > run.json
+ *
+ * The program isn't run by ctest; build it with "make gnc-bench-sx".
+ */
+extern "C"
+{
+#include <config.h>
+#include <glib.h>
+#include <stdio.h>
+#include "qof.h"
+#include "Account.h"
+#include "SX-book.h"
+#include "Split.h"
+#include "Transaction.h"
+#include "gnc-date.h"
+#include "gnc-engine.h"
+#include "gnc-session.h"
+#include "gnc-sx-instance-model.h"
+#include "test-engine-stuff.h"
+}
+
+static gint num_sxes = 300;
+static gint iterations = 10;
+
+static GOptionEntry options[] =
+{
+    { "sxes", 's', 0, G_OPTION_ARG_INT, &num_sxes,
+      "Number of daily SXs to project over ten years", "N" },
+    { "iterations", 'i', 0, G_OPTION_ARG_INT, &iterations,
+      "Repetitions of the cached projection", "N" },
+    { NULL }
+};
+
+template <typename Func> static void
+bench (const char *name, gint count, Func func)
+{
+    gint64 start = g_get_monotonic_time ();
+    for (gint i = 0; i < count; i++)
+        func ();
+    printf ("{\"benchmark\": \"%s\", \"seconds\": %.6f, \"iterations\": %d, "
+            "\"sxes\": %d}\n", name,
+            (g_get_monotonic_time () - start) / (double) G_USEC_PER_SEC,
+            count, num_sxes);
+    fflush (stdout);
+}
+
+static void
+add_template_split (SchedXaction *sx, Transaction *txn, Account *acct,
+                    const char *numeric_key)
+{
+    QofBook *book = qof_instance_get_book (QOF_INSTANCE (txn));
+    Split *split = xaccMallocSplit (book);
+    gnc_numeric amount = gnc_numeric_create (3, 2);
+
+    xaccSplitSetParent (split, txn);
+    xaccSplitSetAccount (split, gnc_sx_get_template_transaction_account (sx));
+    qof_begin_edit (QOF_INSTANCE (split));
+    qof_instance_set (QOF_INSTANCE (split),
+                      "sx-account", xaccAccountGetGUID (acct),
+                      numeric_key, &amount,
+                      NULL);
+    qof_commit_edit (QOF_INSTANCE (split));
+}
+
+/* The SX helpers of test-engine-stuff work on the current session, so
+ * the SXs and their accounts live in its book. */
+static void
+bench_sx_cashflow (void)
+{
+    QofBook *book = qof_session_get_book (gnc_get_current_session ());
+    gnc_commodity *currency =
+        gnc_commodity_table_lookup (gnc_commodity_table_get_table (book),
+                                    GNC_COMMODITY_NS_CURRENCY, "USD");
+    Account *income = xaccMallocAccount (book);
+    Account *expense = xaccMallocAccount (book);
+    GList *sxes = NULL;
+    GDate start, end;
+
+    g_date_clear (&start, 1);
+    gnc_gdate_set_today (&start);
+    end = start;
+    g_date_add_years (&end, 10);
+
+    for (gint i = 0; i < num_sxes; i++)
+    {
+        SchedXaction *sx = add_daily_sx ("bench", &start, NULL, NULL);
+        Transaction *txn = xaccMallocTransaction (book);
+
+        xaccTransBeginEdit (txn);
+        xaccTransSetCurrency (txn, currency);
+        add_template_split (sx, txn, income, "sx-credit-numeric");
+        add_template_split (sx, txn, expense, "sx-debit-numeric");
+        xaccTransCommitEdit (txn);
+        sxes = g_list_prepend (sxes, sx);
+    }
+
+    auto project = [sxes, &start, &end]() {
+        GHashTable *map = gnc_g_hash_new_guid_numeric ();
+        gnc_sx_all_instantiate_cashflow (sxes, &start, &end, map, NULL);
+        g_hash_table_destroy (map);
+    };
+    /* The first projection evaluates the templates, later ones reuse them */
+    bench ("sx-cashflow", 1, project);
+    bench ("sx-cashflow-cached", iterations, project);
+
+    for (GList *node = sxes; node; node = node->next)
+        remove_sx (static_cast<SchedXaction*>(node->data));
+    g_list_free (sxes);
+}
+
+int
+main (int argc, char **argv)
+{
+    GOptionContext *context;
+    GError *error = NULL;
+
+    context = g_option_context_new ("- time the SX cash-flow projection");
+    g_option_context_add_main_entries (context, options, NULL);
+    if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+        g_printerr ("%s\n", error->message);
+        g_error_free (error);
+        return 1;
+    }
+    g_option_context_free (context);
+
+    g_setenv ("GNC_UNINSTALLED", "1", TRUE);
+    qof_init ();
+    gnc_engine_init (0, NULL);
+
+    bench_sx_cashflow ();
+
+    gnc_clear_current_session ();
+    qof_close ();
+    return 0;
+}
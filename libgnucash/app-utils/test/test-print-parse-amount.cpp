@@ -23,6 +23,7 @@ extern "C"
 #include <config.h>
 #include <glib.h>
 #include <stdlib.h>
+#include <string.h>
 #include <glib/gprintf.h>
 
 #include "gnc-ui-util.h"
@@ -54,6 +55,95 @@ test_num_print_info (gnc_numeric n, GNCPrintAmountInfo print_info, int line)
                   "start: %s, string %s, finish: %s (line %d)",
                   gnc_numeric_to_string (n), s,
                   gnc_numeric_to_string (n_parsed), line);
+
+    {
+        GNCAmountFormatter *fmt = gnc_amount_formatter_new (print_info);
+        char buf[1024];
+
+        gnc_amount_formatter_print (fmt, n, buf);
+        do_test_args (g_strcmp0 (s, buf) == 0, "formatter differs",
+                      __FILE__, __LINE__, "printed %s, formatter %s (line %d)",
+                      s, buf, line);
+
+        n_parsed = gnc_numeric_zero();
+        ok = gnc_amount_formatter_parse (fmt, buf, &n_parsed, NULL, FALSE)
+             && gnc_numeric_equal (n, n_parsed);
+        do_test_args (ok, "formatter parse", __FILE__, __LINE__,
+                      "string %s, finish: %s (line %d)", buf,
+                      gnc_numeric_to_string (n_parsed), line);
+        gnc_amount_formatter_free (fmt);
+    }
+}
+
+#define NUM_THREADS 4
+#define NUM_AMOUNTS 1000
+
+typedef struct
+{
+    const GNCAmountFormatter *fmt;
+    const gnc_numeric *amounts;
+    char (*expected)[64];
+    gboolean ok;
+} FormatThreadData;
+
+static gpointer
+format_thread (gpointer user_data)
+{
+    auto data = static_cast<FormatThreadData*>(user_data);
+    char buf[64];
+    int i;
+
+    data->ok = TRUE;
+    for (i = 0; i < NUM_AMOUNTS; i++)
+    {
+        gnc_amount_formatter_print (data->fmt, data->amounts[i], buf);
+        if (strcmp (buf, data->expected[i]) != 0)
+            data->ok = FALSE;
+    }
+    return NULL;
+}
+
+static void
+test_formatter_threads (void)
+{
+    GNCPrintAmountInfo info;
+    GNCAmountFormatter *fmt;
+    gnc_numeric amounts[NUM_AMOUNTS];
+    char expected[NUM_AMOUNTS][64];
+    FormatThreadData data[NUM_THREADS];
+    GThread *threads[NUM_THREADS];
+    int i;
+
+    info.commodity = NULL;
+    info.max_decimal_places = 2;
+    info.min_decimal_places = 2;
+    info.use_separators = 1;
+    info.use_symbol = 0;
+    info.use_locale = 1;
+    info.monetary = 1;
+    info.force_fit = 0;
+    info.round = 0;
+    fmt = gnc_amount_formatter_new (info);
+    for (i = 0; i < NUM_AMOUNTS; i++)
+    {
+        amounts[i] = gnc_numeric_create ((i * 7919LL - 3000000) * 1013, 100);
+        xaccSPrintAmount (expected[i], amounts[i], info);
+    }
+
+    for (i = 0; i < NUM_THREADS; i++)
+    {
+        data[i].fmt = fmt;
+        data[i].amounts = amounts;
+        data[i].expected = expected;
+        threads[i] = g_thread_new ("format", format_thread, &data[i]);
+    }
+    for (i = 0; i < NUM_THREADS; i++)
+    {
+        g_thread_join (threads[i]);
+        do_test (data[i].ok, "formatter output in a thread");
+    }
+
+    gnc_amount_formatter_free (fmt);
 }
 
 static void
@@ -163,6 +253,7 @@ int
 main (int argc, char **argv)
 {
     run_tests ();
+    test_formatter_threads ();
     print_test_results ();
     exit (get_rv ());
 }
@@ -23,7 +23,10 @@ extern "C"
 #include <config.h>
 #include <stdlib.h>
 #include <glib.h>
+#include "Account.h"
 #include "SX-book.h"
+#include "Split.h"
+#include "Transaction.h"
 #include "gnc-date.h"
 #include "gnc-sx-instance-model.h"
 #include "gnc-ui-util.h"
@@ -213,6 +216,144 @@ test_state_changes()
     remove_sx(foo);
 }
 
+static void
+test_range_end()
+{
+    SchedXaction *foo;
+    GDate *start, *end;
+    GncSxInstanceModel *model, *fresh;
+    GncSxInstances *insts, *fresh_insts;
+    GList *iter, *fresh_iter;
+
+    start = g_date_new();
+    gnc_gdate_set_today (start);
+    end = g_date_new();
+    gnc_gdate_set_today (end);
+    g_date_add_days(end, 3);
+
+    foo = add_daily_sx("foo", start, NULL, NULL);
+    model = gnc_sx_get_instances(end, TRUE);
+    insts = (GncSxInstances*)model->sx_instance_list->data;
+    do_test(g_list_length(insts->instance_list) == 4, "4 instances");
+
+    g_date_add_days(end, 7);
+    gnc_sx_instance_model_set_range_end(model, end);
+    do_test(g_list_length(insts->instance_list) == 11, "extended to 11 instances");
+
+    fresh = gnc_sx_get_instances(end, TRUE);
+    fresh_insts = (GncSxInstances*)fresh->sx_instance_list->data;
+    for (iter = insts->instance_list, fresh_iter = fresh_insts->instance_list;
+         iter != NULL && fresh_iter != NULL;
+         iter = iter->next, fresh_iter = fresh_iter->next)
+    {
+        GncSxInstance *inst = (GncSxInstance*)iter->data;
+        GncSxInstance *fresh_inst = (GncSxInstance*)fresh_iter->data;
+        do_test(g_date_compare(&inst->date, &fresh_inst->date) == 0, "same date as regenerated");
+        do_test(inst->state == fresh_inst->state, "same state as regenerated");
+    }
+    do_test(iter == NULL && fresh_iter == NULL, "same length as regenerated");
+    g_object_unref(fresh);
+
+    g_date_subtract_days(end, 8);
+    gnc_sx_instance_model_set_range_end(model, end);
+    do_test(g_list_length(insts->instance_list) == 3, "trimmed to 3 instances");
+
+    g_object_unref(model);
+    g_date_free(start);
+    g_date_free(end);
+    remove_sx(foo);
+}
+
+static void
+add_template_split(SchedXaction *sx, Transaction *txn, Account *acct,
+                   const char *numeric_key, gnc_numeric amount)
+{
+    QofBook *book = qof_session_get_book(gnc_get_current_session());
+    Split *split = xaccMallocSplit(book);
+
+    xaccSplitSetParent(split, txn);
+    xaccSplitSetAccount(split, gnc_sx_get_template_transaction_account(sx));
+    qof_begin_edit(QOF_INSTANCE(split));
+    qof_instance_set(QOF_INSTANCE(split),
+                     "sx-account", xaccAccountGetGUID(acct),
+                     numeric_key, &amount,
+                     NULL);
+    qof_commit_edit(QOF_INSTANCE(split));
+}
+
+/* Enough SXs for the occurrences to be counted on two threads. */
+#define CASHFLOW_SXES 64
+
+static void
+assert_cashflow(GList *sx_list, const GDate *start, const GDate *end,
+                Account *acct, gnc_numeric expected, const char *msg)
+{
+    GHashTable *map = gnc_g_hash_new_guid_numeric();
+    GList *errors = NULL;
+    gnc_numeric *value;
+
+    gnc_sx_all_instantiate_cashflow(sx_list, start, end, map, &errors);
+    do_test(errors == NULL, "no cashflow errors");
+    value = (gnc_numeric*)g_hash_table_lookup(map, xaccAccountGetGUID(acct));
+    do_test(value != NULL && gnc_numeric_equal(*value, expected), msg);
+    g_hash_table_destroy(map);
+}
+
+static void
+test_cashflow()
+{
+    QofBook *book = qof_session_get_book(gnc_get_current_session());
+    Account *income = xaccMallocAccount(book);
+    Account *expense = xaccMallocAccount(book);
+    SchedXaction *sxes[CASHFLOW_SXES];
+    GList *sx_list = NULL;
+    GDate start, end;
+    gint total;
+    int i;
+
+    g_date_clear(&start, 1);
+    gnc_gdate_set_today (&start);
+    end = start;
+    g_date_add_days(&end, 30);
+
+    for (i = 0; i < CASHFLOW_SXES; i++)
+    {
+        Transaction *txn = xaccMallocTransaction(book);
+        sxes[i] = add_daily_sx("cashflow", &start, NULL, NULL);
+        xaccTransBeginEdit(txn);
+        xaccTransSetCurrency(txn, gnc_default_currency());
+        add_template_split(sxes[i], txn, income, "sx-credit-numeric",
+                           gnc_numeric_create(3, 2));
+        add_template_split(sxes[i], txn, expense, "sx-debit-numeric",
+                           gnc_numeric_create(3, 2));
+        xaccTransCommitEdit(txn);
+        sx_list = g_list_prepend(sx_list, sxes[i]);
+    }
+    total = gnc_sx_get_num_occur_daterange(sxes[0], &start, &end) * CASHFLOW_SXES;
+
+    assert_cashflow(sx_list, &start, &end, expense,
+                    gnc_numeric_create(3 * total, 2), "expense cashflow");
+    assert_cashflow(sx_list, &start, &end, income,
+                    gnc_numeric_create(-3 * total, 2), "income cashflow");
+    /* The second run uses the cached templates */
+    assert_cashflow(sx_list, &start, &end, expense,
+                    gnc_numeric_create(3 * total, 2), "cached expense cashflow");
+
+    /* The cache holds the accounts by GUID, so a projection after one of
+     * them was destroyed unnoticed doesn't touch freed memory. */
+    qof_event_suspend();
+    xaccAccountBeginEdit(expense);
+    xaccAccountDestroy(expense);
+    qof_event_resume();
+    assert_cashflow(sx_list, &start, &end, income,
+                    gnc_numeric_create(-3 * total, 2),
+                    "cashflow after a suspended account destroy");
+
+    g_list_free(sx_list);
+    for (i = 0; i < CASHFLOW_SXES; i++)
+        remove_sx(sxes[i]);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -228,6 +369,8 @@ main(int argc, char **argv)
     }
     test_basic();
     test_state_changes();
+    test_range_end();
+    test_cashflow();
 
     print_test_results();
     exit(get_rv());
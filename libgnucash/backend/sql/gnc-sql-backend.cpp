@@ -535,6 +535,37 @@ GncSqlBackend::rollback(QofInstance* inst)
     //LEAVE ("");
 }
 
+void
+GncSqlBackend::begin_batch(QofBook* book)
+{
+    if (m_conn == nullptr || m_in_batch || m_loading ||
+        qof_book_is_readonly(m_book))
+        return;
+
+    ENTER (" ");
+    /* The commits inside the batch become savepoints of this transaction. */
+    m_in_batch = m_conn->begin_transaction ();
+    if (!m_in_batch)
+        PERR ("begin_transaction failed\n");
+    LEAVE ("");
+}
+
+void
+GncSqlBackend::commit_batch(QofBook* book)
+{
+    if (!m_in_batch)
+        return;
+
+    ENTER (" ");
+    m_in_batch = false;
+    if (!m_conn->commit_transaction ())
+    {
+        PERR ("commit_transaction failed\n");
+        set_error (ERR_BACKEND_SERVER_ERR);
+    }
+    LEAVE ("");
+}
+
 void
 GncSqlBackend::commodity_for_postload_processing(gnc_commodity* commodity)
 {
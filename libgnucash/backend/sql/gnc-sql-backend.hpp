@@ -97,6 +97,19 @@ public:
      * @param inst Object being edited
      */
     void rollback(QofInstance*) override;
+    /**
+     * A batch of objects is about to be committed; wrap their commits in a
+     * single database transaction.
+     *
+     * @param book The book being edited
+     */
+    void begin_batch(QofBook*) override;
+    /**
+     * The batch is complete, commit the database transaction.
+     *
+     * @param book The book being edited
+     */
+    void commit_batch(QofBook*) override;
     /** Connect the backend to a GncSqlConnection.
      * Sets up version info. Calling with nullptr clears the connection and
      * destroys the version info.
@@ -246,6 +259,7 @@ protected:
     bool m_loading;        /**< We are performing an initial load */
     bool m_in_query;       /**< We are processing a query */
     bool m_is_pristine_db; /**< Are we saving to a new pristine db? */
+    bool m_in_batch = false; /**< Commits are grouped by begin_batch */
     const char* m_time_format = nullptr; /**< Server-specific date-time string format */
     VersionVec m_versions;    /**< Version number for each table */
 private:
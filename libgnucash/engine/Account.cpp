@@ -43,12 +43,21 @@ extern "C" {
 #include "gnc-glib-utils.h"
 #include "gnc-lot.h"
 #include "gnc-pricedb.h"
+extern "C" {
+#include "gnc-pricedb-p.h"
+}
 #include "qofinstance-p.h"
 #include "gnc-features.h"
 #include "guid.hpp"
 
 #include <numeric>
 #include <map>
+#include <mutex>
+#include <unordered_map>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <tuple>
 
 static QofLogModule log_module = GNC_MOD_ACCOUNT;
 
@@ -69,6 +78,10 @@ static const std::string AB_BANK_CODE("bank-code");
 static const std::string AB_TRANS_RETRIEVAL("trans-retrieval");
 
 static gnc_numeric GetBalanceAsOfDate (Account *acc, time64 date, gboolean ignclosing);
+static void imap_bayes_model_invalidate (Account *acc);
+static void subtree_balances_invalidate (const Account *acc);
+static void subtree_balances_forget (const Account *acc);
+static void split_balance_index_forget (const Account *acc);
 
 using FinalProbabilityVec=std::vector<std::pair<std::string, int32_t>>;
 using ProbabilityVec=std::vector<std::pair<std::string, struct AccountProbability>>;
@@ -1293,6 +1306,9 @@ xaccFreeAccount (Account *acc)
 
     priv = GET_PRIVATE(acc);
     qof_event_gen (&acc->inst, QOF_EVENT_DESTROY, NULL);
+    imap_bayes_model_invalidate (acc);
+    subtree_balances_forget (acc);
+    split_balance_index_forget (acc);
 
     if (priv->children)
     {
@@ -1424,6 +1440,9 @@ xaccAccountCommitEdit (Account *acc)
     g_return_if_fail(acc);
     if (!qof_commit_edit(&acc->inst)) return;
 
+    /* Any kvp change, the import map included, is final now */
+    imap_bayes_model_invalidate (acc);
+
     /* If marked for deletion, get rid of subaccounts first,
      * and then the splits ... */
     priv = GET_PRIVATE(acc);
@@ -2155,6 +2174,142 @@ xaccAccountMoveAllSplits (Account *accfrom, Account *accto)
 }
 
 
+/* The splits of each account in ledger order, with the lowest running
+ * balance from every split to the end of the ledger.  The first query
+ * for the present or projected minimum balance builds it, so that later
+ * ones bisect on the posted date instead of walking back over all future
+ * splits; xaccAccountRecomputeBalance drops it again.  It costs a Split
+ * pointer and a gnc_numeric, about 24 bytes, per split of the accounts
+ * that were queried since their balances last changed.  The indexes are
+ * kept per book, in the book's data, and go away with the book.  The
+ * scrubs read accounts from several threads, so they are guarded by a
+ * mutex. */
+struct SplitBalanceIndex
+{
+    std::vector<Split*> splits;
+    std::vector<gnc_numeric> suffix_minimum;
+    bool date_ordered;
+};
+
+struct SplitBalanceIndexes
+{
+    std::mutex mutex;
+    std::unordered_map<const Account*, SplitBalanceIndex> indexes;
+};
+
+#define SPLIT_BALANCE_INDEXES "gnc-split-balance-indexes"
+
+template <typename Cache> static void
+account_book_cache_free (QofBook *book, gpointer key, gpointer user_data)
+{
+    delete static_cast<Cache*>(user_data);
+    qof_book_set_data (book, static_cast<const char*>(key), nullptr);
+}
+
+/* Returns the cache stored under key in the account's book, creating it
+ * first if asked to.  Several threads may ask at once, so creating it
+ * is serialized. */
+template <typename Cache> static Cache *
+account_book_cache_lookup (const Account *acc, const char *key, bool create)
+{
+    static std::mutex create_mutex;
+    auto book = gnc_account_get_book (acc);
+    if (!book || qof_book_shutting_down (book))
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock (create_mutex);
+    auto cache = static_cast<Cache*>(qof_book_get_data (book, key));
+    if (!cache && create)
+    {
+        cache = new Cache;
+        qof_book_set_data_fin (book, key, cache,
+                               account_book_cache_free<Cache>);
+    }
+    return cache;
+}
+
+static void
+split_balance_index_forget (const Account *acc)
+{
+    auto cache = account_book_cache_lookup<SplitBalanceIndexes> (
+                     acc, SPLIT_BALANCE_INDEXES, false);
+    if (!cache)
+        return;
+    std::lock_guard<std::mutex> lock (cache->mutex);
+    cache->indexes.erase (acc);
+}
+
+static void
+split_balance_index_build (SplitBalanceIndex& index, GList *splits)
+{
+    time64 last_date = G_MININT64;
+
+    index.splits.clear ();
+    index.date_ordered = true;
+    for (auto node = splits; node; node = node->next)
+    {
+        auto split = static_cast<Split*>(node->data);
+        auto date = xaccTransGetDate (split->parent);
+        if (date < last_date)
+            index.date_ordered = false;
+        last_date = date;
+        index.splits.push_back (split);
+    }
+
+    /* Keep the later of equal balances, like the walk back did. */
+    auto count = index.splits.size ();
+    index.suffix_minimum.resize (count);
+    for (auto ind = count; ind-- > 0;)
+    {
+        auto balance = index.splits[ind]->balance;
+        if (ind + 1 < count &&
+            gnc_numeric_compare (balance, index.suffix_minimum[ind + 1]) >= 0)
+            balance = index.suffix_minimum[ind + 1];
+        index.suffix_minimum[ind] = balance;
+    }
+}
+
+/* The number of splits posted no later than date. */
+static size_t
+split_balance_index_count_until (const SplitBalanceIndex& index, time64 date)
+{
+    auto end = std::upper_bound (index.splits.begin (), index.splits.end (),
+                                 date, [](time64 date, const Split *split)
+                                 {
+                                     return date < xaccTransGetDate (split->parent);
+                                 });
+    return end - index.splits.begin ();
+}
+
+/* Run func on the account's index, building it first if need be, and
+ * return whether it could.  It can't while the balances are stale or if
+ * the splits aren't in date order; the callers then walk the split
+ * list. */
+template <typename F> static bool
+split_balance_index_with (const Account *acc, F&& func)
+{
+    auto priv = GET_PRIVATE(acc);
+    if (priv->balance_dirty)
+        return false;
+
+    auto cache = account_book_cache_lookup<SplitBalanceIndexes> (
+                     acc, SPLIT_BALANCE_INDEXES, true);
+    if (!cache)
+        return false;
+
+    std::lock_guard<std::mutex> lock (cache->mutex);
+    auto iter = cache->indexes.find (acc);
+    if (iter == cache->indexes.end ())
+    {
+        iter = cache->indexes.emplace (acc, SplitBalanceIndex{}).first;
+        split_balance_index_build (iter->second, priv->splits);
+    }
+    if (!iter->second.date_ordered)
+        return false;
+    func (iter->second);
+    return true;
+}
+
 /********************************************************************\
  * xaccAccountRecomputeBalance                                      *
  *   recomputes the partial balances and the current balance for    *
@@ -2201,6 +2356,7 @@ xaccAccountRecomputeBalance (Account * acc)
     if (qof_instance_get_destroying(acc)) return;
     if (qof_book_shutting_down(qof_instance_get_book(acc))) return;
 
+    QOF_SCOPED_TIMER ("engine.recompute-balance");
     balance            = priv->starting_balance;
     noclosing_balance  = priv->starting_noclosing_balance;
     cleared_balance    = priv->starting_cleared_balance;
@@ -2242,6 +2398,8 @@ xaccAccountRecomputeBalance (Account * acc)
     priv->cleared_balance = cleared_balance;
     priv->reconciled_balance = reconciled_balance;
     priv->balance_dirty = FALSE;
+    split_balance_index_forget (acc);
+    subtree_balances_invalidate (acc);
 }
 
 /********************************************************************\
@@ -2527,6 +2685,7 @@ xaccAccountSetCommodity (Account * acc, gnc_commodity * com)
 
     priv->sort_dirty = TRUE;  /* Not needed. */
     priv->balance_dirty = TRUE;
+    subtree_balances_invalidate (acc);
     mark_account (acc);
 
     xaccAccountCommitEdit(acc);
@@ -2670,6 +2829,10 @@ gnc_account_append_child (Account *new_parent, Account *child)
              */
             PWARN ("reparenting accounts across books is not correctly supported\n");
 
+            /* The balance caches belong to the old book */
+            subtree_balances_forget (child);
+            split_balance_index_forget (child);
+
             qof_event_gen (&child->inst, QOF_EVENT_DESTROY, NULL);
             col = qof_book_get_collection (qof_instance_get_book(new_parent),
                                            GNC_ID_ACCOUNT);
@@ -2679,6 +2842,7 @@ gnc_account_append_child (Account *new_parent, Account *child)
     }
     cpriv->parent = new_parent;
     ppriv->children = g_list_append(ppriv->children, child);
+    subtree_balances_invalidate (new_parent);
     qof_instance_set_dirty(&new_parent->inst);
     qof_instance_set_dirty(&child->inst);
 
@@ -2719,6 +2883,7 @@ gnc_account_remove_child (Account *parent, Account *child)
     ed.idx = g_list_index(ppriv->children, child);
 
     ppriv->children = g_list_remove(ppriv->children, child);
+    subtree_balances_invalidate (parent);
 
     /* Now send the event. */
     qof_event_gen(&child->inst, QOF_EVENT_REMOVE, &ed);
@@ -3375,6 +3540,16 @@ xaccAccountGetProjectedMinimumBalance (const Account *acc)
 
     priv = GET_PRIVATE(acc);
     today = gnc_time64_get_today_end();
+    auto from_index = [&lowest, today](const SplitBalanceIndex& index)
+    {
+        if (index.splits.empty ())
+            return;
+        auto count = split_balance_index_count_until (index, today);
+        lowest = index.suffix_minimum[count ? count - 1 : 0];
+    };
+    if (split_balance_index_with (acc, from_index))
+        return lowest;
+
     for (node = g_list_last(priv->splits); node; node = node->prev)
     {
         Split *split = static_cast<Split*>(node->data);
@@ -3492,6 +3667,16 @@ xaccAccountGetPresentBalance (const Account *acc)
 
     priv = GET_PRIVATE(acc);
     today = gnc_time64_get_today_end();
+    gnc_numeric present = gnc_numeric_zero ();
+    auto from_index = [&present, today](const SplitBalanceIndex& index)
+    {
+        auto count = split_balance_index_count_until (index, today);
+        if (count)
+            present = xaccSplitGetBalance (index.splits[count - 1]);
+    };
+    if (split_balance_index_with (acc, from_index))
+        return present;
+
     for (node = g_list_last(priv->splits); node; node = node->prev)
     {
         Split *split = static_cast<Split*>(node->data);
@@ -3604,60 +3789,162 @@ xaccAccountGetXxxBalanceAsOfDateInCurrency(Account *acc, time64 date,
 }
 
 /*
- * Data structure used to pass various arguments into the following fn.
+ * Cache of the recursive balances in a report commodity.  The account
+ * tree asks for these for every visible row on each refresh, and
+ * without the cache each request walks and converts the whole subtree.
+ * An entry holds the total of the account and all its descendants; it
+ * is dropped together with those of the account's ancestors whenever
+ * the account's balance or its place in the tree changes.  Price
+ * changes and, for the balances that depend on today, the date are
+ * checked on lookup.  Reports ask for balances at many dates, so the
+ * number of entries per account is bounded: when an account is full,
+ * its entries made stale by price changes go first, and if that isn't
+ * enough all of them.  The cache is kept per book, in the book's data,
+ * and goes away with the book.  The scrubs read accounts from several
+ * threads, so it is guarded by a mutex.
  */
-typedef struct
+#define SUBTREE_BALANCE_MAX_ENTRIES 32
+
+struct SubtreeBalanceKey
 {
-    const gnc_commodity *currency;
-    gnc_numeric balance;
-    xaccGetBalanceFn fn;
-    xaccGetBalanceAsOfDateFn asOfDateFn;
+    int fn;
     time64 date;
-} CurrencyBalance;
-
+    uintptr_t commodity;
+    bool operator< (const SubtreeBalanceKey& other) const
+    {
+        return std::tie (fn, date, commodity) <
+            std::tie (other.fn, other.date, other.commodity);
+    }
+};
 
-/*
- * A helper function for iterating over all the accounts in a list or
- * tree.  This function is called once per account, and sums up the
- * values of all these accounts.
- */
-static void
-xaccAccountBalanceHelper (Account *acc, gpointer data)
+struct SubtreeBalance
 {
-    CurrencyBalance *cb = static_cast<CurrencyBalance*>(data);
     gnc_numeric balance;
+    gint64 price_generation;
+    time64 today;
+};
+
+using SubtreeBalanceMap = std::map<SubtreeBalanceKey, SubtreeBalance>;
+
+struct SubtreeBalances
+{
+    std::mutex mutex;
+    std::unordered_map<const Account*, SubtreeBalanceMap> balances;
+};
+
+#define SUBTREE_BALANCES "gnc-subtree-balances"
 
-    if (!cb->fn || !cb->currency)
+/* Drop only the account's own entries, for when it is being freed and
+ * its ancestors have already been told by gnc_account_remove_child. */
+static void
+subtree_balances_forget (const Account *acc)
+{
+    auto cache = account_book_cache_lookup<SubtreeBalances> (
+                     acc, SUBTREE_BALANCES, false);
+    if (!cache)
         return;
-    balance = xaccAccountGetXxxBalanceInCurrency (acc, cb->fn, cb->currency);
-    cb->balance = gnc_numeric_add (cb->balance, balance,
-                                   gnc_commodity_get_fraction (cb->currency),
-                                   GNC_HOW_RND_ROUND_HALF_UP);
+    std::lock_guard<std::mutex> lock (cache->mutex);
+    cache->balances.erase (acc);
 }
 
 static void
-xaccAccountBalanceAsOfDateHelper (Account *acc, gpointer data)
+subtree_balances_invalidate (const Account *acc)
 {
-    CurrencyBalance *cb = static_cast<CurrencyBalance*>(data);
-    gnc_numeric balance;
+    auto cache = account_book_cache_lookup<SubtreeBalances> (
+                     acc, SUBTREE_BALANCES, false);
+    if (!cache)
+        return;
+    std::lock_guard<std::mutex> lock (cache->mutex);
+    if (cache->balances.empty ())
+        return;
+    for (; acc; acc = GET_PRIVATE(acc)->parent)
+        cache->balances.erase (acc);
+}
 
-    g_return_if_fail (cb->asOfDateFn && cb->currency);
+/* Only the balance functions of this file are known not to change
+ * behind the cache's back; anything else is computed every time. */
+static int
+subtree_balance_fn_id (xaccGetBalanceFn fn)
+{
+    if (fn == xaccAccountGetBalance) return 1;
+    if (fn == xaccAccountGetClearedBalance) return 2;
+    if (fn == xaccAccountGetReconciledBalance) return 3;
+    if (fn == xaccAccountGetPresentBalance) return 4;
+    if (fn == xaccAccountGetProjectedMinimumBalance) return 5;
+    return 0;
+}
+
+static int
+subtree_balance_as_of_date_fn_id (xaccGetBalanceAsOfDateFn fn)
+{
+    if (fn == xaccAccountGetBalanceAsOfDate) return 6;
+    if (fn == xaccAccountGetNoclosingBalanceAsOfDate) return 7;
+    return 0;
+}
+
+static gint64
+subtree_balance_price_generation (const Account *acc)
+{
+    return gnc_pricedb_get_generation (
+               gnc_pricedb_get_db (gnc_account_get_book (acc)));
+}
+
+static gboolean
+subtree_balance_lookup (const Account *acc, const SubtreeBalanceKey& key,
+                        time64 today, gnc_numeric *balance)
+{
+    auto cache = account_book_cache_lookup<SubtreeBalances> (
+                     acc, SUBTREE_BALANCES, false);
+    if (!cache)
+        return FALSE;
 
-    balance = xaccAccountGetXxxBalanceAsOfDateInCurrency (
-                  acc, cb->date, cb->asOfDateFn, cb->currency);
-    cb->balance = gnc_numeric_add (cb->balance, balance,
-                                   gnc_commodity_get_fraction (cb->currency),
-                                   GNC_HOW_RND_ROUND_HALF_UP);
+    std::lock_guard<std::mutex> lock (cache->mutex);
+    auto entries = cache->balances.find (acc);
+    if (entries == cache->balances.end ())
+        return FALSE;
+    auto entry = entries->second.find (key);
+    if (entry == entries->second.end () ||
+        entry->second.today != today ||
+        entry->second.price_generation != subtree_balance_price_generation (acc))
+        return FALSE;
+    *balance = entry->second.balance;
+    return TRUE;
 }
 
+static void
+subtree_balance_store (const Account *acc, const SubtreeBalanceKey& key,
+                       time64 today, gnc_numeric balance)
+{
+    auto cache = account_book_cache_lookup<SubtreeBalances> (
+                     acc, SUBTREE_BALANCES, true);
+    if (!cache)
+        return;
+
+    auto generation = subtree_balance_price_generation (acc);
+    std::lock_guard<std::mutex> lock (cache->mutex);
+    auto& entries = cache->balances[acc];
 
+    if (entries.size () >= SUBTREE_BALANCE_MAX_ENTRIES &&
+        entries.find (key) == entries.end ())
+    {
+        for (auto entry = entries.begin (); entry != entries.end ();)
+            if (entry->second.price_generation != generation)
+                entry = entries.erase (entry);
+            else
+                ++entry;
+        if (entries.size () >= SUBTREE_BALANCE_MAX_ENTRIES)
+            entries.clear ();
+    }
+    entries[key] = { balance, generation, today };
+}
 
 /*
  * Common function that iterates recursively over all accounts below
- * the specified account.  It uses xaccAccountBalanceHelper to sum up
- * the balances of all its children, and uses the specified function
- * 'fn' for extracting the balance.  This function may extract the
- * current value, the reconciled value, etc.
+ * the specified account.  It sums up the balances of all its children,
+ * and uses the specified function 'fn' for extracting the balance.
+ * This function may extract the current value, the reconciled value,
+ * etc.  The children's totals come from the subtree balance cache, so
+ * repeated requests only convert the accounts that changed.
  *
  * If 'report_commodity' is NULL, just use the account's commodity.
  * If 'include_children' is FALSE, this function doesn't recurse at all.
@@ -3676,26 +3963,32 @@ xaccAccountGetXxxBalanceInCurrencyRecursive (const Account *acc,
     if (!report_commodity)
         return gnc_numeric_zero();
 
-    balance = xaccAccountGetXxxBalanceInCurrency (acc, fn, report_commodity);
+    if (!include_children)
+        return xaccAccountGetXxxBalanceInCurrency (acc, fn, report_commodity);
 
-    /* If needed, sum up the children converting to the *requested*
-       commodity. */
-    if (include_children)
-    {
-#ifdef _MSC_VER
-        /* MSVC compiler: Somehow, the struct initialization containing a
-           gnc_numeric doesn't work. As an exception, we hand-initialize
-           that member afterwards. */
-        CurrencyBalance cb = { report_commodity, { 0 }, fn, NULL, 0 };
-        cb.balance = balance;
-#else
-        CurrencyBalance cb = { report_commodity, balance, fn, NULL, 0 };
-#endif
+    SubtreeBalanceKey key { subtree_balance_fn_id (fn), 0,
+                            reinterpret_cast<uintptr_t>(report_commodity) };
+    time64 today = (fn == xaccAccountGetPresentBalance ||
+                    fn == xaccAccountGetProjectedMinimumBalance) ?
+                   gnc_time64_get_today_end () : 0;
+    if (key.fn && subtree_balance_lookup (acc, key, today, &balance))
+        return balance;
 
-        gnc_account_foreach_descendant (acc, xaccAccountBalanceHelper, &cb);
-        balance = cb.balance;
+    /* Sum up the children converting to the *requested* commodity. */
+    balance = xaccAccountGetXxxBalanceInCurrency (acc, fn, report_commodity);
+    for (auto node = GET_PRIVATE(acc)->children; node; node = node->next)
+    {
+        auto child = static_cast<const Account*>(node->data);
+        balance = gnc_numeric_add (
+                      balance,
+                      xaccAccountGetXxxBalanceInCurrencyRecursive (
+                          child, fn, report_commodity, TRUE),
+                      gnc_commodity_get_fraction (report_commodity),
+                      GNC_HOW_RND_ROUND_HALF_UP);
     }
 
+    if (key.fn)
+        subtree_balance_store (acc, key, today, balance);
     return balance;
 }
 
@@ -3712,27 +4005,31 @@ xaccAccountGetXxxBalanceAsOfDateInCurrencyRecursive (
     if (!report_commodity)
         return gnc_numeric_zero();
 
+    if (!include_children)
+        return xaccAccountGetXxxBalanceAsOfDateInCurrency (
+                   acc, date, fn, report_commodity);
+
+    SubtreeBalanceKey key { subtree_balance_as_of_date_fn_id (fn), date,
+                            reinterpret_cast<uintptr_t>(report_commodity) };
+    if (key.fn && subtree_balance_lookup (acc, key, 0, &balance))
+        return balance;
+
+    /* Sum up the children converting to the *requested* commodity. */
     balance = xaccAccountGetXxxBalanceAsOfDateInCurrency(
                   acc, date, fn, report_commodity);
-
-    /* If needed, sum up the children converting to the *requested*
-       commodity. */
-    if (include_children)
+    for (auto node = GET_PRIVATE(acc)->children; node; node = node->next)
     {
-#ifdef _MSC_VER
-        /* MSVC compiler: Somehow, the struct initialization containing a
-           gnc_numeric doesn't work. As an exception, we hand-initialize
-           that member afterwards. */
-        CurrencyBalance cb = { report_commodity, 0, NULL, fn, date };
-        cb.balance = balance;
-#else
-        CurrencyBalance cb = { report_commodity, balance, NULL, fn, date };
-#endif
-
-        gnc_account_foreach_descendant (acc, xaccAccountBalanceAsOfDateHelper, &cb);
-        balance = cb.balance;
+        auto child = static_cast<Account*>(node->data);
+        balance = gnc_numeric_add (
+                      balance,
+                      xaccAccountGetXxxBalanceAsOfDateInCurrencyRecursive (
+                          child, date, fn, report_commodity, TRUE),
+                      gnc_commodity_get_fraction (report_commodity),
+                      GNC_HOW_RND_ROUND_HALF_UP);
     }
 
+    if (key.fn)
+        subtree_balance_store (acc, key, 0, balance);
     return balance;
 }
 
@@ -3832,6 +4129,72 @@ xaccAccountGetNoclosingBalanceChangeForPeriod (Account *acc, time64 t1,
     return gnc_numeric_sub(b2, b1, GNC_DENOM_AUTO, GNC_HOW_DENOM_FIXED);
 }
 
+/* Merge the sorted dates with the (sorted) split list, picking up the
+ * running balance of the last split before each date. This only reads
+ * the account, so it can run for several accounts concurrently. */
+static void
+account_balances_at_dates (const Account *acc, const time64 *dates,
+                           gsize n_dates, gboolean ignclosing,
+                           gnc_numeric *balances)
+{
+    auto node = GET_PRIVATE(acc)->splits;
+    auto balance = gnc_numeric_zero ();
+
+    for (gsize i = 0; i < n_dates; i++)
+    {
+        for (; node; node = node->next)
+        {
+            auto split = static_cast<Split*>(node->data);
+            if (xaccTransRetDatePosted (xaccSplitGetParent (split)) > dates[i])
+                break;
+            balance = ignclosing ? xaccSplitGetNoclosingBalance (split) :
+                xaccSplitGetBalance (split);
+        }
+        balances[i] = balance;
+    }
+}
+
+gnc_numeric *
+xaccAccountsGetBalancesAtDates (GList *accounts, const time64 *dates,
+                                gsize n_dates, gboolean ignclosing)
+{
+    std::vector<Account*> accts;
+    for (auto node = accounts; node; node = node->next)
+    {
+        auto acc = static_cast<Account*>(node->data);
+        /* Get the running balances in order before going parallel */
+        xaccAccountSortSplits (acc, TRUE);
+        xaccAccountRecomputeBalance (acc);
+        accts.push_back (acc);
+    }
+
+    auto balances = g_new (gnc_numeric, accts.size() * n_dates);
+    auto compute = [&](size_t first, size_t step)
+    {
+        for (auto i = first; i < accts.size(); i += step)
+            account_balances_at_dates (accts[i], dates, n_dates, ignclosing,
+                                       balances + i * n_dates);
+    };
+
+    /* Not worth starting threads for a handful of accounts */
+    size_t n_threads = std::min<size_t> (std::thread::hardware_concurrency(),
+                                         accts.size() / 8);
+    if (n_threads <= 1)
+    {
+        compute (0, 1);
+        return balances;
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < n_threads; t++)
+        threads.emplace_back (compute, t, n_threads);
+    compute (0, n_threads);
+    for (auto& thread : threads)
+        thread.join ();
+
+    return balances;
+}
+
 
 /********************************************************************\
 \********************************************************************/
@@ -5351,18 +5714,6 @@ struct AccountInfo
     int32_t probability;
 };
 
-static void
-build_token_info(char const * key, KvpValue * value, TokenAccountsInfo & tokenInfo)
-{
-    tokenInfo.total_count += value->get<int64_t>();
-    AccountTokenCount this_account;
-    std::string account_guid {key};
-    /*By convention, the key ends with the account GUID.*/
-    this_account.account_guid = account_guid.substr(account_guid.size() - GUID_ENCODING_LENGTH);
-    this_account.token_count = value->get<int64_t>();
-    tokenInfo.accounts.push_back(this_account);
-}
-
 /** We scale the probability values by probability_factor.
   ie. with probability_factor of 100000, 10% would be
   0.10 * 100000 = 10000 */
@@ -5396,29 +5747,137 @@ highest_probability(FinalProbabilityVec const & probabilities)
     return ret;
 }
 
+/** The bayesian import map of an account is stored in its kvp frame as
+ * flat "import-map-bayes/<token>/<account guid>" keys holding a count.
+ * Reading it through the kvp for every token of every imported line is
+ * slow, so the first lookup compiles the map into an ordered table of
+ * "<token>/<account guid>" keys. The tables are kept per book, in the
+ * book's data, and go away with the book. A table is updated in place
+ * by gnc_account_imap_add_account_bayes, and dropped when the map is
+ * deleted or converted, when the account is committed (its kvp may have
+ * changed) and when the account is freed. The table has the same order
+ * as the kvp frame, and lookups match token prefixes just like
+ * qof_instance_foreach_slot_prefix, so the probabilities are computed
+ * exactly as from the kvp.
+ */
+struct BayesTokenCount
+{
+    std::string account_guid;
+    int64_t token_count;
+};
+
+using ImapBayesModel = std::map<std::string, BayesTokenCount>;
+using ImapBayesModels = std::unordered_map<const Account*, ImapBayesModel>;
+
+#define IMAP_BAYES_MODELS "gnc-imap-bayes-models"
+
+static void check_import_map_data (QofBook *book);
+
+static void
+imap_bayes_models_free (QofBook *book, gpointer key, gpointer user_data)
+{
+    delete static_cast<ImapBayesModels*>(user_data);
+    qof_book_set_data (book, IMAP_BAYES_MODELS, nullptr);
+}
+
+static ImapBayesModels *
+imap_bayes_models_lookup (QofBook *book, bool create)
+{
+    if (!book || qof_book_shutting_down (book))
+        return nullptr;
+
+    auto models = static_cast<ImapBayesModels*>(qof_book_get_data (book, IMAP_BAYES_MODELS));
+    if (!models && create)
+    {
+        models = new ImapBayesModels;
+        qof_book_set_data_fin (book, IMAP_BAYES_MODELS, models,
+                               imap_bayes_models_free);
+    }
+    return models;
+}
+
+static void
+imap_bayes_model_invalidate (Account *acc)
+{
+    auto models = imap_bayes_models_lookup (gnc_account_get_book (acc), false);
+    if (models)
+        models->erase (acc);
+}
+
+/* Returns the account's compiled table if there is one */
+static ImapBayesModel *
+imap_bayes_model_find (Account *acc)
+{
+    auto models = imap_bayes_models_lookup (gnc_account_get_book (acc), false);
+    if (!models)
+        return nullptr;
+    auto model = models->find (acc);
+    return model == models->end () ? nullptr : &model->second;
+}
+
+/* Returns the compiled table of the imap's account, compiling it first
+ * if needed. */
+static ImapBayesModel const *
+imap_bayes_model_get (GncImportMatchMap * imap)
+{
+    auto model = imap_bayes_model_find (imap->acc);
+    if (model)
+        return model;
+
+    /* Convert old data before compiling, this may change the frame */
+    check_import_map_data (imap->book);
+    auto models = imap_bayes_models_lookup (imap->book, true);
+    if (!models)
+        return nullptr;
+    auto prefix_length = strlen (IMAP_FRAME_BAYES "/");
+    auto & ret = (*models)[imap->acc];
+    auto frame = qof_instance_get_slots (QOF_INSTANCE (imap->acc));
+    frame->for_each_slot_prefix (IMAP_FRAME_BAYES "/",
+        [&ret, prefix_length] (char const * key, KvpValue * value)
+        {
+            std::string token_key {key + prefix_length};
+            /*By convention, the key ends with the account GUID.*/
+            auto guid_start = token_key.size() < GUID_ENCODING_LENGTH ? 0 :
+                token_key.size() - GUID_ENCODING_LENGTH;
+            ret.emplace_hint (ret.end (), token_key,
+                              BayesTokenCount {token_key.substr (guid_start),
+                                               value->get<int64_t>()});
+        });
+    return &ret;
+}
+
 static ProbabilityVec
 get_first_pass_probabilities(GncImportMatchMap * imap, GList * tokens)
 {
     ProbabilityVec ret;
+    std::unordered_map<std::string, size_t> ret_index;
+    auto model = imap_bayes_model_get (imap);
+    if (!model)
+        return ret;
     /* find the probability for each account that contains any of the tokens
      * in the input tokens list. */
     for (auto current_token = tokens; current_token; current_token = current_token->next)
     {
         TokenAccountsInfo tokenInfo{};
-        auto path = std::string{IMAP_FRAME_BAYES "/"} + static_cast <char const *> (current_token->data);
-        qof_instance_foreach_slot_prefix (QOF_INSTANCE (imap->acc), path, &build_token_info, tokenInfo);
+        std::string token {static_cast <char const *> (current_token->data)};
+        for (auto entry = model->lower_bound (token);
+             entry != model->end () && entry->first.compare (0, token.size (), token) == 0;
+             ++entry)
+        {
+            tokenInfo.total_count += entry->second.token_count;
+            tokenInfo.accounts.push_back ({entry->second.account_guid,
+                                           entry->second.token_count});
+        }
         for (auto const & current_account_token : tokenInfo.accounts)
         {
-            auto item = std::find_if(ret.begin(), ret.end(), [&current_account_token]
-                (std::pair<std::string, AccountProbability> const & a) {
-                    return current_account_token.account_guid == a.first;
-                });
-            if (item != ret.end())
+            auto item = ret_index.find (current_account_token.account_guid);
+            if (item != ret_index.end())
             {/* This account is already in the map */
-                item->second.product = ((double)current_account_token.token_count /
-                                      (double)tokenInfo.total_count) * item->second.product;
-                item->second.product_difference = ((double)1 - ((double)current_account_token.token_count /
-                                              (double)tokenInfo.total_count)) * item->second.product_difference;
+                auto & probability = ret[item->second].second;
+                probability.product = ((double)current_account_token.token_count /
+                                      (double)tokenInfo.total_count) * probability.product;
+                probability.product_difference = ((double)1 - ((double)current_account_token.token_count /
+                                              (double)tokenInfo.total_count)) * probability.product_difference;
             }
             else
             {
@@ -5427,6 +5886,7 @@ get_first_pass_probabilities(GncImportMatchMap * imap, GList * tokens)
                 new_probability.product = ((double)current_account_token.token_count /
                                       (double)tokenInfo.total_count);
                 new_probability.product_difference = 1 - (new_probability.product);
+                ret_index.emplace (current_account_token.account_guid, ret.size ());
                 ret.push_back({current_account_token.account_guid, std::move(new_probability)});
             }
         } /* for all accounts in tokenInfo */
@@ -5531,6 +5991,7 @@ convert_imap_account_bayes_to_flat (Account *acc)
     if (!frame->get_keys().size())
         return false;
     auto new_imap = get_new_flat_imap(acc);
+    imap_bayes_model_invalidate (acc);
     xaccAccountBeginEdit(acc);
     frame->set({IMAP_FRAME_BAYES}, nullptr);
     if (!new_imap.size ())
@@ -5596,7 +6057,6 @@ gnc_account_imap_find_account_bayes (GncImportMatchMap *imap, GList *tokens)
 {
     if (!imap)
         return nullptr;
-    check_import_map_data (imap->book);
     auto first_pass = get_first_pass_probabilities(imap, tokens);
     if (!first_pass.size())
         return nullptr;
@@ -5618,7 +6078,8 @@ gnc_account_imap_find_account_bayes (GncImportMatchMap *imap, GList *tokens)
     return account;
 }
 
-static void
+/* Add token_count to the count stored at path, returns the new count */
+static int64_t
 change_imap_entry (GncImportMatchMap *imap, std::string const & path, int64_t token_count)
 {
     GValue value = G_VALUE_INIT;
@@ -5650,6 +6111,7 @@ change_imap_entry (GncImportMatchMap *imap, std::string const & path, int64_t to
     // Add or Update the entry based on guid
     qof_instance_set_path_kvp (QOF_INSTANCE (imap->acc), &value, {path});
     gnc_features_set_used (imap->book, GNC_FEATURE_GUID_FLAT_BAYESIAN);
+    return token_count;
 }
 
 /** Updates the imap for a given account using a list of tokens */
@@ -5673,6 +6135,9 @@ gnc_account_imap_add_account_bayes (GncImportMatchMap *imap,
 
     g_return_if_fail (acc != NULL);
     account_fullname = gnc_account_get_full_name(acc);
+    /* Keep an already compiled table in sync while the account is open,
+     * the commit drops it anyway unless the caller holds an edit. */
+    auto model = imap_bayes_model_find (imap->acc);
     xaccAccountBeginEdit (imap->acc);
 
     PINFO("account name: '%s'", account_fullname);
@@ -5692,9 +6157,12 @@ gnc_account_imap_add_account_bayes (GncImportMatchMap *imap,
         /* start off with one token for this account */
         token_count = 1;
         PINFO("adding token '%s'", (char*)current_token->data);
-        auto path = std::string {IMAP_FRAME_BAYES} + '/' + static_cast<char*>(current_token->data) + '/' + guid_string;
+        auto token_key = std::string {static_cast<char*>(current_token->data)} + '/' + guid_string;
+        auto path = std::string {IMAP_FRAME_BAYES} + '/' + token_key;
         /* change the imap entry for the account */
-        change_imap_entry (imap, path, token_count);
+        token_count = change_imap_entry (imap, path, token_count);
+        if (model)
+            (*model)[token_key] = BayesTokenCount {guid_string, token_count};
     }
     /* free up the account fullname and guid string */
     qof_instance_set_dirty (QOF_INSTANCE (imap->acc));
@@ -5839,6 +6307,7 @@ gnc_account_delete_map_entry (Account *acc, char *head, char *category,
 {
     if (acc != NULL)
     {
+        imap_bayes_model_invalidate (acc);
         std::vector<std::string> path {head};
         if (category)
             path.emplace_back (category);
@@ -5865,6 +6334,7 @@ gnc_account_delete_all_bayes_maps (Account *acc)
 {
     if (acc != NULL)
     {
+        imap_bayes_model_invalidate (acc);
         auto slots = qof_instance_get_slots_prefix (QOF_INSTANCE (acc), IMAP_FRAME_BAYES);
         if (!slots.size()) return;
         for (auto const & entry : slots)
@@ -611,6 +611,27 @@ gnc_numeric xaccAccountGetNoclosingBalanceChangeForPeriod (
 gnc_numeric xaccAccountGetBalanceChangeForPeriod (
     Account *acc, time64 date1, time64 date2, gboolean recurse);
 
+/** Get the balances of several accounts at several dates at once. The
+ *  split list of each account is walked only once, and on multi-core
+ *  machines the accounts are spread over several threads.
+ *
+ *  @param accounts The list of accounts
+ *  @param dates The dates, sorted in ascending order
+ *  @param n_dates The number of dates
+ *  @param ignclosing If TRUE closing transactions are not counted
+ *  @return A newly allocated array of g_list_length(accounts) * n_dates
+ *  balances, to be freed with g_free(). The balance of the i-th account
+ *  at the j-th date is found at index i * n_dates + j and includes all
+ *  splits posted up to and including that date, i.e. every split whose
+ *  posted date is <= the date, even several splits posted at exactly
+ *  that time. The balances are in each account's own commodity,
+ *  sub-accounts are not included.
+ */
+gnc_numeric *xaccAccountsGetBalancesAtDates (GList *accounts,
+                                             const time64 *dates,
+                                             gsize n_dates,
+                                             gboolean ignclosing);
+
 /** @} */
 
 /** @name Account Children and Parents.
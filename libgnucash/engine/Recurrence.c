@@ -174,6 +174,29 @@ nth_weekday_compare(const GDate *start, const GDate *next, PeriodType pt)
 }
 
 
+/* Move a date that falls on a weekend to the Friday before or the
+   Monday after it, as asked by wadj. */
+static void
+adjust_for_weekend(GDate *date, WeekendAdjust wadj)
+{
+    if (g_date_get_weekday(date) == G_DATE_SATURDAY || g_date_get_weekday(date) == G_DATE_SUNDAY)
+    {
+        switch (wadj)
+        {
+        case WEEKEND_ADJ_BACK:
+            g_date_subtract_days(date, g_date_get_weekday(date) == G_DATE_SATURDAY ? 1 : 2);
+            break;
+        case WEEKEND_ADJ_FORWARD:
+            g_date_add_days(date, g_date_get_weekday(date) == G_DATE_SATURDAY ? 2 : 1);
+            break;
+        case WEEKEND_ADJ_NONE:
+        default:
+            break;
+        }
+    }
+}
+
+
 /* This is the only real algorithm related to recurrences.  It goes:
    Step 1) Go forward one period from the reference date.
    Step 2) Back up to align to the phase of the start date.
@@ -343,23 +366,7 @@ recurrenceNextInstance(const Recurrence *r, const GDate *ref, GDate *next)
 
         /* Adjust for dates on the weekend. */
         if (pt == PERIOD_YEAR || pt == PERIOD_MONTH || pt == PERIOD_END_OF_MONTH)
-        {
-            if (g_date_get_weekday(next) == G_DATE_SATURDAY || g_date_get_weekday(next) == G_DATE_SUNDAY)
-            {
-                switch (wadj)
-                {
-                case WEEKEND_ADJ_BACK:
-                    g_date_subtract_days(next, g_date_get_weekday(next) == G_DATE_SATURDAY ? 1 : 2);
-                    break;
-                case WEEKEND_ADJ_FORWARD:
-                    g_date_add_days(next, g_date_get_weekday(next) == G_DATE_SATURDAY ? 2 : 1);
-                    break;
-                case WEEKEND_ADJ_NONE:
-                default:
-                    break;
-                }
-            }
-        }
+            adjust_for_weekend(next, wadj);
 
     }
     break;
@@ -373,14 +380,77 @@ recurrenceNextInstance(const Recurrence *r, const GDate *ref, GDate *next)
     }
 }
 
-/* Zero-based index */
+/* The nth instance of a monthly kind of recurrence, n > 0.  Each step
+   of recurrenceNextInstance() lands in the month mult months after the
+   previous instance and realigns the day to the start date, so the nth
+   instance is the start month plus n * mult months, aligned the same
+   way. */
+static void
+nth_month_instance(const Recurrence *r, guint n, GDate *date)
+{
+    const GDate *start = &r->start;
+    PeriodType pt = r->ptype;
+    guint months = n * r->mult * (pt == PERIOD_YEAR ? 12 : 1);
+    guint dim;
+
+    g_date_set_dmy(date, 1, g_date_get_month(start), g_date_get_year(start));
+    g_date_add_months(date, months);
+    dim = g_date_get_days_in_month(g_date_get_month(date),
+                                   g_date_get_year(date));
+
+    if (pt == PERIOD_LAST_WEEKDAY || pt == PERIOD_NTH_WEEKDAY)
+    {
+        gint wdresult = nth_weekday_compare(start, date, pt);
+        if (wdresult < 0)
+            g_date_subtract_days(date, -wdresult);
+        else
+            g_date_add_days(date, wdresult);
+        return;
+    }
+
+    if (pt == PERIOD_END_OF_MONTH || g_date_get_day(start) >= dim)
+        g_date_set_day(date, dim);  /* last day in the month */
+    else
+        g_date_set_day(date, g_date_get_day(start)); /*same day as start*/
+
+    adjust_for_weekend(date, r->wadj);
+}
+
+/* Zero-based index.  Gives the same date as calling
+   recurrenceNextInstance() n times from the start date, directly. */
 void
 recurrenceNthInstance(const Recurrence *r, guint n, GDate *date)
 {
     GDate ref;
     guint i;
 
-    for (*date = ref = r->start, i = 0; i < n; i++)
+    *date = r->start;
+    if (n == 0 || !g_date_valid(&r->start))
+        return;
+
+    switch (r->ptype)
+    {
+    case PERIOD_ONCE:
+        g_date_clear(date, 1);
+        return;
+    case PERIOD_DAY:
+        g_date_add_days(date, n * r->mult);
+        return;
+    case PERIOD_WEEK:
+        g_date_add_days(date, n * r->mult * 7);
+        return;
+    case PERIOD_MONTH:
+    case PERIOD_END_OF_MONTH:
+    case PERIOD_NTH_WEEKDAY:
+    case PERIOD_LAST_WEEKDAY:
+    case PERIOD_YEAR:
+        nth_month_instance(r, n, date);
+        return;
+    default:
+        break;
+    }
+
+    for (ref = r->start, i = 0; i < n; i++)
     {
         recurrenceNextInstance(r, &ref, date);
         ref = *date;
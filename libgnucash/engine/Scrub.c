@@ -59,15 +59,205 @@
 static QofLogModule log_module = G_LOG_DOMAIN;
 
 /* ================================================================ */
+/* The tree scrubs first look for the transactions or accounts that
+ * need repair, with several threads each claiming the next account
+ * not yet examined, and then repair them on the calling thread.
+ * Examining an account only reads the engine objects. */
 
-void
-xaccAccountTreeScrubOrphans (Account *acc, QofPercentageFunc percentagefunc)
+#define SCRUB_MIN_ACCOUNTS_PER_THREAD 8
+/* The most transactions held open for edit at once by the repairs. */
+#define SCRUB_BATCH_SIZE 1000
+
+typedef struct
 {
-    if (!acc) return;
+    Account **accounts;
+    gint n_accounts;
+    GList **found;          /* one list per account */
+    gint next;              /* the next account to examine */
+    gint done;              /* the number of accounts examined */
+    ScrubDetectFunc detect;
+    gpointer user_data;
+} ScrubDetectData;
+
+static gboolean
+scrub_detect_next (ScrubDetectData *data)
+{
+    gint i = g_atomic_int_add (&data->next, 1);
+
+    if (i >= data->n_accounts) return FALSE;
+
+    data->found[i] = data->detect (data->accounts[i], data->user_data);
+    g_atomic_int_inc (&data->done);
+    return TRUE;
+}
+
+static gpointer
+scrub_detect_thread (gpointer user_data)
+{
+    ScrubDetectData *data = user_data;
 
-    xaccAccountScrubOrphans (acc, percentagefunc);
-    gnc_account_foreach_descendant(acc,
-                                   (AccountCb)xaccAccountScrubOrphans, percentagefunc);
+    while (scrub_detect_next (data));
+    return NULL;
+}
+
+static void
+scrub_detect_progress (ScrubDetectData *data, const char *message,
+                       QofPercentageFunc percentagefunc)
+{
+    gint done = g_atomic_int_get (&data->done);
+    char *progress_msg = g_strdup_printf (message, done, data->n_accounts);
+
+    (percentagefunc)(progress_msg, (100 * done) / data->n_accounts);
+    g_free (progress_msg);
+}
+
+GList *
+xaccScrubUtilityFindCandidates (GList *accounts, ScrubDetectFunc detect,
+                                gpointer user_data, const char *message,
+                                QofPercentageFunc percentagefunc)
+{
+    ScrubDetectData data;
+    GThread **threads;
+    GHashTable *seen;
+    GList *node, *candidates = NULL;
+    gint i, n_threads;
+
+    data.n_accounts = g_list_length (accounts);
+    if (data.n_accounts == 0) return NULL;
+
+    /* Getting an account's splits sorts them if they are out of order,
+     * and sorting fills in the book's cached num field source.  Do both
+     * here so the detection threads only ever read them. */
+    qof_book_use_split_action_for_num_field (
+        gnc_account_get_book (accounts->data));
+    data.accounts = g_new (Account *, data.n_accounts);
+    for (node = accounts, i = 0; node; node = node->next, i++)
+    {
+        data.accounts[i] = node->data;
+        xaccAccountSortSplits (node->data, FALSE);
+    }
+    data.found = g_new0 (GList *, data.n_accounts);
+    data.next = 0;
+    data.done = 0;
+    data.detect = detect;
+    data.user_data = user_data;
+
+    n_threads = MIN (g_get_num_processors (),
+                     data.n_accounts / SCRUB_MIN_ACCOUNTS_PER_THREAD);
+    threads = g_new0 (GThread *, MAX (n_threads, 1));
+
+    /* The progress callback may run the GUI main loop, whose handlers
+     * can change the engine, so it is only called while no other thread
+     * is reading it. */
+    if (percentagefunc && message)
+        scrub_detect_progress (&data, message, percentagefunc);
+    for (i = 1; i < n_threads; i++)
+        threads[i] = g_thread_try_new ("gnc-scrub", scrub_detect_thread,
+                                       &data, NULL);
+
+    /* The calling thread takes its share; on its own it reports its
+     * progress as it goes. */
+    while (scrub_detect_next (&data))
+    {
+        if (n_threads <= 1 && percentagefunc && message)
+            scrub_detect_progress (&data, message, percentagefunc);
+    }
+    for (i = 1; i < n_threads; i++)
+        if (threads[i])
+            g_thread_join (threads[i]);
+    if (n_threads > 1 && percentagefunc && message)
+        scrub_detect_progress (&data, message, percentagefunc);
+
+    /* A transaction shows up once for each of its splits; keep the first
+     * time, which is when a serial pass would have repaired it. */
+    seen = g_hash_table_new (g_direct_hash, g_direct_equal);
+    for (i = 0; i < data.n_accounts; i++)
+    {
+        for (node = data.found[i]; node; node = node->next)
+        {
+            if (g_hash_table_contains (seen, node->data)) continue;
+            g_hash_table_add (seen, node->data);
+            candidates = g_list_prepend (candidates, node->data);
+        }
+        g_list_free (data.found[i]);
+    }
+    g_hash_table_destroy (seen);
+    g_free (threads);
+    g_free (data.found);
+    g_free (data.accounts);
+
+    return g_list_reverse (candidates);
+}
+
+static GList *
+tree_scrub_accounts (Account *acc)
+{
+    return g_list_prepend (gnc_account_get_descendants (acc), acc);
+}
+
+static gboolean
+trans_has_orphans (const Transaction *trans)
+{
+    GList *node;
+
+    for (node = trans->splits; node; node = node->next)
+    {
+        Split *split = node->data;
+        if (!split->acc) return TRUE;
+    }
+    return FALSE;
+}
+
+static GList *
+detect_orphans (Account *acc, gpointer user_data)
+{
+    GList *node, *found = NULL;
+
+    for (node = xaccAccountGetSplitList (acc); node; node = node->next)
+    {
+        Transaction *trans = xaccSplitGetParent (node->data);
+        if (trans && trans_has_orphans (trans))
+            found = g_list_prepend (found, trans);
+    }
+    return g_list_reverse (found);
+}
+
+/* Repairs the candidate transactions with fix, in order, opening them
+ * for edit SCRUB_BATCH_SIZE at a time and committing each batch
+ * together.  Progress is only reported between batches, when no
+ * transaction is open. */
+static void
+tree_scrub_apply (GList *candidates, void (*fix)(Transaction *, Account *),
+                  Account *root, const char *message,
+                  QofPercentageFunc percentagefunc)
+{
+    GList *node = candidates;
+    guint total = g_list_length (candidates);
+    guint current = 0;
+
+    while (node)
+    {
+        GList *batch = NULL;
+        guint n;
+
+        if (percentagefunc)
+        {
+            char *progress_msg = g_strdup_printf (message, current, total);
+            (percentagefunc)(progress_msg, (100 * current) / total);
+            g_free (progress_msg);
+        }
+
+        for (n = 0; node && n < SCRUB_BATCH_SIZE; n++, node = node->next)
+        {
+            xaccTransBeginEdit (node->data);
+            fix (node->data, root);
+            batch = g_list_prepend (batch, node->data);
+        }
+        batch = g_list_reverse (batch);
+        xaccTransCommitEditBatch (batch);
+        g_list_free (batch);
+        current += n;
+    }
 }
 
 static void
@@ -100,6 +290,29 @@ TransScrubOrphansFast (Transaction *trans, Account *root)
     }
 }
 
+void
+xaccAccountTreeScrubOrphans (Account *acc, QofPercentageFunc percentagefunc)
+{
+    GList *accounts, *candidates;
+
+    if (!acc) return;
+
+    PINFO ("Looking for orphans below account %s \n",
+           xaccAccountGetName (acc));
+    accounts = tree_scrub_accounts (acc);
+    candidates = xaccScrubUtilityFindCandidates (accounts, detect_orphans, NULL,
+                 _("Looking for orphans: %u of %u accounts"), percentagefunc);
+    g_list_free (accounts);
+
+    tree_scrub_apply (candidates, TransScrubOrphansFast,
+                      gnc_account_get_root (acc),
+                      _("Fixing orphans: %u of %u transactions"),
+                      percentagefunc);
+    g_list_free (candidates);
+    if (percentagefunc)
+        (percentagefunc)(NULL, -1.0);
+}
+
 void
 xaccAccountScrubOrphans (Account *acc, QofPercentageFunc percentagefunc)
 {
@@ -108,9 +321,11 @@ xaccAccountScrubOrphans (Account *acc, QofPercentageFunc percentagefunc)
     const char *message = _( "Looking for orphans in account %s: %u of %u");
     guint total_splits = 0;
     guint current_split = 0;
+    Account *root;
 
     if (!acc) return;
 
+    root = gnc_account_get_root (acc);
     str = xaccAccountGetName (acc);
     str = str ? str : "(null)";
     PINFO ("Looking for orphans in account %s \n", str);
@@ -128,8 +343,7 @@ xaccAccountScrubOrphans (Account *acc, QofPercentageFunc percentagefunc)
             g_free (progress_msg);
         }
 
-        TransScrubOrphansFast (xaccSplitGetParent (split),
-                               gnc_account_get_root (acc));
+        TransScrubOrphansFast (xaccSplitGetParent (split), root);
         current_split++;
     }
     (percentagefunc)(NULL, -1.0);
@@ -288,12 +502,100 @@ xaccSplitScrub (Split *split)
 
 /* ================================================================ */
 
+/* Whether the serial imbalance scrub of trans could change anything,
+ * checked against what each of its steps acts on:
+ *   - TransScrubOrphansFast and xaccTransScrubOrphans: a split without
+ *     an account;
+ *   - xaccTransScrubCurrency: a missing or non-currency currency;
+ *   - xaccSplitScrub: a split value or amount that isn't a number, an
+ *     account without a commodity, or an amount that differs from the
+ *     value in the transaction's currency (equal implies "same" at any
+ *     SCU, so this is the stricter test);
+ *   - the rest of xaccTransScrubImbalance: !xaccTransIsBalanced.
+ * These are checked on the transaction as it was before any repair.
+ * A repair only changes its own transaction, the account it creates,
+ * or the commodity of an account without one, whose transactions are
+ * caught by the commodity check already; so every transaction the
+ * serial pass would change is a candidate.  utest-Scrub compares the
+ * two on a generated book. */
+static gboolean
+trans_needs_imbalance_scrub (const Transaction *trans)
+{
+    GList *node;
+    gnc_commodity *currency = trans->common_currency;
+    gnc_numeric imbal = gnc_numeric_zero ();
+
+    if (!currency || !gnc_commodity_is_currency (currency))
+        return TRUE;
+
+    for (node = trans->splits; node; node = node->next)
+    {
+        Split *split = node->data;
+        gnc_commodity *acc_commodity;
+
+        if (!split->acc) return TRUE;
+        if (gnc_numeric_check (split->value) ||
+                gnc_numeric_check (split->amount))
+            return TRUE;
+
+        acc_commodity = xaccAccountGetCommodity (split->acc);
+        if (!acc_commodity) return TRUE;
+        if (gnc_commodity_equiv (acc_commodity, currency) &&
+                !gnc_numeric_equal (split->amount, split->value))
+            return TRUE;
+
+        imbal = gnc_numeric_add (imbal, split->value,
+                                 GNC_DENOM_AUTO, GNC_HOW_DENOM_EXACT);
+    }
+
+    if (!gnc_numeric_zero_p (imbal)) return TRUE;
+    return !xaccTransIsBalanced (trans);
+}
+
+static GList *
+detect_imbalance (Account *acc, gpointer user_data)
+{
+    GList *node, *found = NULL;
+
+    for (node = xaccAccountGetSplitList (acc); node; node = node->next)
+    {
+        Transaction *trans = xaccSplitGetParent (node->data);
+        if (trans && trans_needs_imbalance_scrub (trans))
+            found = g_list_prepend (found, trans);
+    }
+    return g_list_reverse (found);
+}
+
+static void
+TransScrubImbalanceFast (Transaction *trans, Account *root)
+{
+    TransScrubOrphansFast (trans, root);
+    xaccTransScrubCurrency (trans);
+    xaccTransScrubImbalance (trans, root, NULL);
+}
+
 void
 xaccAccountTreeScrubImbalance (Account *acc, QofPercentageFunc percentagefunc)
 {
-    xaccAccountScrubImbalance (acc, percentagefunc);
-    gnc_account_foreach_descendant(acc,
-                                   (AccountCb)xaccAccountScrubImbalance, percentagefunc);
+    GList *accounts, *candidates;
+
+    if (!acc) return;
+
+    PINFO ("Looking for imbalances below account %s \n",
+           xaccAccountGetName (acc));
+    accounts = tree_scrub_accounts (acc);
+    candidates = xaccScrubUtilityFindCandidates (accounts, detect_imbalance,
+                 NULL, _("Looking for imbalances: %u of %u accounts"),
+                 percentagefunc);
+    g_list_free (accounts);
+
+    tree_scrub_apply (candidates, TransScrubImbalanceFast,
+                      gnc_account_get_root (acc),
+                      _("Fixing imbalances: %u of %u transactions"),
+                      percentagefunc);
+    g_list_free (candidates);
+    if (percentagefunc)
+        (percentagefunc)(NULL, -1.0);
 }
 
 void
@@ -303,9 +605,11 @@ xaccAccountScrubImbalance (Account *acc, QofPercentageFunc percentagefunc)
     const char *str;
     const char *message = _( "Looking for imbalances in account %s: %u of %u");
     gint split_count = 0, curr_split_no = 0;
+    Account *root;
 
     if (!acc) return;
 
+    root = gnc_account_get_root (acc);
     str = xaccAccountGetName(acc);
     str = str ? str : "(null)";
     PINFO ("Looking for imbalances in account %s \n", str);
@@ -327,13 +631,12 @@ xaccAccountScrubImbalance (Account *acc, QofPercentageFunc percentagefunc)
             g_free (progress_msg);
         }
 
-        TransScrubOrphansFast (xaccSplitGetParent (split),
-                               gnc_account_get_root (acc));
+        TransScrubOrphansFast (xaccSplitGetParent (split), root);
         (percentagefunc)(NULL, 0.0);
 
         xaccTransScrubCurrency(trans);
 
-        xaccTransScrubImbalance (trans, gnc_account_get_root (acc), NULL);
+        xaccTransScrubImbalance (trans, root, NULL);
 
         PINFO("Finished processing split %d of %d",
               curr_split_no + 1, split_count);
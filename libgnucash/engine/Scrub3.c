@@ -42,6 +42,7 @@
 #include "AccountP.h"
 #include "Scrub2.h"
 #include "Scrub3.h"
+#include "ScrubP.h"
 #include "Transaction.h"
 #include "TransactionP.h"
 
@@ -155,12 +156,10 @@ rethin:
 
 /* ============================================================== */
 
-void
-xaccAccountScrubLots (Account *acc)
+static void
+scrub_account_lots (Account *acc)
 {
     LotList *lots, *node;
-    if (!acc) return;
-    if (FALSE == xaccAccountHasTrades (acc)) return;
 
     ENTER ("(acc=%s)", xaccAccountGetName(acc));
     xaccAccountBeginEdit(acc);
@@ -177,22 +176,40 @@ xaccAccountScrubLots (Account *acc)
     LEAVE ("(acc=%s)", xaccAccountGetName(acc));
 }
 
+void
+xaccAccountScrubLots (Account *acc)
+{
+    if (!acc) return;
+    if (FALSE == xaccAccountHasTrades (acc)) return;
+    scrub_account_lots (acc);
+}
+
 /* ============================================================== */
 
-static void
-lot_scrub_cb (Account *acc, gpointer data)
+static GList *
+detect_trades (Account *acc, gpointer user_data)
 {
-    if (FALSE == xaccAccountHasTrades (acc)) return;
-    xaccAccountScrubLots (acc);
+    return xaccAccountHasTrades (acc) ? g_list_prepend (NULL, acc) : NULL;
 }
 
 void
 xaccAccountTreeScrubLots (Account *acc)
 {
+    GList *accounts, *traded, *node;
+
     if (!acc) return;
 
-    gnc_account_foreach_descendant(acc, lot_scrub_cb, NULL);
-    xaccAccountScrubLots (acc);
+    /* Finding the accounts with trades reads all of their splits, so do
+     * that on several threads; the lots are scrubbed one account at a
+     * time, children first. */
+    accounts = g_list_append (gnc_account_get_descendants (acc), acc);
+    traded = xaccScrubUtilityFindCandidates (accounts, detect_trades, NULL,
+                                             NULL, NULL);
+    g_list_free (accounts);
+
+    for (node = traded; node; node = node->next)
+        scrub_account_lots (node->data);
+    g_list_free (traded);
 }
 
 /* ========================== END OF FILE  ========================= */
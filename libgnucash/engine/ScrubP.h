@@ -37,5 +37,15 @@ Account * xaccScrubUtilityGetOrMakeAccount (Account *root,
         gnc_commodity * currency, const char *accname,
         GNCAccountType acctype, gboolean placeholder);
 
+/* Returns the transactions, accounts, etc. that need repair in the given
+ * accounts, as reported by detect for each account, in account order and
+ * without duplicates.  detect runs on several threads at once and must
+ * not change anything.  message, if given, is the progress message with
+ * two %u for the accounts examined and their total.  Not for public use. */
+typedef GList * (*ScrubDetectFunc) (Account *acc, gpointer user_data);
+GList * xaccScrubUtilityFindCandidates (GList *accounts, ScrubDetectFunc detect,
+                                        gpointer user_data, const char *message,
+                                        QofPercentageFunc percentagefunc);
+
 
 #endif /* XACC_SCRUB_P_H */
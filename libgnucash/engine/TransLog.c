@@ -89,6 +89,26 @@ static FILE * trans_log = NULL; /**< current log file handle */
 static char * trans_log_name = NULL; /**< current log file name */
 static char * log_base_name = NULL;
 
+/* Records are formatted by the committing thread and appended to
+ * log_pending; the writer thread swaps the buffer out and writes it to
+ * the file when the flush policy says so.  If the thread can't be
+ * started the records are written synchronously, as they used to be.
+ * Everything below is protected by log_mutex. */
+#define LOG_BUFFER_MAX (1 << 20) /**< block committers beyond this many pending bytes */
+
+static GMutex log_mutex;
+static GCond log_cond;              /**< wakes the writer */
+static GCond log_written_cond;      /**< signalled after each write */
+static GThread * log_writer = NULL;
+static GString * log_pending = NULL;
+static guint log_pending_records = 0;
+static gint64 log_pending_since = 0; /**< monotonic time of the oldest pending record */
+static guint64 log_flush_requests = 0;
+static guint64 log_flushes_done = 0;
+static gboolean log_stop = FALSE;
+static guint log_flush_records = 1;
+static guint log_flush_msec = 0;
+
 /********************************************************************\
 \********************************************************************/
 
@@ -101,6 +121,147 @@ void xaccLogEnable  (void)
     gen_logs = 1;
 }
 
+void
+xaccLogSetFlushPolicy (guint records, guint msec)
+{
+    g_mutex_lock (&log_mutex);
+    log_flush_records = records;
+    log_flush_msec = msec;
+    g_cond_signal (&log_cond);
+    g_mutex_unlock (&log_mutex);
+}
+
+/********************************************************************\
+\********************************************************************/
+
+/* Must be called with log_mutex held. */
+static gboolean
+log_pending_due (void)
+{
+    if (!log_pending_records)
+        return FALSE;
+    if (log_pending->len >= LOG_BUFFER_MAX)
+        return TRUE;
+    if (log_flush_records && log_pending_records >= log_flush_records)
+        return TRUE;
+    if (log_flush_msec &&
+        g_get_monotonic_time () >= log_pending_since +
+        (gint64)log_flush_msec * G_TIME_SPAN_MILLISECOND)
+        return TRUE;
+    return FALSE;
+}
+
+static gpointer
+log_writer_func (gpointer data)
+{
+    FILE *file = data;
+    GString *out = g_string_sized_new (4096);
+    GString *tmp;
+    guint64 serving;
+
+    g_mutex_lock (&log_mutex);
+    while (TRUE)
+    {
+        while (!log_stop && log_flushes_done == log_flush_requests &&
+               !log_pending_due ())
+        {
+            if (log_pending_records && log_flush_msec)
+                g_cond_wait_until (&log_cond, &log_mutex, log_pending_since +
+                                   (gint64)log_flush_msec * G_TIME_SPAN_MILLISECOND);
+            else
+                g_cond_wait (&log_cond, &log_mutex);
+        }
+
+        tmp = out;
+        out = log_pending;
+        log_pending = tmp;
+        log_pending_records = 0;
+        serving = log_flush_requests;
+        g_mutex_unlock (&log_mutex);
+
+        if (out->len)
+        {
+            fwrite (out->str, 1, out->len, file);
+            /* get data out to the disk */
+            fflush (file);
+            g_string_truncate (out, 0);
+        }
+
+        g_mutex_lock (&log_mutex);
+        log_flushes_done = serving;
+        g_cond_broadcast (&log_written_cond);
+        if (log_stop && !log_pending->len)
+            break;
+    }
+    g_mutex_unlock (&log_mutex);
+
+    g_string_free (out, TRUE);
+    return NULL;
+}
+
+static void
+log_start_writer (void)
+{
+    GError *error = NULL;
+
+    if (!log_pending)
+        log_pending = g_string_sized_new (4096);
+    log_stop = FALSE;
+    log_writer = g_thread_try_new ("translog", log_writer_func, trans_log, &error);
+    if (!log_writer)
+    {
+        PWARN ("Cannot start the transaction log writer, writing synchronously: %s",
+               error->message);
+        g_error_free (error);
+    }
+}
+
+static void
+log_append (const GString *record)
+{
+    if (!log_writer)
+    {
+        fwrite (record->str, 1, record->len, trans_log);
+        fflush (trans_log);
+        return;
+    }
+
+    g_mutex_lock (&log_mutex);
+    /* Don't let a slow disk make the buffer grow without bound */
+    while (log_pending->len >= LOG_BUFFER_MAX)
+    {
+        g_cond_signal (&log_cond);
+        g_cond_wait (&log_written_cond, &log_mutex);
+    }
+    if (!log_pending_records)
+        log_pending_since = g_get_monotonic_time ();
+    g_string_append_len (log_pending, record->str, record->len);
+    log_pending_records++;
+    if (log_pending_due ())
+        g_cond_signal (&log_cond);
+    g_mutex_unlock (&log_mutex);
+}
+
+void
+xaccLogFlush (void)
+{
+    guint64 request;
+
+    if (!log_writer)
+    {
+        if (trans_log)
+            fflush (trans_log);
+        return;
+    }
+
+    g_mutex_lock (&log_mutex);
+    request = ++log_flush_requests;
+    g_cond_signal (&log_cond);
+    while (log_flushes_done < request)
+        g_cond_wait (&log_written_cond, &log_mutex);
+    g_mutex_unlock (&log_mutex);
+}
+
 /********************************************************************\
 \********************************************************************/
 
@@ -202,6 +363,9 @@ xaccOpenLog (void)
              "notes\tmemo\taction\treconciled\t"
              "amount\tvalue\tdate_reconciled\n");
     fprintf (trans_log, "-----------------\n");
+    fflush (trans_log);
+
+    log_start_writer ();
 }
 
 /********************************************************************\
@@ -211,6 +375,17 @@ void
 xaccCloseLog (void)
 {
     if (!trans_log) return;
+
+    if (log_writer)
+    {
+        g_mutex_lock (&log_mutex);
+        log_stop = TRUE;
+        g_cond_signal (&log_cond);
+        g_mutex_unlock (&log_mutex);
+        g_thread_join (log_writer);
+        log_writer = NULL;
+    }
+
     fflush (trans_log);
     fclose (trans_log);
     trans_log = NULL;
@@ -227,6 +402,7 @@ xaccTransWriteLog (Transaction *trans, char flag)
     char split_guid_str[GUID_ENCODING_LENGTH + 1];
     const char *trans_notes;
     char dnow[100], dent[100], dpost[100], drecn[100];
+    GString *record;
 
     if (!gen_logs)
     {
@@ -235,12 +411,13 @@ xaccTransWriteLog (Transaction *trans, char flag)
     }
     if (!trans_log) return;
 
-    gnc_time64_to_iso8601_buff (gnc_time(NULL), dnow);
+    gnc_time64_to_iso8601_buff (gnc_time (NULL), dnow);
     gnc_time64_to_iso8601_buff (trans->date_entered, dent);
     gnc_time64_to_iso8601_buff (trans->date_posted, dpost);
     guid_to_string_buff (xaccTransGetGUID(trans), trans_guid_str);
     trans_notes = xaccTransGetNotes(trans);
-    fprintf (trans_log, "===== START\n");
+    record = g_string_sized_new (512);
+    g_string_append (record, "===== START\n");
 
     for (node = trans->splits; node; node = node->next)
     {
@@ -268,7 +445,7 @@ xaccTransWriteLog (Transaction *trans, char flag)
         val = xaccSplitGetValue (split);
 
         /* use tab-separated fields */
-        fprintf (trans_log,
+        g_string_append_printf (record,
                  "%c\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t"
                  "%s\t%s\t%s\t%s\t%c\t%" G_GINT64_FORMAT "/%" G_GINT64_FORMAT "\t%" G_GINT64_FORMAT "/%" G_GINT64_FORMAT "\t%s\n",
                  flag,
@@ -294,10 +471,10 @@ xaccTransWriteLog (Transaction *trans, char flag)
                  drecn);
     }
 
-    fprintf (trans_log, "===== END\n");
+    g_string_append (record, "===== END\n");
 
-    /* get data out to the disk */
-    fflush (trans_log);
+    log_append (record);
+    g_string_free (record, TRUE);
 }
 
 /************************ END OF ************************************\
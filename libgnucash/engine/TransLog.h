@@ -34,6 +34,16 @@
     There are some simple command-line tools that will read a log
     and replay it.
 
+    Records are written to the file by a background thread, so a
+    committed transaction is not necessarily in the log yet when the
+    commit returns.  With the default flush policy the thread writes
+    each record as soon as it gets to it, and a crash loses at most the
+    records it had not written yet.  Other policies trade more of
+    them for fewer writes, see xaccLogSetFlushPolicy().  The log is
+    written out completely by xaccLogFlush(), by xaccCloseLog(), which
+    saving the book and gnc_engine_shutdown() call, and whenever a
+    megabyte of records is pending.
+
     @{ */
 /** @file TransLog.h
     @brief API for the transaction logger
@@ -78,6 +88,20 @@ void    xaccLogDisable (void);
  */
 void    xaccLogSetBaseName (const char *);
 
+/** The xaccLogSetFlushPolicy() method sets when the log is written out.
+ *    Records are written by a background thread once @a records of them
+ *    are pending or the oldest has waited @a msec milliseconds, whichever
+ *    comes first; 0 disables that trigger.  With both 0 the log is only
+ *    written by xaccLogFlush() and when it is closed, for instance when
+ *    the book is saved.  The default writes each record as soon as the
+ *    thread gets to it.  GnuCash sets it from the "translog-flush-records"
+ *    and "translog-flush-interval" general preferences.
+ */
+void    xaccLogSetFlushPolicy (guint records, guint msec);
+
+/** Write out all pending log records and wait until they are on disk. */
+void    xaccLogFlush (void);
+
 /** Test a filename to see if it is the name of the current logfile */
 gboolean xaccFileIsCurrentLog (const gchar *name);
 
@@ -1703,6 +1703,105 @@ xaccTransCommitEdit (Transaction *trans)
     LEAVE ("(trans=%p)", trans);
 }
 
+/* Open the accounts of the transaction's splits for editing, once each,
+ * so that they sort their splits and recompute their balances only when
+ * the batch is done. */
+static void
+batch_begin_accounts (Transaction *trans, GHashTable *accounts)
+{
+    GList *node;
+
+    for (node = trans->splits; node; node = node->next)
+    {
+        Split *s = node->data;
+        if (!s->acc || g_hash_table_contains (accounts, s->acc))
+            continue;
+
+        xaccAccountBeginEdit (s->acc);
+        g_hash_table_add (accounts, s->acc);
+    }
+}
+
+void
+xaccTransCommitEditBatch (GList *trans_list)
+{
+    GHashTable *accounts;
+    GHashTableIter iter;
+    gpointer acc;
+    GList *node, *destroyed = NULL;
+    QofBook *book;
+    QofBackend *be;
+    int saved_scrub_data = scrub_data;
+
+    if (!trans_list) return;
+    ENTER ("(%d transactions)", g_list_length (trans_list));
+
+    book = xaccTransGetBook (trans_list->data);
+    be = qof_book_get_backend (book);
+
+    /* Enforce the constraints xaccTransCommitEdit would, in one pass over
+     * the transactions that are really going to be committed. */
+    if (scrub_data && !qof_book_shutting_down (book))
+    {
+        scrub_data = 0;
+        for (node = trans_list; node; node = node->next)
+        {
+            Transaction *trans = node->data;
+            if (qof_instance_get_editlevel (trans) != 1 ||
+                    qof_instance_get_destroying (trans) ||
+                    was_trans_emptied (trans))
+                continue;
+
+            xaccTransScrubImbalance (trans, NULL, NULL);
+            if (g_getenv("GNC_AUTO_SCRUB_LOTS") != NULL)
+                xaccTransScrubGains (trans, NULL);
+        }
+    }
+
+    /* Collect the accounts after scrubbing, which may have added
+     * imbalance splits. */
+    accounts = g_hash_table_new (g_direct_hash, g_direct_equal);
+    for (node = trans_list; node; node = node->next)
+        batch_begin_accounts (node->data, accounts);
+
+    qof_event_suspend ();
+    qof_backend_begin_batch (be, book);
+
+    for (node = trans_list; node; node = node->next)
+    {
+        Transaction *trans = node->data;
+
+        /* Listeners must see these go, don't commit them silently. */
+        if (qof_instance_get_editlevel (trans) == 1 &&
+                (qof_instance_get_destroying (trans) || was_trans_emptied (trans)))
+            destroyed = g_list_prepend (destroyed, trans);
+        else
+            xaccTransCommitEdit (trans);
+    }
+
+    qof_event_resume ();
+    scrub_data = saved_scrub_data;
+
+    for (node = destroyed; node; node = node->next)
+        xaccTransCommitEdit (node->data);
+    g_list_free (destroyed);
+
+    /* Each account sorts its splits and recomputes its balance once here,
+     * and its commit sends the one modify event for the batch.  The
+     * split events were dropped while events were suspended, so tell
+     * the listeners that keep track of splits to look at all of them. */
+    g_hash_table_iter_init (&iter, accounts);
+    while (g_hash_table_iter_next (&iter, &acc, NULL))
+    {
+        xaccAccountCommitEdit (acc);
+        qof_event_gen (QOF_INSTANCE (acc), GNC_EVENT_ITEM_CHANGED, NULL);
+    }
+    g_hash_table_destroy (accounts);
+
+    qof_backend_commit_batch (be, book);
+    LEAVE ("");
+}
+
 #define SWAP(a, b) do { gpointer tmp = (a); (a) = (b); (b) = tmp; } while (0);
 
 /* Ughhh. The Rollback function is terribly complex, and, what's worse,
@@ -208,6 +208,23 @@ void          xaccTransBeginEdit (Transaction *trans);
     of xaccTransDestroy() was called on the transaction. */
 void          xaccTransCommitEdit (Transaction *trans);
 
+/** The xaccTransCommitEditBatch() method commits a list of transactions
+    from the same book, each opened with xaccTransBeginEdit(), as one unit.
+    The result is the same as calling xaccTransCommitEdit() on each of them,
+    but the scrubbing runs in one pass over the batch, each account
+    involved sorts its splits and recomputes its balance once, and the
+    backend may store the batch in a single database transaction.
+    Meant for importers and scripts that create many transactions.
+
+    Events are suspended while the transactions commit, so listeners do
+    not get the per-transaction and per-split events.  Instead each
+    account involved gets one QOF_EVENT_MODIFY followed by one
+    GNC_EVENT_ITEM_CHANGED whose event data is NULL.  Listeners keeping
+    state derived from an account's splits must treat the latter as
+    "any split of this account may have been added, changed or removed"
+    and rebuild that state. */
+void          xaccTransCommitEditBatch (GList *trans_list);
+
 /** The xaccTransRollbackEdit() routine rejects all edits made, and
     sets the transaction back to where it was before the editing
     started.  This includes restoring any deleted splits, removing
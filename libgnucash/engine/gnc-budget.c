@@ -71,8 +71,27 @@ typedef struct GncBudgetPrivate
 
     /* Number of periods */
     guint  num_periods;
+
+    /* The period values by account, read from the KVP slots one
+     * account at a time and kept in step with them by the setters.
+     * Other writers of the slots, such as a backend loading the
+     * budget, go unnoticed until the edit is committed, so committing
+     * drops the values unless the setters were the only writers. */
+    GHashTable *account_values;  /* GncGUID* -> BudgetCell[num_periods] */
+    gboolean account_values_in_step;
+
+    /* Start and end time of each period, worked out from the recurrence
+     * on first use and dropped when it or num_periods changes. */
+    time64 *period_times;  /* start, end for each of num_periods */
 } GncBudgetPrivate;
 
+/* One cached account period value */
+typedef struct
+{
+    gnc_numeric value;
+    gboolean is_set;
+} BudgetCell;
+
 #define GET_PRIVATE(o) \
     ((GncBudgetPrivate*)g_type_instance_get_private((GTypeInstance*)o, GNC_TYPE_BUDGET))
 
@@ -99,6 +118,11 @@ gnc_budget_init(GncBudget* budget)
     g_date_subtract_days(date, g_date_get_day(date) - 1);
     recurrenceSet(&priv->recurrence, 1, PERIOD_MONTH, date, WEEKEND_ADJ_NONE);
     g_date_free (date);
+
+    priv->account_values = g_hash_table_new_full (guid_hash_to_guint,
+                                                  guid_g_hash_table_equal,
+                                                  (GDestroyNotify)guid_free,
+                                                  g_free);
 }
 
 static void
@@ -110,6 +134,8 @@ gnc_budget_dispose (GObject *budgetp)
 static void
 gnc_budget_finalize(GObject* budgetp)
 {
+    g_hash_table_destroy (GET_PRIVATE(budgetp)->account_values);
+    g_free (GET_PRIVATE(budgetp)->period_times);
     G_OBJECT_CLASS(gnc_budget_parent_class)->finalize(budgetp);
 }
 
@@ -239,6 +265,7 @@ gnc_budget_class_init(GncBudgetClass* klass)
 static void commit_err (QofInstance *inst, QofBackendError errcode)
 {
     PERR ("Failed to commit: %d", errcode);
+    g_hash_table_remove_all (GET_PRIVATE(inst)->account_values);
     gnc_engine_signal_commit_error( errcode );
 }
 
@@ -278,7 +305,12 @@ gnc_budget_begin_edit(GncBudget *bgt)
 void
 gnc_budget_commit_edit(GncBudget *bgt)
 {
+    GncBudgetPrivate *priv = GET_PRIVATE(bgt);
+
     if (!qof_commit_edit(QOF_INSTANCE(bgt))) return;
+    if (!priv->account_values_in_step)
+        g_hash_table_remove_all (priv->account_values);
+    priv->account_values_in_step = FALSE;
     qof_commit_edit_part2(QOF_INSTANCE(bgt), commit_err,
                           noop, gnc_budget_free);
 }
@@ -425,6 +457,8 @@ gnc_budget_set_recurrence(GncBudget *budget, const Recurrence *r)
 
     gnc_budget_begin_edit(budget);
     priv->recurrence = *r;
+    g_free (priv->period_times);
+    priv->period_times = NULL;
     qof_instance_set_dirty(&budget->inst);
     gnc_budget_commit_edit(budget);
 
@@ -458,6 +492,9 @@ gnc_budget_set_num_periods(GncBudget* budget, guint num_periods)
 
     gnc_budget_begin_edit(budget);
     priv->num_periods = num_periods;
+    g_hash_table_remove_all (priv->account_values);
+    g_free (priv->period_times);
+    priv->period_times = NULL;
     qof_instance_set_dirty(&budget->inst);
     gnc_budget_commit_edit(budget);
 
@@ -481,6 +518,85 @@ make_period_path (const Account *account, guint period_num, char *path1, char *p
     g_sprintf (path2, "%d", period_num);
 }
 
+typedef struct
+{
+    BudgetCell *cells;
+    guint num_periods;
+} BudgetRowLoad;
+
+static void
+budget_row_load_cb (const char *key, const GValue *value, gpointer user_data)
+{
+    BudgetRowLoad *load = user_data;
+    gchar *end;
+    guint64 period_num = g_ascii_strtoull (key, &end, 10);
+    gnc_numeric *numeric;
+
+    if (end == key || *end || period_num >= load->num_periods)
+        return;
+    if (!G_VALUE_HOLDS_BOXED (value))
+        return;
+    numeric = (gnc_numeric*)g_value_get_boxed (value);
+    if (numeric == NULL)
+        return;
+    load->cells[period_num].value = *numeric;
+    load->cells[period_num].is_set = TRUE;
+}
+
+/* The cached values of all periods of the account, loaded in one pass
+ * over its KVP frame on first use.  Callers must check that the
+ * budget has at least one period. */
+static BudgetCell *
+get_account_values (const GncBudget *budget, const Account *account)
+{
+    GncBudgetPrivate *priv = GET_PRIVATE(budget);
+    const GncGUID *guid = xaccAccountGetGUID (account);
+    BudgetCell *cells = g_hash_table_lookup (priv->account_values, guid);
+    gchar guid_str [GUID_ENCODING_LENGTH + 1];
+    BudgetRowLoad load;
+    guint period_num;
+
+    if (cells)
+        return cells;
+
+    cells = g_new (BudgetCell, priv->num_periods);
+    for (period_num = 0; period_num < priv->num_periods; period_num++)
+    {
+        cells[period_num].value = gnc_numeric_zero ();
+        cells[period_num].is_set = FALSE;
+    }
+    load.cells = cells;
+    load.num_periods = priv->num_periods;
+    guid_to_string_buff (guid, guid_str);
+    qof_instance_foreach_slot (QOF_INSTANCE (budget), guid_str, NULL,
+                               budget_row_load_cb, &load);
+    g_hash_table_insert (priv->account_values, guid_copy (guid), cells);
+    return cells;
+}
+
+/* Update an already cached value after its KVP slot has been written.
+ * Accounts that are not cached yet will read the slot when first used.
+ * If the setter's edit is the only one open, nothing else can have
+ * written the slots, so its commit can keep the cached values. */
+static void
+update_account_value (GncBudget *budget, const Account *account,
+                      guint period_num, const gnc_numeric *val)
+{
+    GncBudgetPrivate *priv = GET_PRIVATE(budget);
+    BudgetCell *cells;
+
+    if (qof_instance_get_editlevel (budget) == 1)
+        priv->account_values_in_step = TRUE;
+    if (period_num >= priv->num_periods)
+        return;
+    cells = g_hash_table_lookup (priv->account_values,
+                                 xaccAccountGetGUID (account));
+    if (cells == NULL)
+        return;
+    cells[period_num].is_set = (val != NULL);
+    cells[period_num].value = val ? *val : gnc_numeric_zero ();
+}
+
 /* period_num is zero-based */
 /* What happens when account is deleted, after we have an entry for it? */
 void
@@ -496,6 +612,7 @@ gnc_budget_unset_account_period_value(GncBudget *budget, const Account *account,
 
     gnc_budget_begin_edit(budget);
     qof_instance_set_kvp (QOF_INSTANCE (budget), NULL, 2, path_part_one, path_part_two);
+    update_account_value (budget, account, period_num, NULL);
     qof_instance_set_dirty(&budget->inst);
     gnc_budget_commit_edit(budget);
 
@@ -527,13 +644,17 @@ gnc_budget_set_account_period_value(GncBudget *budget, const Account *account,
 
     gnc_budget_begin_edit(budget);
     if (gnc_numeric_check(val))
+    {
         qof_instance_set_kvp (QOF_INSTANCE (budget), NULL, 2, path_part_one, path_part_two);
+        update_account_value (budget, account, period_num, NULL);
+    }
     else
     {
         GValue v = G_VALUE_INIT;
         g_value_init (&v, GNC_TYPE_NUMERIC);
         g_value_set_boxed (&v, &val);
         qof_instance_set_kvp (QOF_INSTANCE (budget), &v, 2, path_part_one, path_part_two);
+        update_account_value (budget, account, period_num, &val);
     }
     qof_instance_set_dirty(&budget->inst);
     gnc_budget_commit_edit(budget);
@@ -558,6 +679,9 @@ gnc_budget_is_account_period_value_set(const GncBudget *budget,
     g_return_val_if_fail(GNC_IS_BUDGET(budget), FALSE);
     g_return_val_if_fail(account, FALSE);
 
+    if (period_num < GET_PRIVATE(budget)->num_periods)
+        return get_account_values (budget, account)[period_num].is_set;
+
     make_period_path (account, period_num, path_part_one, path_part_two);
     qof_instance_get_kvp (QOF_INSTANCE (budget), &v, 2, path_part_one, path_part_two);
     if (G_VALUE_HOLDS_BOXED (&v))
@@ -578,6 +702,9 @@ gnc_budget_get_account_period_value(const GncBudget *budget,
     g_return_val_if_fail(GNC_IS_BUDGET(budget), gnc_numeric_zero());
     g_return_val_if_fail(account, gnc_numeric_zero());
 
+    if (period_num < GET_PRIVATE(budget)->num_periods)
+        return get_account_values (budget, account)[period_num].value;
+
     make_period_path (account, period_num, path_part_one, path_part_two);
     qof_instance_get_kvp (QOF_INSTANCE (budget), &v, 2, path_part_one, path_part_two);
     if (G_VALUE_HOLDS_BOXED (&v))
@@ -643,17 +770,52 @@ gnc_budget_get_account_period_note(const GncBudget *budget,
     return (G_VALUE_HOLDS_STRING(&v)) ? g_value_get_string(&v) : NULL;
 }
 
+/* Returns the start and end time of the period, or NULL if it is past
+ * the budget's periods. */
+static const time64 *
+get_period_times (const GncBudget *budget, guint period_num)
+{
+    GncBudgetPrivate *priv = GET_PRIVATE(budget);
+    guint i;
+
+    if (period_num >= priv->num_periods)
+        return NULL;
+
+    if (!priv->period_times)
+    {
+        priv->period_times = g_new (time64, 2 * priv->num_periods);
+        for (i = 0; i < priv->num_periods; i++)
+        {
+            priv->period_times[2 * i] =
+                recurrenceGetPeriodTime(&priv->recurrence, i, FALSE);
+            priv->period_times[2 * i + 1] =
+                recurrenceGetPeriodTime(&priv->recurrence, i, TRUE);
+        }
+    }
+    return &priv->period_times[2 * period_num];
+}
+
 time64
 gnc_budget_get_period_start_date(const GncBudget *budget, guint period_num)
 {
+    const time64 *times;
+
     g_return_val_if_fail (GNC_IS_BUDGET(budget), 0);
+    times = get_period_times (budget, period_num);
+    if (times)
+        return times[0];
     return recurrenceGetPeriodTime(&GET_PRIVATE(budget)->recurrence, period_num, FALSE);
 }
 
 time64
 gnc_budget_get_period_end_date(const GncBudget *budget, guint period_num)
 {
+    const time64 *times;
+
     g_return_val_if_fail (GNC_IS_BUDGET(budget), 0);
+    times = get_period_times (budget, period_num);
+    if (times)
+        return times[1];
     return recurrenceGetPeriodTime(&GET_PRIVATE(budget)->recurrence, period_num, TRUE);
 }
 
@@ -661,8 +823,14 @@ gnc_numeric
 gnc_budget_get_account_period_actual_value(
     const GncBudget *budget, Account *acc, guint period_num)
 {
+    const time64 *times;
+
     // FIXME: maybe zero is not best error return val.
     g_return_val_if_fail(GNC_IS_BUDGET(budget) && acc, gnc_numeric_zero());
+    times = get_period_times (budget, period_num);
+    if (times)
+        return xaccAccountGetNoclosingBalanceChangeForPeriod (acc, times[0],
+                                                               times[1], TRUE);
     return recurrenceGetAccountPeriodValue(&GET_PRIVATE(budget)->recurrence,
                                            acc, period_num);
 }
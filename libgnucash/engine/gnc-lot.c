@@ -52,6 +52,7 @@
 #include "cap-gains.h"
 #include "Transaction.h"
 #include "TransactionP.h"
+#include "gncOwnerP.h"
 
 /* This static indicates the debugging module that this .o belongs to.  */
 static QofLogModule log_module = GNC_MOD_LOT;
@@ -187,14 +188,20 @@ gnc_lot_set_property (GObject* object,
     case PROP_MARKER:
         priv->marker = g_value_get_int(value);
         break;
+    /* These decide the lot's owner.  Update the owner lot index right
+     * away: a new lot isn't in it yet, and with events suspended nothing
+     * else would tell it before the lot is committed. */
     case PROP_INVOICE:
         qof_instance_set_kvp (QOF_INSTANCE (lot), value, 2, GNC_INVOICE_ID, GNC_INVOICE_GUID);
+        gncOwnerLotIndexUpdate (lot);
         break;
     case PROP_OWNER_TYPE:
         qof_instance_set_kvp (QOF_INSTANCE (lot), value, 2, GNC_OWNER_ID, GNC_OWNER_TYPE);
+        gncOwnerLotIndexUpdate (lot);
         break;
     case PROP_OWNER_GUID:
         qof_instance_set_kvp (QOF_INSTANCE (lot), value, 2, GNC_OWNER_ID, GNC_OWNER_GUID);
+        gncOwnerLotIndexUpdate (lot);
         break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
@@ -294,6 +301,7 @@ gnc_lot_free(GNCLot* lot)
 
     priv->account = NULL;
     priv->is_closed = TRUE;
+    gncOwnerLotIndexRemove (lot);
     /* qof_instance_release (&lot->inst); */
     g_object_unref (lot);
 
@@ -331,13 +339,16 @@ static void lot_free(QofInstance* inst)
     gnc_lot_free(lot);
 }
 
-static void noop (QofInstance *inst) {}
+static void lot_done (QofInstance *inst)
+{
+    gncOwnerLotIndexUpdate (GNC_LOT(inst));
+}
 
 void
 gnc_lot_commit_edit (GNCLot *lot)
 {
     if (!qof_commit_edit (QOF_INSTANCE(lot))) return;
-    qof_commit_edit_part2 (QOF_INSTANCE(lot), commit_err, noop, lot_free);
+    qof_commit_edit_part2 (QOF_INSTANCE(lot), commit_err, lot_done, lot_free);
 }
 
 /* ============================================================= */
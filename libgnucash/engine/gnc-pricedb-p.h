@@ -58,6 +58,7 @@ struct gnc_price_db_s
     GHashTable *commodity_hash;
     gboolean bulk_update;		 /* TRUE while reading XML file, etc. */
     gboolean reset_nth_price_cache;
+    gint64 generation;           /* bumped whenever a price changes */
 };
 
 struct _GncPriceDBClass
@@ -96,4 +97,8 @@ gboolean gnc_pricedb_register (void);
 
 QofBackend * xaccPriceDBGetBackend (GNCPriceDB *prdb);
 
+/** A counter that changes whenever a price is added, removed or
+ * modified, for caches of converted values. */
+gint64 gnc_pricedb_get_generation (const GNCPriceDB *db);
+
 #endif
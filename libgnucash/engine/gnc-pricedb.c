@@ -436,6 +436,8 @@ void
 gnc_price_commit_edit (GNCPrice *p)
 {
     if (!qof_commit_edit (QOF_INSTANCE(p))) return;
+    if (p->db)
+        p->db->generation++;
     qof_commit_edit_part2 (&p->inst, commit_err, noop, noop);
 }
 
@@ -840,6 +842,13 @@ static void
 gnc_pricedb_init(GNCPriceDB* pdb)
 {
     pdb->reset_nth_price_cache = FALSE;
+    pdb->generation = 0;
+}
+
+gint64
+gnc_pricedb_get_generation (const GNCPriceDB *db)
+{
+    return db ? db->generation : 0;
 }
 
 static void
@@ -1146,6 +1155,7 @@ add_price(GNCPriceDB *db, GNCPrice *p)
 
     g_hash_table_insert(currency_hash, currency, price_list);
     p->db = db;
+    db->generation++;
 
     qof_event_gen (&p->inst, QOF_EVENT_ADD, NULL);
 
@@ -1201,6 +1211,7 @@ remove_price(GNCPriceDB *db, GNCPrice *p, gboolean cleanup)
     GHashTable *currency_hash;
 
     if (!db || !p) return FALSE;
+    db->generation++;
     ENTER ("db=%p, pr=%p dirty=%d destroying=%d",
            db, p, qof_instance_get_dirty_flag(p),
            qof_instance_get_destroying(p));
@@ -1785,9 +1796,10 @@ pricedb_get_prices_internal(GNCPriceDB *db, const gnc_commodity *commodity,
     return forward_list;
 }
 
-GNCPrice *gnc_pricedb_lookup_latest(GNCPriceDB *db,
-                          const gnc_commodity *commodity,
-                          const gnc_commodity *currency)
+static GNCPrice *
+lookup_latest(GNCPriceDB *db,
+              const gnc_commodity *commodity,
+              const gnc_commodity *currency)
 {
     GList *price_list;
     GNCPrice *result;
@@ -1807,6 +1819,16 @@ GNCPrice *gnc_pricedb_lookup_latest(GNCPriceDB *db,
     return result;
 }
 
+GNCPrice *gnc_pricedb_lookup_latest(GNCPriceDB *db,
+                          const gnc_commodity *commodity,
+                          const gnc_commodity *currency)
+{
+    QOF_TIMER_START (start);
+    GNCPrice *result = lookup_latest (db, commodity, currency);
+    QOF_TIMER_STOP (start, "pricedb.lookup-latest");
+    return result;
+}
+
 typedef struct
 {
     GList **list;
@@ -2246,14 +2268,17 @@ gnc_pricedb_lookup_day_t64(GNCPriceDB *db,
                            const gnc_commodity *currency,
                            time64 t)
 {
-    return lookup_nearest_in_time(db, c, currency, t, TRUE);
+    QOF_TIMER_START (start);
+    GNCPrice *result = lookup_nearest_in_time(db, c, currency, t, TRUE);
+    QOF_TIMER_STOP (start, "pricedb.lookup-day");
+    return result;
 }
 
-GNCPrice *
-gnc_pricedb_lookup_at_time64(GNCPriceDB *db,
-                             const gnc_commodity *c,
-                             const gnc_commodity *currency,
-                             time64 t)
+static GNCPrice *
+lookup_at_time(GNCPriceDB *db,
+               const gnc_commodity *c,
+               const gnc_commodity *currency,
+               time64 t)
 {
     GList *price_list;
     GList *item = NULL;
@@ -2280,6 +2305,18 @@ gnc_pricedb_lookup_at_time64(GNCPriceDB *db,
     return NULL;
 }
 
+GNCPrice *
+gnc_pricedb_lookup_at_time64(GNCPriceDB *db,
+                             const gnc_commodity *c,
+                             const gnc_commodity *currency,
+                             time64 t)
+{
+    QOF_TIMER_START (start);
+    GNCPrice *result = lookup_at_time (db, c, currency, t);
+    QOF_TIMER_STOP (start, "pricedb.lookup-at-time");
+    return result;
+}
+
 static GNCPrice *
 lookup_nearest_in_time(GNCPriceDB *db,
                        const gnc_commodity *c,
@@ -2399,15 +2436,18 @@ gnc_pricedb_lookup_nearest_in_time64(GNCPriceDB *db,
                                      const gnc_commodity *currency,
                                      time64 t)
 {
-    return lookup_nearest_in_time(db, c, currency, t, FALSE);
+    QOF_TIMER_START (start);
+    GNCPrice *result = lookup_nearest_in_time(db, c, currency, t, FALSE);
+    QOF_TIMER_STOP (start, "pricedb.lookup-nearest-in-time");
+    return result;
 }
 
 
-GNCPrice *
-gnc_pricedb_lookup_latest_before_t64 (GNCPriceDB *db,
-                                      gnc_commodity *c,
-                                      gnc_commodity *currency,
-                                      time64 t)
+static GNCPrice *
+lookup_latest_before (GNCPriceDB *db,
+                      gnc_commodity *c,
+                      gnc_commodity *currency,
+                      time64 t)
 {
     GList *price_list;
     GNCPrice *current_price = NULL;
@@ -2435,6 +2475,18 @@ gnc_pricedb_lookup_latest_before_t64 (GNCPriceDB *db,
     return current_price;
 }
 
+GNCPrice *
+gnc_pricedb_lookup_latest_before_t64 (GNCPriceDB *db,
+                                      gnc_commodity *c,
+                                      gnc_commodity *currency,
+                                      time64 t)
+{
+    QOF_TIMER_START (start);
+    GNCPrice *result = lookup_latest_before (db, c, currency, t);
+    QOF_TIMER_STOP (start, "pricedb.lookup-latest-before");
+    return result;
+}
+
 static gnc_numeric
 direct_balance_conversion (GNCPriceDB *db, gnc_numeric bal,
                            const gnc_commodity *from, const gnc_commodity *to,
@@ -1228,6 +1228,7 @@ gncInvoiceDetachFromLot (GNCLot *lot)
     gnc_lot_begin_edit (lot);
     qof_instance_set (QOF_INSTANCE (lot), "invoice", NULL, NULL);
     gnc_lot_commit_edit (lot);
+    gncOwnerLotIndexUpdate (lot);
 }
 
 void
@@ -1243,6 +1244,7 @@ gncInvoiceAttachToLot (GncInvoice *invoice, GNCLot *lot)
     qof_instance_set (QOF_INSTANCE (lot), "invoice", guid, NULL);
     gnc_lot_commit_edit (lot);
     gncInvoiceSetPostedLot (invoice, lot);
+    gncOwnerLotIndexUpdate (lot);
 }
 
 GncInvoice * gncInvoiceGetInvoiceFromLot (GNCLot *lot)
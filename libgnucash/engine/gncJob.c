@@ -357,6 +357,8 @@ void gncJobSetOwner (GncJob *job, GncOwner *owner)
     }
 
     gncOwnerCopy (owner, &(job->owner));
+    /* Lots of this job now belong to another end owner */
+    gncOwnerLotIndexInvalidate (qof_instance_get_book (job));
 
     switch (gncOwnerGetType (&(job->owner)))
     {
@@ -632,6 +632,7 @@ void gncOwnerAttachToLot (const GncOwner *owner, GNCLot *lot)
 		      GNC_OWNER_GUID, gncOwnerGetGUID (owner),
 		      NULL);
     gnc_lot_commit_edit (lot);
+    gncOwnerLotIndexUpdate (lot);
 }
 
 gboolean gncOwnerGetOwnerFromLot (GNCLot *lot, GncOwner *owner)
@@ -703,26 +704,42 @@ gboolean gncOwnerIsValid (const GncOwner *owner)
     return (owner->owner.undefined != NULL);
 }
 
-gboolean
-gncOwnerLotMatchOwnerFunc (GNCLot *lot, gpointer user_data)
+/* Determine the end owner associated to the lot, either via the invoice
+ * posted to it or via the owner attached to a pre-payment lot. */
+static gboolean
+owner_get_end_owner_from_lot (GNCLot *lot, GncOwner *end_owner)
 {
-    const GncOwner *req_owner = user_data;
     GncOwner lot_owner;
-    const GncOwner *end_owner;
+    const GncOwner *owner;
     GncInvoice *invoice = gncInvoiceGetInvoiceFromLot (lot);
 
-    /* Determine the owner associated to the lot */
     if (invoice)
         /* Invoice lots */
-        end_owner = gncOwnerGetEndOwner (gncInvoiceGetOwner (invoice));
+        owner = gncOwnerGetEndOwner (gncInvoiceGetOwner (invoice));
     else if (gncOwnerGetOwnerFromLot (lot, &lot_owner))
         /* Pre-payment lots */
-        end_owner = gncOwnerGetEndOwner (&lot_owner);
+        owner = gncOwnerGetEndOwner (&lot_owner);
     else
         return FALSE;
 
+    if (!gncOwnerIsValid (owner))
+        return FALSE;
+
+    gncOwnerCopy (owner, end_owner);
+    return TRUE;
+}
+
+gboolean
+gncOwnerLotMatchOwnerFunc (GNCLot *lot, gpointer user_data)
+{
+    const GncOwner *req_owner = user_data;
+    GncOwner end_owner;
+
+    if (!owner_get_end_owner_from_lot (lot, &end_owner))
+        return FALSE;
+
     /* Is this a lot for the requested owner ? */
-    return gncOwnerEqual (end_owner, req_owner);
+    return gncOwnerEqual (&end_owner, req_owner);
 }
 
 gint
@@ -1466,9 +1483,286 @@ gncOwnerGetCommoditiesList (const GncOwner *owner)
     return (g_list_prepend (NULL, gncOwnerGetCurrency(owner)));
 }
 
+/*********************************************************************/
+/* Owner to lot index                                                */
+
+/* Finding the lots of an owner used to require a scan over all lots in
+ * all business accounts, reading the owner kvp of each.  Instead the
+ * engine keeps a per-book index mapping each end owner to its lots.
+ * The index is built lazily on first use and is kept up to date when
+ * an owner or invoice is attached to (or detached from) a lot, and when
+ * lots are destroyed.  Changes to jobs (which may move to another owner)
+ * simply invalidate the index so it gets rebuilt on next use.
+ *
+ * Events are dropped while they are suspended (e.g. during imports or
+ * batch commits), so the index doesn't rely on them alone: gnc-lot.c
+ * updates it directly when a lot's owner or invoice is set and when a
+ * lot is committed or freed, and gncJobSetOwner invalidates it.  A new
+ * lot has no owner, so creating one leaves the index alone.  The event
+ * handler only catches what is left.
+ */
+#define GNC_OWNER_LOT_INDEX "gncOwnerLotIndex"
+
+typedef struct
+{
+    GncGUID guid;     /* GUID of the end owner, used as hash key */
+    GncOwner owner;   /* The end owner itself */
+    GList *lots;      /* All lots linked to this owner */
+} OwnerLots;
+
+typedef struct
+{
+    GHashTable *owner_lots;   /* GncGUID* -> OwnerLots* */
+    GHashTable *lot_owners;   /* GNCLot* -> OwnerLots* */
+    gboolean built;
+} OwnerLotIndex;
+
+static gint owner_qof_event_handler_id = 0;
+
+static void
+owner_lots_free (gpointer data)
+{
+    OwnerLots *ol = data;
+    g_list_free (ol->lots);
+    g_free (ol);
+}
+
+static void
+owner_lot_index_clear (OwnerLotIndex *idx)
+{
+    g_hash_table_remove_all (idx->lot_owners);
+    g_hash_table_remove_all (idx->owner_lots);
+    idx->built = FALSE;
+}
+
+static void
+owner_lot_index_free (QofBook *book, gpointer key, gpointer user_data)
+{
+    OwnerLotIndex *idx = user_data;
+
+    if (!idx) return;
+    g_hash_table_destroy (idx->lot_owners);
+    g_hash_table_destroy (idx->owner_lots);
+    g_free (idx);
+    qof_book_set_data (book, GNC_OWNER_LOT_INDEX, NULL);
+}
+
+static void
+owner_lot_index_remove_lot (OwnerLotIndex *idx, GNCLot *lot)
+{
+    OwnerLots *ol = g_hash_table_lookup (idx->lot_owners, lot);
+
+    if (!ol) return;
+    ol->lots = g_list_remove (ol->lots, lot);
+    g_hash_table_remove (idx->lot_owners, lot);
+}
+
+static void
+owner_lot_index_add_lot (OwnerLotIndex *idx, GNCLot *lot,
+                         const GncOwner *end_owner)
+{
+    const GncGUID *guid = gncOwnerGetGUID (end_owner);
+    OwnerLots *ol = g_hash_table_lookup (idx->owner_lots, guid);
+
+    if (!ol)
+    {
+        ol = g_new0 (OwnerLots, 1);
+        ol->guid = *guid;
+        gncOwnerCopy (end_owner, &ol->owner);
+        g_hash_table_insert (idx->owner_lots, &ol->guid, ol);
+    }
+    ol->lots = g_list_prepend (ol->lots, lot);
+    g_hash_table_insert (idx->lot_owners, lot, ol);
+}
+
+static void
+owner_lot_index_add_lot_cb (QofInstance *inst, gpointer user_data)
+{
+    GncOwner end_owner;
+
+    if (owner_get_end_owner_from_lot (GNC_LOT (inst), &end_owner))
+        owner_lot_index_add_lot (user_data, GNC_LOT (inst), &end_owner);
+}
+
+/* Returns the book's owner lot index, building it if needed.
+ * If build is FALSE only an already built index is returned. */
+static OwnerLotIndex *
+owner_lot_index_lookup (QofBook *book, gboolean build)
+{
+    OwnerLotIndex *idx;
+
+    if (!book || qof_book_shutting_down (book))
+        return NULL;
+
+    idx = qof_book_get_data (book, GNC_OWNER_LOT_INDEX);
+    if (!idx)
+    {
+        if (!build)
+            return NULL;
+        idx = g_new0 (OwnerLotIndex, 1);
+        idx->owner_lots = g_hash_table_new_full (guid_hash_to_guint,
+                                                 guid_g_hash_table_equal,
+                                                 NULL, owner_lots_free);
+        idx->lot_owners = g_hash_table_new (g_direct_hash, g_direct_equal);
+        qof_book_set_data_fin (book, GNC_OWNER_LOT_INDEX, idx,
+                               owner_lot_index_free);
+    }
+
+    if (!idx->built)
+    {
+        if (!build)
+            return NULL;
+        ENTER ("(book=%p)", book);
+        qof_collection_foreach (qof_book_get_collection (book, GNC_ID_LOT),
+                                owner_lot_index_add_lot_cb, idx);
+        idx->built = TRUE;
+        LEAVE ("%u owners", g_hash_table_size (idx->owner_lots));
+    }
+
+    return idx;
+}
+
+void
+gncOwnerLotIndexUpdate (GNCLot *lot)
+{
+    OwnerLotIndex *idx;
+    GncOwner end_owner;
+
+    if (!lot) return;
+
+    idx = owner_lot_index_lookup (gnc_lot_get_book (lot), FALSE);
+    if (!idx) return;
+
+    if (!qof_instance_get_destroying (lot) &&
+        owner_get_end_owner_from_lot (lot, &end_owner))
+    {
+        OwnerLots *ol = g_hash_table_lookup (idx->lot_owners, lot);
+
+        /* Nothing to do if the lot's owner didn't change */
+        if (ol && gncOwnerEqual (&ol->owner, &end_owner))
+            return;
+        owner_lot_index_remove_lot (idx, lot);
+        owner_lot_index_add_lot (idx, lot, &end_owner);
+    }
+    else
+        owner_lot_index_remove_lot (idx, lot);
+}
+
+void
+gncOwnerLotIndexRemove (GNCLot *lot)
+{
+    OwnerLotIndex *idx;
+
+    if (!lot) return;
+
+    idx = owner_lot_index_lookup (gnc_lot_get_book (lot), FALSE);
+    if (idx)
+        owner_lot_index_remove_lot (idx, lot);
+}
+
+void
+gncOwnerLotIndexInvalidate (QofBook *book)
+{
+    OwnerLotIndex *idx;
+
+    if (!book) return;
+
+    idx = qof_book_get_data (book, GNC_OWNER_LOT_INDEX);
+    if (idx && idx->built)
+        owner_lot_index_clear (idx);
+}
+
+static void
+owner_handle_qof_events (QofInstance *entity, QofEventId event_type,
+                         gpointer user_data, gpointer event_data)
+{
+    OwnerLotIndex *idx;
+
+    if (GNC_IS_LOT (entity))
+    {
+        if (event_type & QOF_EVENT_DESTROY)
+        {
+            idx = owner_lot_index_lookup (qof_instance_get_book (entity), FALSE);
+            if (idx)
+                owner_lot_index_remove_lot (idx, GNC_LOT (entity));
+        }
+        else if (event_type & QOF_EVENT_MODIFY)
+            gncOwnerLotIndexUpdate (GNC_LOT (entity));
+        return;
+    }
+
+    /* A job may have been moved to another owner */
+    if (GNC_IS_JOB (entity) && (event_type & QOF_EVENT_MODIFY))
+    {
+        idx = owner_lot_index_lookup (qof_instance_get_book (entity), FALSE);
+        if (idx)
+            owner_lot_index_clear (idx);
+    }
+}
+
+GList *
+gncOwnerGetLots (const GncOwner *owner)
+{
+    OwnerLotIndex *idx;
+    OwnerLots *ol;
+    const GncGUID *guid;
+
+    g_return_val_if_fail (owner, NULL);
+
+    if (!gncOwnerIsValid (owner))
+        return NULL;
+
+    idx = owner_lot_index_lookup (qof_instance_get_book (qofOwnerGetOwner (owner)),
+                                  TRUE);
+    guid = gncOwnerGetGUID (owner);
+    if (!idx || !guid)
+        return NULL;
+
+    ol = g_hash_table_lookup (idx->owner_lots, guid);
+    return ol ? g_list_copy (ol->lots) : NULL;
+}
+
 /*********************************************************************/
 /* Owner balance calculation routines                                */
 
+/* Sum the balances of the open invoice lots in lot_list that live in
+ * business accounts of the owner's currency.  Frees lot_list. */
+static gnc_numeric
+owner_compute_balance (const GncOwner *owner, GList *lot_list)
+{
+    gnc_numeric balance = gnc_numeric_zero ();
+    gnc_commodity *owner_currency = gncOwnerGetCurrency (owner);
+    GList *acct_types = gncOwnerGetAccountTypesList (owner);
+    GList *lot_node;
+
+    for (lot_node = lot_list; lot_node; lot_node = lot_node->next)
+    {
+        GNCLot *lot = lot_node->data;
+        Account *account = gnc_lot_get_account (lot);
+
+        /* Check if this lot is in an account that can have lots for
+         * the owner, otherwise skip to next */
+        if (!account ||
+            g_list_index (acct_types, (gpointer)xaccAccountGetType (account)) == -1)
+            continue;
+
+        if (!gnc_commodity_equal (owner_currency, xaccAccountGetCommodity (account)))
+            continue;
+
+        if (gnc_lot_is_closed (lot))
+            continue;
+
+        if (gncInvoiceGetInvoiceFromLot (lot))
+            balance = gnc_numeric_add (balance, gnc_lot_get_balance (lot),
+                                       gnc_commodity_get_fraction (owner_currency),
+                                       GNC_HOW_RND_ROUND_HALF_UP);
+    }
+    g_list_free (lot_list);
+    g_list_free (acct_types);
+
+    return balance;
+}
+
 /*
  * Given an owner, extract the open balance from the owner and then
  * convert it to the desired currency.
@@ -1494,43 +1788,7 @@ gncOwnerGetBalanceInCurrency (const GncOwner *owner,
     else
     {
         /* No valid cache value found for balance. Let's recalculate */
-        GList *acct_list  = gnc_account_get_descendants (gnc_book_get_root_account (book));
-        GList *acct_types = gncOwnerGetAccountTypesList (owner);
-        GList *acct_node;
-
-        /* For each account */
-        for (acct_node = acct_list; acct_node; acct_node = acct_node->next)
-        {
-            Account *account = acct_node->data;
-            GList *lot_list = NULL, *lot_node;
-
-            /* Check if this account can have lots for the owner, otherwise skip to next */
-            if (g_list_index (acct_types, (gpointer)xaccAccountGetType (account))
-                    == -1)
-                continue;
-
-
-            if (!gnc_commodity_equal (owner_currency, xaccAccountGetCommodity (account)))
-                continue;
-
-            /* Get a list of open lots for this owner and account */
-            lot_list = xaccAccountFindOpenLots (account, gncOwnerLotMatchOwnerFunc,
-                                                (gpointer)owner, NULL);
-            /* For each lot */
-            for (lot_node = lot_list; lot_node; lot_node = lot_node->next)
-            {
-                GNCLot *lot = lot_node->data;
-                gnc_numeric lot_balance = gnc_lot_get_balance (lot);
-                GncInvoice *invoice = gncInvoiceGetInvoiceFromLot(lot);
-                if (invoice)
-                balance = gnc_numeric_add (balance, lot_balance,
-                                            gnc_commodity_get_fraction (owner_currency), GNC_HOW_RND_ROUND_HALF_UP);
-            }
-            g_list_free (lot_list);
-        }
-        g_list_free (acct_list);
-        g_list_free (acct_types);
-
+        balance = owner_compute_balance (owner, gncOwnerGetLots (owner));
         gncOwnerSetCachedBalance (owner, &balance);
     }
 
@@ -1544,6 +1802,61 @@ gncOwnerGetBalanceInCurrency (const GncOwner *owner,
 }
 
 
+GHashTable *
+gncOwnerGetBalancesInCurrency (QofBook *book, GncOwnerType owner_type,
+                               const gnc_commodity *report_currency)
+{
+    GHashTable *balances;
+    OwnerLotIndex *idx;
+    GHashTableIter iter;
+    gpointer value;
+    GNCPriceDB *pdb;
+
+    g_return_val_if_fail (book, NULL);
+
+    balances = g_hash_table_new_full (guid_hash_to_guint, guid_g_hash_table_equal,
+                                      NULL, g_free);
+    idx = owner_lot_index_lookup (book, TRUE);
+    if (!idx)
+        return balances;
+
+    ENTER ("(book=%p, type=%d)", book, owner_type);
+    pdb = gnc_pricedb_get_db (book);
+    g_hash_table_iter_init (&iter, idx->owner_lots);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+        OwnerLots *ol = value;
+        const gnc_numeric *cached_balance;
+        gnc_numeric *balance;
+
+        if (owner_type != GNC_OWNER_NONE &&
+            gncOwnerGetType (&ol->owner) != owner_type)
+            continue;
+
+        balance = g_new0 (gnc_numeric, 1);
+        cached_balance = gncOwnerGetCachedBalance (&ol->owner);
+        if (cached_balance)
+            *balance = *cached_balance;
+        else
+        {
+            *balance = owner_compute_balance (&ol->owner, g_list_copy (ol->lots));
+            gncOwnerSetCachedBalance (&ol->owner, balance);
+        }
+
+        if (report_currency)
+            *balance = gnc_pricedb_convert_balance_latest_price (
+                           pdb, *balance, gncOwnerGetCurrency (&ol->owner),
+                           report_currency);
+
+        g_hash_table_insert (balances,
+                             (gpointer)gncOwnerGetGUID (&ol->owner), balance);
+    }
+    LEAVE ("%u balances", g_hash_table_size (balances));
+
+    return balances;
+}
+
+
 /* XXX: Yea, this is broken, but it should work fine for Queries.
  * We're single-threaded, right?
  */
@@ -1621,6 +1934,9 @@ gboolean gncOwnerRegister (void)
     qof_class_register (GNC_ID_OWNER, (QofSortFunc)gncOwnerCompare, params);
     reg_lot ();
 
+    if (owner_qof_event_handler_id == 0)
+        owner_qof_event_handler_id = qof_event_register_handler (owner_handle_qof_events, NULL);
+
     return TRUE;
 }
 
@@ -316,6 +316,32 @@ gnc_numeric
 gncOwnerGetBalanceInCurrency (const GncOwner *owner,
                               const gnc_commodity *report_currency);
 
+/** Returns a newly allocated list of all lots linked to the given owner,
+ *  either as invoice lots or as pre-payment lots. The lookup is served
+ *  from an engine maintained index, so its cost only depends on the
+ *  number of lots of this owner.  Only end owners (customers, vendors
+ *  and employees) have lots in the index, for jobs an empty list is
+ *  returned. The caller must free the list (but not the lots).
+ */
+GList * gncOwnerGetLots (const GncOwner *owner);
+
+/** Compute the open balances of all owners in the book in one go.
+ *
+ *  @param book The book to compute the balances for
+ *  @param owner_type Only include owners of this type, or all owners
+ *  if GNC_OWNER_NONE is passed
+ *  @param report_currency If not NULL, convert the balances to this
+ *  currency using the latest available prices
+ *
+ *  @return A GHashTable mapping owner GncGUID* to gnc_numeric* balances.
+ *  Owners without any lots are not included and have a zero balance.
+ *  The keys belong to the owners, the caller must destroy the table
+ *  with g_hash_table_destroy.
+ */
+GHashTable *
+gncOwnerGetBalancesInCurrency (QofBook *book, GncOwnerType owner_type,
+                               const gnc_commodity *report_currency);
+
 #define OWNER_TYPE        "type"
 #define OWNER_TYPE_STRING "type-string"  /**< Allows the type to be handled externally. */
 #define OWNER_CUSTOMER    "customer"
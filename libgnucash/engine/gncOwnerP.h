@@ -33,6 +33,16 @@
 gboolean gncOwnerRegister (void);
 const gnc_numeric *gncOwnerGetCachedBalance (const GncOwner *owner);
 void gncOwnerSetCachedBalance (const GncOwner *owner, const gnc_numeric *new_bal);
+/** Refresh the owner to lot index entry for this lot. Must be called
+ *  whenever the owner or invoice attached to a lot changes; the lot's
+ *  property setters and its commit do. */
+void gncOwnerLotIndexUpdate (GNCLot *lot);
+/** Drop the lot from the owner to lot index.  Called when the lot is
+ *  freed, whether or not events are suspended. */
+void gncOwnerLotIndexRemove (GNCLot *lot);
+/** Throw away the book's owner to lot index so it gets rebuilt on next
+ *  use.  Called when a job changes owner. */
+void gncOwnerLotIndexInvalidate (QofBook *book);
 
 
 #endif /* GNC_OWNERP_H_ */
@@ -162,6 +162,20 @@ qof_backend_rollback_instance (QofBackend* qof_be, QofInstance* inst)
     ((QofBackend*)qof_be)->rollback(inst);
 }
 
+void
+qof_backend_begin_batch (QofBackend* qof_be, QofBook* book)
+{
+    if (qof_be == nullptr) return;
+    ((QofBackend*)qof_be)->begin_batch(book);
+}
+
+void
+qof_backend_commit_batch (QofBackend* qof_be, QofBook* book)
+{
+    if (qof_be == nullptr) return;
+    ((QofBackend*)qof_be)->commit_batch(book);
+}
+
 gboolean
 qof_load_backend_library (const char *directory, const char* module_name)
 {
@@ -240,6 +240,15 @@ public:
  *    Revert changes in the engine and unlock the backend.
  */
     virtual void rollback(QofInstance*) {}
+/**
+ *    Called before the engine commits a batch of instances together. A
+ *    backend may group the commits up to commit_batch into a single unit.
+ */
+    virtual void begin_batch(QofBook*) {}
+/**
+ *    Called after the last commit of a batch started with begin_batch.
+ */
+    virtual void commit_batch(QofBook*) {}
 /**
  *    Synchronizes the engine contents to the backend.
  *    This should done by using version numbers (hack alert -- the engine
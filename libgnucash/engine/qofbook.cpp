@@ -141,6 +141,7 @@ qof_book_init (QofBook *book)
     book->read_only = FALSE;
     book->session_dirty = FALSE;
     book->version = 0;
+    book->generation = 0;
     book->cached_num_field_source_isvalid = FALSE;
     book->cached_num_days_autoreadonly_isvalid = FALSE;
 
@@ -506,6 +507,20 @@ qof_book_get_session_dirty_time (const QofBook *book)
     return book->dirty_time;
 }
 
+gint64
+qof_book_get_generation (const QofBook *book)
+{
+    g_return_val_if_fail (book, 0);
+    return g_atomic_int_get (&book->generation);
+}
+
+void
+qof_book_bump_generation (QofBook *book)
+{
+    if (book)
+        g_atomic_int_inc (&book->generation);
+}
+
 void
 qof_book_set_dirty_cb(QofBook *book, QofBookDirtyCB cb, gpointer user_data)
 {
@@ -647,6 +662,36 @@ qof_book_foreach_collection (const QofBook *book,
     g_hash_table_foreach (book->hash_of_collections, foreach_cb, &iter);
 }
 
+static void
+memory_usage_cb (QofCollection *col, gpointer data)
+{
+    auto list = static_cast<GList**>(data);
+    auto usage = g_new (QofBookMemoryUsage, 1);
+
+    usage->type = qof_collection_get_type (col);
+    usage->count = qof_collection_count (col);
+    usage->bytes = usage->count * qof_collection_get_instance_size (col);
+    *list = g_list_prepend (*list, usage);
+}
+
+static gint
+memory_usage_cmp (gconstpointer a, gconstpointer b)
+{
+    return g_strcmp0 (static_cast<const QofBookMemoryUsage*>(a)->type,
+                      static_cast<const QofBookMemoryUsage*>(b)->type);
+}
+
+GList *
+qof_book_get_memory_usage (const QofBook *book)
+{
+    GList *usage = NULL;
+
+    g_return_val_if_fail (book, NULL);
+
+    qof_book_foreach_collection (book, memory_usage_cb, &usage);
+    return g_list_sort (usage, memory_usage_cmp);
+}
+
 /* ====================================================================== */
 
 void qof_book_mark_closed (QofBook *book)
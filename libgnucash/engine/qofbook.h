@@ -161,6 +161,11 @@ struct _QofBook
     gint cached_num_days_autoreadonly;
     /* Whether the above cached value is valid. */
     gboolean cached_num_days_autoreadonly_isvalid;
+
+    /* Change counter, incremented for every engine event on an object
+     * in this book. Only accessed atomically, events may be generated
+     * on other threads than the GUI thread. See qof_book_get_generation. */
+    gint generation;
 };
 
 struct _QofBookClass
@@ -234,6 +239,22 @@ QofCollection  * qof_book_get_collection (const QofBook *, QofIdType);
 typedef void (*QofCollectionForeachCB) (QofCollection *, gpointer user_data);
 void qof_book_foreach_collection (const QofBook *, QofCollectionForeachCB, gpointer);
 
+/** The memory taken by the entities of one type in a book. */
+typedef struct
+{
+    QofIdTypeConst type;        /**< The entity type */
+    guint count;                /**< The number of entities */
+    gsize bytes;                /**< The bytes they take */
+} QofBookMemoryUsage;
+
+/** Report the memory taken by each type of entity in the book, as a
+ *  GList of newly allocated QofBookMemoryUsage sorted by type.  Free it
+ *  with g_list_free_full (list, g_free).  The objects, their private
+ *  data and their KVP frame objects are counted.  The heap blocks they
+ *  own are not: sizeof (KvpFrame) excludes the nodes of the frame's
+ *  slot map, and split lists and shared cached strings are left out. */
+GList * qof_book_get_memory_usage (const QofBook *book);
+
 /** The qof_book_set_data() allows arbitrary pointers to structs
  *    to be stored in QofBook. This is the "preferred" method for
  *    extending QofBook to hold new data types.  This is also
@@ -341,6 +362,16 @@ void qof_book_mark_session_dirty(QofBook *book);
 /** Retrieve the earliest modification time on the book. */
 time64 qof_book_get_session_dirty_time(const QofBook *book);
 
+/** Retrieve the book's change generation. The generation is incremented
+ *  whenever an engine event is generated for an object in the book (even
+ *  while events are suspended), so anything derived from the book's
+ *  contents can remember the generation it was computed at and stays
+ *  valid as long as the generation is unchanged. The counter is updated
+ *  atomically, so it is safe to read and bump from any thread. It wraps
+ *  around, only compare generations for equality.
+ */
+gint64 qof_book_get_generation(const QofBook *book);
+
 /** Set the function to call when a book transitions from clean to
  *    dirty, or vice versa.
  */
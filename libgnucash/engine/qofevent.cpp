@@ -30,6 +30,7 @@ extern "C"
 
 #include "qof.h"
 #include "qofevent-p.h"
+#include "qofbook-p.h"
 
 /* Static Variables ************************************************/
 static guint   suspend_counter   = 0;
@@ -221,12 +222,20 @@ qof_event_generate_internal (QofInstance *entity, QofEventId event_id,
     }
 }
 
+static void
+qof_event_bump_book_generation (QofInstance *entity)
+{
+    if (QOF_IS_INSTANCE (entity))
+        qof_book_bump_generation (qof_instance_get_book (entity));
+}
+
 void
 qof_event_force (QofInstance *entity, QofEventId event_id, gpointer event_data)
 {
     if (!entity)
         return;
 
+    qof_event_bump_book_generation (entity);
     qof_event_generate_internal (entity, event_id, event_data);
 }
 
@@ -236,6 +245,9 @@ qof_event_gen (QofInstance *entity, QofEventId event_id, gpointer event_data)
     if (!entity)
         return;
 
+    /* The book changed even if nobody is told about it right now */
+    qof_event_bump_book_generation (entity);
+
     if (suspend_counter)
         return;
 
@@ -51,6 +51,12 @@ void qof_collection_mark_clean (QofCollection *);
 void qof_collection_mark_dirty (QofCollection *);
 void qof_collection_print_dirty (const QofCollection *col, gpointer dummy);
 
+/** Return the bytes taken by each entity in the collection: the object
+ *  with its private data and sizeof (KvpFrame).  That excludes the heap
+ *  nodes of the frame's slot map, the slots themselves and any cached
+ *  strings.  Returns 0 for an empty collection. */
+gsize qof_collection_get_instance_size (const QofCollection *col);
+
 /* @} */
 /* @} */
 /* @} */
@@ -32,6 +32,7 @@ extern "C"
 #include "qof.h"
 #include "qofid-p.h"
 #include "qofinstance-p.h"
+#include "kvp-frame.hpp"
 
 static QofLogModule log_module = QOF_MOD_ENGINE;
 
@@ -250,6 +251,29 @@ qof_collection_count (const QofCollection *col)
     return c;
 }
 
+gsize
+qof_collection_get_instance_size (const QofCollection *col)
+{
+    GHashTableIter iter;
+    gpointer inst;
+    GTypeQuery query;
+    gpointer klass;
+
+    g_return_val_if_fail (col, 0);
+
+    g_hash_table_iter_init (&iter, col->hash_of_entities);
+    if (!g_hash_table_iter_next (&iter, NULL, &inst))
+        return 0;
+
+    /* The private data of the type and its ancestors sits in the same
+     * block, just before the instance.  sizeof (KvpFrame) is only the
+     * frame object; the nodes of its map are separate heap blocks. */
+    g_type_query (G_OBJECT_TYPE (inst), &query);
+    klass = g_type_class_peek (G_OBJECT_TYPE (inst));
+    return query.instance_size + sizeof (KvpFrame) +
+           (gsize) -g_type_class_get_instance_private_offset (klass);
+}
+
 /* =============================================================== */
 
 gboolean
@@ -994,6 +994,7 @@ qof_commit_edit_part2(QofInstance *inst,
                       void (*on_done)(QofInstance *),
                       void (*on_free)(QofInstance *))
 {
+    QOF_SCOPED_TIMER ("qof.commit-edit");
     QofInstancePrivate *priv;
 
     priv = GET_PRIVATE(inst);
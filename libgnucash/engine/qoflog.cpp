@@ -55,6 +55,13 @@ extern "C"
 #include "qof.h"
 #include "qoflog.h"
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #define QOF_LOG_MAX_CHARS 50
 #define QOF_LOG_MAX_CHARS_WITH_ALLOWANCE 100
 #define QOF_LOG_INDENT_WIDTH 4
@@ -66,6 +73,7 @@ static gint qof_log_num_spaces = 0;
 static GHashTable *log_table = NULL;
 static GLogFunc previous_handler = NULL;
 static gchar* qof_logger_format = NULL;
+static guint timing_report_source = 0;
 
 void
 qof_log_indent(void)
@@ -207,6 +215,14 @@ qof_log_init_filename(const gchar* log_filename)
 void
 qof_log_shutdown (void)
 {
+    qof_log_timers_report ();
+    qof_log_timers_reset ();
+    if (timing_report_source)
+    {
+        g_source_remove (timing_report_source);
+        timing_report_source = 0;
+    }
+
     if (fout && fout != stderr && fout != stdout)
     {
         fclose(fout);
@@ -301,6 +317,13 @@ qof_log_init_filename_special(const char *log_to_filename)
     }
 }
 
+static gboolean
+timing_report_cb (gpointer data)
+{
+    qof_log_timers_report ();
+    return G_SOURCE_CONTINUE;
+}
+
 void
 qof_log_parse_log_config(const char *filename)
 {
@@ -364,6 +387,16 @@ qof_log_parse_log_config(const char *filename)
             gchar *key = outputs[output_idx];
             gchar *value;
 
+            if (g_ascii_strcasecmp("timing-interval", key) == 0)
+            {
+                gint interval = g_key_file_get_integer(conf, output_group, key, NULL);
+                g_debug("setting [output].timing-interval=[%d]", interval);
+                if (timing_report_source)
+                    g_source_remove(timing_report_source);
+                timing_report_source = interval > 0 ?
+                    g_timeout_add_seconds(interval, timing_report_cb, NULL) : 0;
+                continue;
+            }
             if (g_ascii_strcasecmp("to", key) != 0)
             {
                 g_warning("unknown key [%s] in [outputs], skipping", key);
@@ -478,3 +511,151 @@ qof_log_level_from_string(const gchar *str)
     if (g_ascii_strncasecmp("debug", str, 5) == 0) return QOF_LOG_DEBUG;
     return QOF_LOG_DEBUG;
 }
+
+/* Durations are kept in a histogram with four buckets per power of
+ * two, so the percentiles are accurate to within about 20%. */
+#define QOF_TIMER_BUCKETS (63 * 4)
+
+struct QofLogTimer
+{
+    QofLogTimer (const char *timer_name) : name{timer_name} {}
+    std::string name;
+    std::atomic<bool> timed{false};
+    std::atomic<guint64> count{0};
+    std::atomic<guint64> total{0};
+    std::atomic<guint64> buckets[QOF_TIMER_BUCKETS] {};
+};
+
+static std::mutex timers_mutex;
+static std::vector<std::unique_ptr<QofLogTimer>> timers;
+
+/* Durations below 4ns get a bucket each. Above that, a duration whose
+ * most significant bit is msb (>= 2) goes into one of the four buckets
+ * (msb - 1) * 4 .. (msb - 1) * 4 + 3, picked by the next two bits. So
+ * the buckets are contiguous and every shift count is non-negative. */
+static constexpr guint
+timer_bucket (guint64 nsecs)
+{
+    guint msb = 0;
+    if (nsecs < 4)
+        return nsecs;
+    for (auto n = nsecs; n >>= 1;)
+        ++msb;
+    return (msb - 1) * 4 + ((nsecs >> (msb - 2)) & 3);
+}
+
+/* The smallest duration falling into bucket */
+static constexpr guint64
+timer_bucket_value (guint bucket)
+{
+    if (bucket < 4)
+        return bucket;
+    guint msb = bucket / 4 + 1;
+    return (G_GUINT64_CONSTANT(4) | (bucket & 3)) << (msb - 2);
+}
+
+static_assert (timer_bucket (3) == 3 && timer_bucket (4) == 4 &&
+               timer_bucket (7) == 7 && timer_bucket (8) == 8 &&
+               timer_bucket (G_MAXUINT64) < QOF_TIMER_BUCKETS,
+               "timer buckets must be contiguous and in range");
+static_assert (timer_bucket_value (timer_bucket (1000)) <= 1000 &&
+               timer_bucket_value (timer_bucket (1000) + 1) > 1000,
+               "a bucket's value must be its lower bound");
+
+QofLogTimer *
+qof_log_timer_get (const char *name)
+{
+    std::lock_guard<std::mutex> lock (timers_mutex);
+    for (auto& timer : timers)
+        if (timer->name == name)
+            return timer.get();
+    timers.emplace_back (new QofLogTimer (name));
+    return timers.back().get();
+}
+
+gint64
+qof_log_timer_now (void)
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void
+qof_log_timer_add (QofLogTimer *timer, gint64 nsecs)
+{
+    if (!timer) return;
+    if (nsecs < 0) nsecs = 0;
+    if (!timer->timed.load (std::memory_order_relaxed))
+        timer->timed.store (true, std::memory_order_relaxed);
+    timer->count.fetch_add (1, std::memory_order_relaxed);
+    timer->total.fetch_add (nsecs, std::memory_order_relaxed);
+    timer->buckets[timer_bucket (nsecs)].fetch_add (1, std::memory_order_relaxed);
+}
+
+void
+qof_log_counter_add (QofLogTimer *timer, gint64 n)
+{
+    if (!timer) return;
+    timer->count.fetch_add (n, std::memory_order_relaxed);
+}
+
+static guint64
+timer_percentile (const QofLogTimer *timer, guint64 count, guint percent)
+{
+    guint64 rank = (count * percent + 99) / 100, seen = 0;
+    for (guint i = 0; i < QOF_TIMER_BUCKETS; i++)
+    {
+        seen += timer->buckets[i].load (std::memory_order_relaxed);
+        if (seen >= rank)
+            return timer_bucket_value (i);
+    }
+    return timer_bucket_value (QOF_TIMER_BUCKETS - 1);
+}
+
+void
+qof_log_timers_report (void)
+{
+    std::lock_guard<std::mutex> lock (timers_mutex);
+    FILE *out = fout ? fout : stderr;
+    bool header = false;
+
+    for (auto& timer : timers)
+    {
+        guint64 count = timer->count.load (std::memory_order_relaxed);
+        if (!count)
+            continue;
+        if (!header)
+        {
+            fprintf (out, "* timing summary (durations in microseconds)\n");
+            header = true;
+        }
+        if (!timer->timed.load (std::memory_order_relaxed))
+        {
+            fprintf (out, "*   %-40s count %" G_GUINT64_FORMAT "\n",
+                     timer->name.c_str(), count);
+            continue;
+        }
+        guint64 total = timer->total.load (std::memory_order_relaxed);
+        fprintf (out, "*   %-40s count %" G_GUINT64_FORMAT
+                 " total %.1f mean %.3f p50 %.3f p99 %.3f\n",
+                 timer->name.c_str(), count, total / 1e3,
+                 total / 1e3 / count,
+                 timer_percentile (timer.get(), count, 50) / 1e3,
+                 timer_percentile (timer.get(), count, 99) / 1e3);
+    }
+    if (header)
+        fflush (out);
+}
+
+void
+qof_log_timers_reset (void)
+{
+    std::lock_guard<std::mutex> lock (timers_mutex);
+    for (auto& timer : timers)
+    {
+        timer->count = 0;
+        timer->total = 0;
+        for (auto& bucket : timer->buckets)
+            bucket = 0;
+    }
+}
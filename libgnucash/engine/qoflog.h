@@ -286,6 +286,71 @@ void qof_log_set_default(QofLogLevel log_level);
 
 #endif /* _MSC_VER */
 
+/** @name Timing
+ *
+ * Aggregate counts and durations of hot engine paths, for finding
+ * out where time goes in production without a profiler.  Timers and
+ * counters are keyed by static names like @c "qof.query-run"; their
+ * summary (count, total, mean, p50 and p99 durations) goes to the log
+ * output when the log is shut down, or every @c timing-interval
+ * seconds as set in the [output] group of the log configuration.
+ *
+ * The macros compile to nothing unless gnucash is configured with
+ * @c -DENABLE_TIMING=ON.
+ * @{ */
+
+typedef struct QofLogTimer QofLogTimer;
+
+/** Get the timer for @a name, creating it on first use.  Timers live
+ * until the program ends, so the result can be cached. **/
+QofLogTimer *qof_log_timer_get (const char *name);
+
+/** A monotonic clock reading in nanoseconds. **/
+gint64 qof_log_timer_now (void);
+
+/** Record one run of @a timer taking @a nsecs nanoseconds. **/
+void qof_log_timer_add (QofLogTimer *timer, gint64 nsecs);
+
+/** Add @a n to the counter @a timer. **/
+void qof_log_counter_add (QofLogTimer *timer, gint64 n);
+
+/** Write the summary of all timers and counters to the log output. **/
+void qof_log_timers_report (void);
+
+/** Clear all timers and counters. **/
+void qof_log_timers_reset (void);
+
+#ifdef QOF_LOG_TIMING
+
+/** Start timing; place among the declarations of a block. **/
+#define QOF_TIMER_START(var) gint64 var = qof_log_timer_now ()
+
+/** Stop the timing started with QOF_TIMER_START and record it as @a name. **/
+#define QOF_TIMER_STOP(var, name) do { \
+    static QofLogTimer *qof_log_timer_ = NULL; \
+    if (G_UNLIKELY (!qof_log_timer_)) \
+        qof_log_timer_ = qof_log_timer_get (name); \
+    qof_log_timer_add (qof_log_timer_, qof_log_timer_now () - (var)); \
+} while (0)
+
+/** Add @a n to the counter @a name. **/
+#define QOF_COUNTER_ADD(name, n) do { \
+    static QofLogTimer *qof_log_timer_ = NULL; \
+    if (G_UNLIKELY (!qof_log_timer_)) \
+        qof_log_timer_ = qof_log_timer_get (name); \
+    qof_log_counter_add (qof_log_timer_, (n)); \
+} while (0)
+
+#else /* QOF_LOG_TIMING */
+
+#define QOF_TIMER_START(var) G_GNUC_UNUSED gint64 var = 0
+#define QOF_TIMER_STOP(var, name) do { } while (0)
+#define QOF_COUNTER_ADD(name, n) do { } while (0)
+
+#endif /* QOF_LOG_TIMING */
+
+/** @} */
+
 /** Replacement for @c g_return_val_if_fail, but calls LEAVE if the test fails. **/
 #define gnc_leave_return_val_if_fail(test, val) do { \
   if (! (test)) { LEAVE(""); } \
@@ -301,8 +366,35 @@ void qof_log_set_default(QofLogLevel log_level);
 
 #ifdef __cplusplus
 }
+
+/** Times the enclosing scope, C++ only. **/
+class QofLogScopedTimer
+{
+public:
+    QofLogScopedTimer (QofLogTimer *timer) :
+        m_timer{timer}, m_start{qof_log_timer_now ()} {}
+    ~QofLogScopedTimer ()
+    {
+        qof_log_timer_add (m_timer, qof_log_timer_now () - m_start);
+    }
+    QofLogScopedTimer (const QofLogScopedTimer&) = delete;
+    QofLogScopedTimer& operator= (const QofLogScopedTimer&) = delete;
+private:
+    QofLogTimer *m_timer;
+    gint64 m_start;
+};
+
+#ifdef QOF_LOG_TIMING
+/** Time the rest of the enclosing scope as @a name. **/
+#define QOF_SCOPED_TIMER(name) \
+    static QofLogTimer* const qof_log_scoped_timer_ = qof_log_timer_get (name); \
+    QofLogScopedTimer qof_log_scoped_guard_ {qof_log_scoped_timer_}
+#else
+#define QOF_SCOPED_TIMER(name) do { } while (0)
 #endif
 
+#endif /* __cplusplus */
+
 #endif /* _QOF_LOG_H */
 
 /** @} */
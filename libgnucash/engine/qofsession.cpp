@@ -212,6 +212,7 @@ QofSessionImpl::load (QofPercentageFunc percentage_func) noexcept
     auto be (qof_book_get_backend(m_book));
     if (be)
     {
+        QOF_SCOPED_TIMER ("qof.session-load");
         be->set_percentage(percentage_func);
         be->load (m_book, LOAD_TYPE_INITIAL_LOAD);
         push_error (be->get_error(), {});
@@ -439,7 +440,7 @@ QofSessionImpl::save (QofPercentageFunc percentage_func) noexcept
     auto backend = qof_book_get_backend (m_book);
     if (backend)
     {
-
+        QOF_SCOPED_TIMER ("qof.session-sync");
         backend->set_percentage(percentage_func);
         backend->sync(m_book);
         auto err = backend->get_error();
@@ -467,6 +468,7 @@ QofSessionImpl::safe_save (QofPercentageFunc percentage_func) noexcept
 {
     auto backend = qof_book_get_backend (m_book);
     if (!backend) return;
+    QOF_SCOPED_TIMER ("qof.session-safe-sync");
     backend->set_percentage(percentage_func);
     backend->safe_sync(get_book ());
     auto err = backend->get_error();
@@ -115,6 +115,12 @@ set_max_accounts_per_level (gint max_level_accounts_in)
     max_level_accounts = MAX (max_level_accounts_in, 1);
 }
 
+void
+set_max_total_accounts (gint max_total_accounts_in)
+{
+    max_total_accounts = MAX (max_total_accounts_in, 2);
+}
+
 void
 set_max_kvp_depth (gint max_kvp_depth)
 {
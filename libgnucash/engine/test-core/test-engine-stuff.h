@@ -67,6 +67,7 @@ void set_max_kvp_depth (gint max_kvp_depth);
 void set_max_kvp_frame_elements (gint max_kvp_frame_elements);
 void set_max_account_tree_depth (gint max_tree_depth);
 void set_max_accounts_per_level (gint max_accounts);
+void set_max_total_accounts (gint max_accounts);
 
 GNCPrice * get_random_price(QofBook *book);
 gboolean make_random_pricedb (QofBook *book, GNCPriceDB *pdb);
@@ -0,0 +1,422 @@
+/********************************************************************
+ * gnc-bench.cpp: Benchmarks for core engine and backend operations. *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+/**
+ * @file gnc-bench.cpp
+ * @brief Times core operations on a synthesized book.
+ *
+ * The book is generated with the test-engine-stuff generators from a
+ * seed, so two runs with the same parameters work on the same data.
+ * Every benchmark prints one JSON object per line on stdout, with the
+ * peak resident set size of the process so far, and the generated book
+ * reports the memory taken by each type of entity, e.g.
+ *
+ *   gnc-bench --seed 42 --accounts 200 --transactions 20000 > run.json
+ *
+ * The program isn't run by ctest; build it with "make gnc-bench".
+ */
+extern "C"
+{
+#include <config.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifndef G_OS_WIN32
+#include <sys/resource.h>
+#endif
+#include "qof.h"
+#include "Account.h"
+#include "Query.h"
+#include "Scrub.h"
+#include "Scrub3.h"
+#include "Transaction.h"
+#include "cashobjects.h"
+#include "gnc-pricedb.h"
+#include "test-engine-stuff.h"
+}
+
+#include <vector>
+
+static gint seed = 0;
+static gint num_accounts = 100;
+static gint num_transactions = 10000;
+static gint num_prices = 1000;
+static gint iterations = 10;
+static gboolean skip_backends = FALSE;
+
+static GOptionEntry options[] =
+{
+    { "seed", 's', 0, G_OPTION_ARG_INT, &seed,
+      "Seed of the generated book", "N" },
+    { "accounts", 'a', 0, G_OPTION_ARG_INT, &num_accounts,
+      "Number of accounts to generate", "N" },
+    { "transactions", 't', 0, G_OPTION_ARG_INT, &num_transactions,
+      "Number of transactions to generate", "N" },
+    { "prices", 'p', 0, G_OPTION_ARG_INT, &num_prices,
+      "Number of prices to generate", "N" },
+    { "iterations", 'i', 0, G_OPTION_ARG_INT, &iterations,
+      "Repetitions of the in-memory benchmarks", "N" },
+    { "no-backends", '\0', 0, G_OPTION_ARG_NONE, &skip_backends,
+      "Skip the XML and SQLite load/save benchmarks", NULL },
+    { NULL }
+};
+
+/* The actual size of the generated book, the generators only take
+ * upper bounds for some of them. */
+struct BookSize
+{
+    gint accounts;
+    gint transactions;
+    guint prices;
+    gint lots;
+};
+
+static BookSize book_size;
+
+/* The peak resident set size in KiB, or -1 where it isn't known. */
+static long
+peak_rss_kb (void)
+{
+#ifndef G_OS_WIN32
+    struct rusage usage;
+
+    if (getrusage (RUSAGE_SELF, &usage) == 0)
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024;
+#else
+        return usage.ru_maxrss;
+#endif
+#endif
+    return -1;
+}
+
+static void
+report (const char *name, gint64 usecs, gint count)
+{
+    printf ("{\"benchmark\": \"%s\", \"seconds\": %.6f, \"iterations\": %d, "
+            "\"seed\": %d, \"accounts\": %d, \"transactions\": %d, "
+            "\"prices\": %u, \"lots\": %d, \"peak_rss_kb\": %ld}\n",
+            name, usecs / (double) G_USEC_PER_SEC, count, seed,
+            book_size.accounts, book_size.transactions, book_size.prices,
+            book_size.lots, peak_rss_kb ());
+    fflush (stdout);
+}
+
+static void
+report_memory (QofBook *book)
+{
+    GList *usages = qof_book_get_memory_usage (book);
+
+    for (GList *node = usages; node; node = node->next)
+    {
+        auto usage = static_cast<QofBookMemoryUsage*>(node->data);
+        printf ("{\"memory\": \"%s\", \"count\": %u, \"bytes\": %"
+                G_GSIZE_FORMAT "}\n", usage->type, usage->count, usage->bytes);
+    }
+    fflush (stdout);
+    g_list_free_full (usages, g_free);
+}
+
+template <typename Func> static void
+bench (const char *name, gint count, Func func)
+{
+    gint64 start = g_get_monotonic_time ();
+    for (gint i = 0; i < count; i++)
+        func ();
+    report (name, g_get_monotonic_time () - start, count);
+}
+
+static void
+generate_book (QofBook *book)
+{
+    Account *root;
+    GNCPriceDB *db = gnc_pricedb_get_db (book);
+    gint missing;
+
+    /* Each generated tree is capped, so keep growing until the
+     * requested number of accounts is reached. */
+    set_max_account_tree_depth (4);
+    root = get_random_account_tree (book);
+    while ((missing = num_accounts - gnc_account_n_descendants (root)) > 0)
+    {
+        set_max_total_accounts (missing);
+        get_random_account_tree (book);
+    }
+
+    for (gint i = 0; i < num_prices; i++)
+    {
+        GNCPrice *p = get_random_price (book);
+        if (!p)
+            continue;
+        gnc_pricedb_add_price (db, p);
+        gnc_price_unref (p);
+    }
+
+    add_random_transactions_to_book (book, num_transactions);
+
+    book_size.accounts = gnc_account_n_descendants (root);
+    book_size.transactions = num_transactions;
+    book_size.prices = gnc_pricedb_get_num_prices (db);
+}
+
+static gint
+count_lots (GList *accounts)
+{
+    gint lots = 0;
+    for (GList *node = accounts; node; node = node->next)
+    {
+        GList *acc_lots = xaccAccountGetLotList (static_cast<Account*>(node->data));
+        lots += g_list_length (acc_lots);
+        g_list_free (acc_lots);
+    }
+    return lots;
+}
+
+static gboolean
+collect_price (GNCPrice *p, gpointer data)
+{
+    static_cast<std::vector<GNCPrice*>*>(data)->push_back (p);
+    return TRUE;
+}
+
+static void
+bench_engine (QofBook *book)
+{
+    Account *root = gnc_book_get_root_account (book);
+    GList *accounts = gnc_account_get_descendants (root);
+    GNCPriceDB *db = gnc_pricedb_get_db (book);
+    std::vector<GNCPrice*> prices;
+    std::vector<time64> dates;
+
+    /* Draw the dates before anything else consumes random numbers */
+    for (gint i = 0; i < 16; i++)
+        dates.push_back (get_random_time ());
+    gnc_pricedb_foreach_price (db, collect_price, &prices, TRUE);
+
+    bench ("recompute-balance", iterations, [accounts]() {
+        for (GList *node = accounts; node; node = node->next)
+        {
+            auto acc = static_cast<Account*>(node->data);
+            /* Clean balances aren't recomputed */
+            gnc_account_set_balance_dirty (acc);
+            xaccAccountRecomputeBalance (acc);
+        }
+    });
+
+    bench ("balance-as-of", iterations, [accounts, &dates]() {
+        for (GList *node = accounts; node; node = node->next)
+            for (auto date : dates)
+                xaccAccountGetBalanceAsOfDate (static_cast<Account*>(node->data),
+                                               date);
+    });
+
+    bench ("price-lookup-nearest", iterations, [db, &prices]() {
+        for (auto p : prices)
+        {
+            auto found = gnc_pricedb_lookup_nearest_in_time64 (
+                db, gnc_price_get_commodity (p), gnc_price_get_currency (p),
+                gnc_price_get_time64 (p));
+            gnc_price_unref (found);
+        }
+    });
+
+    bench ("price-lookup-latest", iterations, [db, &prices]() {
+        for (auto p : prices)
+        {
+            auto found = gnc_pricedb_lookup_latest (
+                db, gnc_price_get_commodity (p), gnc_price_get_currency (p));
+            gnc_price_unref (found);
+        }
+    });
+
+    bench ("query-run", iterations, [book, &dates]() {
+        for (gsize i = 0; i + 1 < dates.size (); i += 2)
+        {
+            QofQuery *q = qof_query_create_for (GNC_ID_SPLIT);
+            qof_query_set_book (q, book);
+            xaccQueryAddDateMatchTT (q, TRUE, MIN (dates[i], dates[i + 1]),
+                                     TRUE, MAX (dates[i], dates[i + 1]),
+                                     QOF_QUERY_AND);
+            qof_query_run (q);
+            qof_query_destroy (q);
+        }
+    });
+
+    /* The scrubbers change the book, so they only run once and last */
+    bench ("scrub-orphans", 1, [root]() {
+        xaccAccountTreeScrubOrphans (root, NULL);
+    });
+    bench ("scrub-imbalance", 1, [root]() {
+        xaccAccountTreeScrubImbalance (root, NULL);
+    });
+    bench ("scrub-lots", 1, [root]() {
+        xaccAccountTreeScrubLots (root);
+    });
+    book_size.lots = count_lots (accounts);
+
+    g_list_free (accounts);
+}
+
+/* Save the data of @a from under @a uri, then load it back into a
+ * fresh session.  The data is handed back to @a from afterwards. */
+static void
+bench_backend (const char *name, QofSession *from, const char *uri)
+{
+    QofSession *save_session = qof_session_new ();
+    QofSession *load_session = qof_session_new ();
+    gchar *bench_name;
+
+    qof_session_begin (save_session, uri, FALSE, TRUE, TRUE);
+    qof_session_swap_data (from, save_session);
+    /* A clean book isn't saved at all */
+    qof_book_mark_session_dirty (qof_session_get_book (save_session));
+    bench_name = g_strdup_printf ("%s-save", name);
+    bench (bench_name, 1, [save_session]() {
+        qof_session_save (save_session, NULL);
+    });
+    g_free (bench_name);
+    if (qof_session_get_error (save_session) != ERR_BACKEND_NO_ERR)
+        g_warning ("%s: %s", uri, qof_session_get_error_message (save_session));
+
+    bench_name = g_strdup_printf ("%s-load", name);
+    bench (bench_name, 1, [load_session, uri]() {
+        qof_session_begin (load_session, uri, TRUE, FALSE, FALSE);
+        qof_session_load (load_session, NULL);
+    });
+    g_free (bench_name);
+    if (qof_session_get_error (load_session) != ERR_BACKEND_NO_ERR)
+        g_warning ("%s: %s", uri, qof_session_get_error_message (load_session));
+
+    qof_session_end (load_session);
+    qof_session_destroy (load_session);
+    qof_session_swap_data (save_session, from);
+    qof_session_end (save_session);
+    qof_session_destroy (save_session);
+}
+
+/* A full sync rewrites every object, as "Save As" to an SQL file does */
+static void
+bench_sql_sync (QofSession *from, const char *uri)
+{
+    QofSession *session = qof_session_new ();
+
+    qof_session_begin (session, uri, TRUE, FALSE, FALSE);
+    qof_session_swap_data (from, session);
+    qof_book_mark_session_dirty (qof_session_get_book (session));
+    bench ("sqlite-sync", 1, [session]() {
+        qof_session_save (session, NULL);
+    });
+    if (qof_session_get_error (session) != ERR_BACKEND_NO_ERR)
+        g_warning ("%s: %s", uri, qof_session_get_error_message (session));
+    qof_session_swap_data (session, from);
+    qof_session_end (session);
+    qof_session_destroy (session);
+}
+
+static void
+remove_dir (const gchar *dirname)
+{
+    GDir *dir = g_dir_open (dirname, 0, NULL);
+    const gchar *name;
+
+    if (!dir)
+        return;
+    while ((name = g_dir_read_name (dir)))
+    {
+        gchar *path = g_build_filename (dirname, name, NULL);
+        g_unlink (path);
+        g_free (path);
+    }
+    g_dir_close (dir);
+    g_rmdir (dirname);
+}
+
+int
+main (int argc, char **argv)
+{
+    GOptionContext *context;
+    GError *error = NULL;
+    QofSession *session;
+    gchar *tmpdir;
+
+    context = g_option_context_new ("- time core engine operations");
+    g_option_context_add_main_entries (context, options, NULL);
+    if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+        g_printerr ("%s\n", error->message);
+        g_error_free (error);
+        return 1;
+    }
+    g_option_context_free (context);
+
+    g_setenv ("GNC_UNINSTALLED", "1", TRUE);
+    g_setenv ("GNC_BUILDDIR", GNC_BENCH_BUILDDIR, FALSE);
+    qof_init ();
+    if (!cashobjects_register ())
+        return 1;
+
+    srand (seed);
+    session = qof_session_new ();
+    {
+        QofBook *book = qof_session_get_book (session);
+        gint64 start = g_get_monotonic_time ();
+        generate_book (book);
+        report ("generate", g_get_monotonic_time () - start, 1);
+        report_memory (book);
+        bench_engine (book);
+    }
+
+    tmpdir = skip_backends ? NULL : g_dir_make_tmp ("gnc-bench-XXXXXX", &error);
+    if (!skip_backends && !tmpdir)
+    {
+        g_printerr ("%s\n", error->message);
+        g_error_free (error);
+    }
+    if (tmpdir)
+    {
+        if (qof_load_backend_library ("xml", "gncmod-backend-xml"))
+        {
+            gchar *uri = g_strdup_printf ("xml://%s/bench.gnucash", tmpdir);
+            bench_backend ("xml", session, uri);
+            g_free (uri);
+        }
+        else
+            g_printerr ("XML backend not available, skipped.\n");
+
+        if (qof_load_backend_library ("dbi", "gncmod-backend-dbi"))
+        {
+            gchar *uri = g_strdup_printf ("sqlite3://%s/bench.sqlite", tmpdir);
+            bench_backend ("sqlite", session, uri);
+            bench_sql_sync (session, uri);
+            g_free (uri);
+        }
+        else
+            g_printerr ("SQLite backend not available, skipped.\n");
+
+        remove_dir (tmpdir);
+        g_free (tmpdir);
+    }
+
+    qof_session_end (session);
+    qof_session_destroy (session);
+    qof_close ();
+    return 0;
+}
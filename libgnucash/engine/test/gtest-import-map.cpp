@@ -391,3 +391,41 @@ TEST_F (ImapBayesTest, get_bayes_info)
     EXPECT_STREQ (info->count, "1");
 }
 
+
+/* The compiled bayes model must follow later updates of the map */
+TEST_F (ImapBayesTest, find_account_bayes_after_update)
+{
+    for (int i = 0; i < 3; ++i)
+        gnc_account_imap_add_account_bayes (t_imap, t_list1, t_expense_account1);
+    auto account = gnc_account_imap_find_account_bayes (t_imap, t_list1);
+    EXPECT_EQ (account, t_expense_account1);
+    for (int i = 0; i < 4; ++i)
+        gnc_account_imap_add_account_bayes (t_imap, t_list1, t_expense_account2);
+    account = gnc_account_imap_find_account_bayes (t_imap, t_list1);
+    EXPECT_EQ (account, nullptr);
+    gnc_account_delete_all_bayes_maps (t_bank_account);
+    account = gnc_account_imap_find_account_bayes (t_imap, t_list1);
+    EXPECT_EQ (account, nullptr);
+}
+
+/* Changing the map's kvp directly must show once the account is committed */
+TEST_F (ImapBayesTest, find_account_bayes_after_kvp_change)
+{
+    auto root = qof_instance_get_slots (QOF_INSTANCE (t_bank_account));
+    auto acct1_guid = guid_to_string (xaccAccountGetGUID (t_expense_account1));
+    auto acct2_guid = guid_to_string (xaccAccountGetGUID (t_expense_account2));
+
+    root->set_path ({std::string{IMAP_FRAME_BAYES} + "/" + foo + "/" + acct1_guid},
+                    new KvpValue {INT64_C(42)});
+    EXPECT_EQ (gnc_account_imap_find_account_bayes (t_imap, t_list1), t_expense_account1);
+
+    xaccAccountBeginEdit (t_bank_account);
+    delete root->set_path ({std::string{IMAP_FRAME_BAYES} + "/" + foo + "/" + acct1_guid},
+                           nullptr);
+    root->set_path ({std::string{IMAP_FRAME_BAYES} + "/" + foo + "/" + acct2_guid},
+                    new KvpValue {INT64_C(42)});
+    xaccAccountCommitEdit (t_bank_account);
+    EXPECT_EQ (gnc_account_imap_find_account_bayes (t_imap, t_list1), t_expense_account2);
+    g_free (acct1_guid);
+    g_free (acct2_guid);
+}
@@ -683,6 +683,23 @@ test_book_get_session_dirty_time( Fixture *fixture, gconstpointer pData )
 
 }
 
+static void
+test_book_get_generation( Fixture *fixture, gconstpointer pData )
+{
+    gint64 generation = qof_book_get_generation( fixture->book );
+
+    g_test_message( "Testing events increment the generation" );
+    qof_event_gen( QOF_INSTANCE( fixture->book ), QOF_EVENT_MODIFY, NULL );
+    g_assert_cmpint( qof_book_get_generation( fixture->book ), != , generation );
+
+    g_test_message( "Testing suspended events increment the generation too" );
+    generation = qof_book_get_generation( fixture->book );
+    qof_event_suspend();
+    qof_event_gen( QOF_INSTANCE( fixture->book ), QOF_EVENT_MODIFY, NULL );
+    qof_event_resume();
+    g_assert_cmpint( qof_book_get_generation( fixture->book ), != , generation );
+}
+
 static void
 test_book_set_dirty_cb( Fixture *fixture, gconstpointer pData )
 {
@@ -871,6 +888,40 @@ test_book_set_data_fin( void )
     g_assert( test_struct.called );
 }
 
+static void
+test_book_get_memory_usage( Fixture *fixture, gconstpointer pData )
+{
+    GList *usage, *node;
+    gboolean found_account = FALSE, found_empty = FALSE;
+
+    qof_book_get_collection( fixture->book, "my_type" );
+    gnc_account_create_root( fixture->book );
+
+    usage = qof_book_get_memory_usage( fixture->book );
+    g_assert( usage );
+    for ( node = usage; node; node = node->next )
+    {
+        QofBookMemoryUsage *entry = (QofBookMemoryUsage*)node->data;
+        if ( node->next )
+            g_assert_cmpstr( entry->type, <, ((QofBookMemoryUsage*)node->next->data)->type );
+        if ( g_strcmp0( entry->type, GNC_ID_ACCOUNT ) == 0 )
+        {
+            found_account = TRUE;
+            g_assert_cmpuint( entry->count, ==, 1 );
+            g_assert_cmpuint( entry->bytes, >, sizeof( QofInstance ) );
+        }
+        else if ( g_strcmp0( entry->type, "my_type" ) == 0 )
+        {
+            found_empty = TRUE;
+            g_assert_cmpuint( entry->count, ==, 0 );
+            g_assert_cmpuint( entry->bytes, ==, 0 );
+        }
+    }
+    g_assert( found_account );
+    g_assert( found_empty );
+    g_list_free_full( usage, g_free );
+}
+
 static void
 test_book_mark_closed( Fixture *fixture, gconstpointer pData )
 {
@@ -936,12 +987,14 @@ test_suite_qofbook ( void )
     GNC_TEST_ADD( suitename, "use split action for num field", Fixture, NULL, setup, test_book_use_split_action_for_num_field, teardown );
     GNC_TEST_ADD( suitename, "mark session dirty", Fixture, NULL, setup, test_book_mark_session_dirty, teardown );
     GNC_TEST_ADD( suitename, "session dirty time", Fixture, NULL, setup, test_book_get_session_dirty_time, teardown );
+    GNC_TEST_ADD( suitename, "generation", Fixture, NULL, setup, test_book_get_generation, teardown );
     GNC_TEST_ADD( suitename, "set dirty callback", Fixture, NULL, setup, test_book_set_dirty_cb, teardown );
     GNC_TEST_ADD( suitename, "shutting down", Fixture, NULL, setup, test_book_shutting_down, teardown );
     GNC_TEST_ADD( suitename, "set get data", Fixture, NULL, setup, test_book_set_get_data, teardown );
     GNC_TEST_ADD( suitename, "get collection", Fixture, NULL, setup, test_book_get_collection, teardown );
     GNC_TEST_ADD( suitename, "foreach collection", Fixture, NULL, setup, test_book_foreach_collection, teardown );
     GNC_TEST_ADD_FUNC( suitename, "set data finalizers", test_book_set_data_fin );
+    GNC_TEST_ADD( suitename, "get memory usage", Fixture, NULL, setup, test_book_get_memory_usage, teardown );
     GNC_TEST_ADD( suitename, "mark closed", Fixture, NULL, setup, test_book_mark_closed, teardown );
     GNC_TEST_ADD_FUNC( suitename, "book new and destroy", test_book_new_destroy );
 }
@@ -325,6 +325,57 @@ static void test_some()
     test_specific(PERIOD_DAY, 7,    4, 1, 2000,    4, 8, 2000,  4, 15, 2000);
 }
 
+#define NUM_INSTANCES_TO_TEST 40
+
+/* recurrenceNthInstance() computes the date directly; check it against
+   stepping there with recurrenceNextInstance(). */
+static void test_nth_instance()
+{
+    Recurrence r;
+    GDate d_start, d_iter, d_ref, d_nth;
+    guint16 mult;
+    PeriodType pt;
+    WeekendAdjust wadj;
+    gint32 j1;
+    guint n;
+
+    for (pt = PERIOD_ONCE; pt < NUM_PERIOD_TYPES; pt++)
+    {
+        for (wadj = WEEKEND_ADJ_NONE; wadj < NUM_WEEKEND_ADJS; wadj++)
+        {
+            for (j1 = JULIAN_START; j1 < JULIAN_START + 3 * 366; j1 += 3)
+            {
+                g_date_set_julian(&d_start, j1);
+                for (mult = 1; mult < NUM_MULT_TO_TEST; mult += 2)
+                {
+                    recurrenceSet(&r, mult, pt, &d_start, wadj);
+                    d_iter = d_ref = recurrenceGetDate(&r);
+                    for (n = 0; n < NUM_INSTANCES_TO_TEST; n++)
+                    {
+                        if (n > 0)
+                        {
+                            recurrenceNextInstance(&r, &d_ref, &d_iter);
+                            d_ref = d_iter;
+                        }
+                        recurrenceNthInstance(&r, n, &d_nth);
+                        if (!g_date_valid(&d_iter))
+                        {
+                            do_test(!g_date_valid(&d_nth), "nth instance valid");
+                            break;
+                        }
+                        if (!test_equal(&d_nth, &d_iter))
+                        {
+                            printf("pt = %d; wadj = %d; mult = %d; n = %u\n",
+                                   pt, wadj, mult, n);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
 static void test_use()
 {
     Recurrence *r;
@@ -343,6 +394,8 @@ static void test_main()
 
     test_some();
 
+    test_nth_instance();
+
     test_all();
 
     qof_book_destroy (book);
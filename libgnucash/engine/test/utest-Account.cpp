@@ -33,6 +33,7 @@ extern "C"
 #include "../Split.h"
 #include "../Transaction.h"
 #include "../gnc-lot.h"
+#include "../gnc-pricedb.h"
 
 #if defined(__clang__) && (__clang_major__ == 5 || (__clang_major__ == 3 && __clang_minor__ < 5))
 #define USE_CLANG_FUNC_SIG 1
@@ -1958,6 +1959,210 @@ test_xaccAccountGetPresentBalance (Fixture *fixture, gconstpointer pData)
     dval = gnc_numeric_to_double (val);
     g_assert_cmpfloat (dval, == , dbal);
 }
+
+static Transaction *
+make_transfer (QofBook *book, Account *acc, Account *other,
+               gnc_commodity *curr, gint days, gint64 amount)
+{
+    auto txn = xaccMallocTransaction (book);
+    auto split = xaccMallocSplit (book);
+    auto balancing = xaccMallocSplit (book);
+    auto date = gnc_time (nullptr) + days * 24 * 3600;
+
+    xaccTransBeginEdit (txn);
+    xaccTransSetCurrency (txn, curr);
+    xaccTransSetDatePostedSecsNormalized (txn, date);
+    xaccSplitSetParent (split, txn);
+    xaccSplitSetParent (balancing, txn);
+    xaccSplitSetAccount (split, acc);
+    xaccSplitSetAccount (balancing, other);
+    xaccSplitSetAmount (split, gnc_numeric_create (amount, 100));
+    xaccSplitSetValue (split, gnc_numeric_create (amount, 100));
+    xaccSplitSetAmount (balancing, gnc_numeric_create (-amount, 100));
+    xaccSplitSetValue (balancing, gnc_numeric_create (-amount, 100));
+    xaccTransCommitEdit (txn);
+    return txn;
+}
+
+static void
+assert_present_and_minimum (Account *acc, gint64 present, gint64 minimum)
+{
+    g_assert (gnc_numeric_eq (xaccAccountGetPresentBalance (acc),
+                              gnc_numeric_create (present, 100)));
+    g_assert (gnc_numeric_eq (xaccAccountGetProjectedMinimumBalance (acc),
+                              gnc_numeric_create (minimum, 100)));
+}
+
+/* The present and projected minimum balances are found from an index
+ * built on the first query; check that they follow the splits and their
+ * amounts as those change. */
+static void
+test_xaccAccountGetPresentBalance_changes (Fixture *fixture,
+                                           gconstpointer pData)
+{
+    auto book = gnc_account_get_book (fixture->acct);
+    auto usd = gnc_commodity_new (book, "US Dollar", "CURRENCY", "USD", "0", 100);
+    auto acc = xaccMallocAccount (book);
+    auto other = xaccMallocAccount (book);
+
+    gnc_account_append_child (fixture->acct, acc);
+    gnc_account_append_child (fixture->acct, other);
+    xaccAccountSetCommodity (acc, usd);
+    xaccAccountSetCommodity (other, usd);
+
+    assert_present_and_minimum (acc, 0, 0);
+
+    /* Balances 100, 70, 120 */
+    make_transfer (book, acc, other, usd, -10, 10000);
+    auto later = make_transfer (book, acc, other, usd, 10, -3000);
+    make_transfer (book, acc, other, usd, 20, 5000);
+    assert_present_and_minimum (acc, 10000, 7000);
+
+    /* A split before the minimum: 100, 20, -10, 40 */
+    auto sooner = make_transfer (book, acc, other, usd, 5, -8000);
+    assert_present_and_minimum (acc, 10000, -1000);
+
+    /* A change of its amount: 100, 80, 50, 100 */
+    xaccTransBeginEdit (sooner);
+    for (auto node = xaccTransGetSplitList (sooner); node; node = node->next)
+    {
+        auto split = static_cast<Split*>(node->data);
+        auto amount = xaccSplitGetAccount (split) == acc ? -2000 : 2000;
+        xaccSplitSetAmount (split, gnc_numeric_create (amount, 100));
+        xaccSplitSetValue (split, gnc_numeric_create (amount, 100));
+    }
+    xaccTransCommitEdit (sooner);
+    assert_present_and_minimum (acc, 10000, 5000);
+
+    /* Removing a split: 100, 80, 130 */
+    xaccTransBeginEdit (later);
+    xaccTransDestroy (later);
+    xaccTransCommitEdit (later);
+    assert_present_and_minimum (acc, 10000, 8000);
+
+    /* A split before today moves both: 105, 85, 135 */
+    make_transfer (book, acc, other, usd, -5, 500);
+    assert_present_and_minimum (acc, 10500, 8500);
+}
+/* xaccAccountGetXxxBalanceInCurrencyRecursive
+static gnc_numeric
+xaccAccountGetXxxBalanceInCurrencyRecursive (const Account *acc,// C: 5 in 1
+The subtree totals are cached; check that they follow balance changes
+below the account and moves of accounts within the tree. */
+static void
+test_xaccAccountGetXxxBalanceInCurrencyRecursive (Fixture *fixture,
+                                                  gconstpointer pData)
+{
+    auto root = fixture->acct;
+    auto book = gnc_account_get_book (root);
+    auto usd = gnc_commodity_new (book, "US Dollar", "CURRENCY", "USD", "0", 100);
+    auto parent = xaccMallocAccount (book);
+    auto child = xaccMallocAccount (book);
+    auto other = xaccMallocAccount (book);
+    Account *accts[] = { parent, child, other };
+    gint64 start[] = { 100, 250, 400 };
+
+    gnc_account_append_child (root, parent);
+    gnc_account_append_child (parent, child);
+    gnc_account_append_child (root, other);
+    for (guint ind = 0; ind < G_N_ELEMENTS (accts); ind++)
+    {
+        xaccAccountSetCommodity (accts[ind], usd);
+        gnc_account_set_start_balance (accts[ind],
+                                       gnc_numeric_create (start[ind], 100));
+        xaccAccountRecomputeBalance (accts[ind]);
+    }
+
+    g_assert (gnc_numeric_eq (xaccAccountGetBalanceInCurrency (parent, usd, TRUE),
+                              gnc_numeric_create (350, 100)));
+    g_assert (gnc_numeric_eq (xaccAccountGetBalanceInCurrency (root, usd, TRUE),
+                              gnc_numeric_create (750, 100)));
+
+    gnc_account_set_start_balance (child, gnc_numeric_create (500, 100));
+    xaccAccountRecomputeBalance (child);
+    g_assert (gnc_numeric_eq (xaccAccountGetBalanceInCurrency (parent, usd, TRUE),
+                              gnc_numeric_create (600, 100)));
+    g_assert (gnc_numeric_eq (xaccAccountGetBalanceInCurrency (root, usd, TRUE),
+                              gnc_numeric_create (1000, 100)));
+
+    gnc_account_append_child (other, child);
+    g_assert (gnc_numeric_eq (xaccAccountGetBalanceInCurrency (parent, usd, TRUE),
+                              gnc_numeric_create (100, 100)));
+    g_assert (gnc_numeric_eq (xaccAccountGetBalanceInCurrency (other, usd, TRUE),
+                              gnc_numeric_create (900, 100)));
+    g_assert (gnc_numeric_eq (xaccAccountGetBalanceInCurrency (other, usd, FALSE),
+                              gnc_numeric_create (400, 100)));
+}
+
+static GNCPrice *
+make_price (QofBook *book, gnc_commodity *comm, gnc_commodity *curr,
+            gint64 num)
+{
+    auto price = gnc_price_create (book);
+    gnc_price_begin_edit (price);
+    gnc_price_set_commodity (price, comm);
+    gnc_price_set_currency (price, curr);
+    gnc_price_set_time64 (price, gnc_time (nullptr));
+    gnc_price_set_source (price, PRICE_SOURCE_USER_PRICE);
+    gnc_price_set_typestr (price, PRICE_TYPE_LAST);
+    gnc_price_set_value (price, gnc_numeric_create (num, 100));
+    gnc_price_commit_edit (price);
+    return price;
+}
+
+/* Cached subtree totals in another commodity must follow the prices
+ * they were converted with, and stay correct when the cache of an
+ * account overflows with balances at many dates. */
+static void
+test_xaccAccountGetXxxBalanceInCurrencyRecursive_prices (Fixture *fixture,
+                                                         gconstpointer pData)
+{
+    auto root = fixture->acct;
+    auto book = gnc_account_get_book (root);
+    auto pdb = gnc_pricedb_get_db (book);
+    auto usd = gnc_commodity_new (book, "US Dollar", "CURRENCY", "USD", "0", 100);
+    auto eur = gnc_commodity_new (book, "Euro", "CURRENCY", "EUR", "0", 100);
+    auto parent = xaccMallocAccount (book);
+    auto child = xaccMallocAccount (book);
+
+    gnc_account_append_child (root, parent);
+    gnc_account_append_child (parent, child);
+    xaccAccountSetCommodity (parent, usd);
+    xaccAccountSetCommodity (child, eur);
+    gnc_account_set_start_balance (parent, gnc_numeric_create (1000, 100));
+    gnc_account_set_start_balance (child, gnc_numeric_create (1000, 100));
+    xaccAccountRecomputeBalance (parent);
+    xaccAccountRecomputeBalance (child);
+
+    /* No price yet, the child's balance can't be converted */
+    g_assert (gnc_numeric_eq (xaccAccountGetBalanceInCurrency (parent, usd, TRUE),
+                              gnc_numeric_create (1000, 100)));
+
+    /* Price added */
+    auto price = make_price (book, eur, usd, 200);
+    gnc_pricedb_add_price (pdb, price);
+    g_assert (gnc_numeric_eq (xaccAccountGetBalanceInCurrency (parent, usd, TRUE),
+                              gnc_numeric_create (3000, 100)));
+
+    /* Price changed */
+    gnc_price_begin_edit (price);
+    gnc_price_set_value (price, gnc_numeric_create (150, 100));
+    gnc_price_commit_edit (price);
+    g_assert (gnc_numeric_eq (xaccAccountGetBalanceInCurrency (parent, usd, TRUE),
+                              gnc_numeric_create (2500, 100)));
+
+    /* Overflow the cache with balances at many dates */
+    for (time64 date = 1; date <= 100; date++)
+        xaccAccountGetBalanceAsOfDateInCurrency (parent, date, usd, TRUE);
+    g_assert (gnc_numeric_eq (xaccAccountGetBalanceInCurrency (parent, usd, TRUE),
+                              gnc_numeric_create (2500, 100)));
+
+    /* Price removed */
+    gnc_pricedb_remove_price (pdb, price);
+    g_assert (gnc_numeric_eq (xaccAccountGetBalanceInCurrency (parent, usd, TRUE),
+                              gnc_numeric_create (1000, 100)));
+    gnc_price_unref (price);
+}
 /*
  * xaccAccountConvertBalanceToCurrency
  * xaccAccountConvertBalanceToCurrencyAsOfDate are wrappers around
@@ -1971,9 +2176,6 @@ test_xaccAccountGetPresentBalance (Fixture *fixture, gconstpointer pData)
  *
  * xaccAccountGetXxxBalanceInCurrency
  * xaccAccountGetXxxBalanceAsOfDateInCurrency
- * xaccAccountBalanceHelper
- * xaccAccountBalanceAsOfDateHelper
- * xaccAccountGetXxxBalanceInCurrencyRecursive
  * xaccAccountGetXxxBalanceAsOfDateInCurrencyRecursive
  * xaccAccountGetBalanceInCurrency
  * xaccAccountGetClearedBalanceInCurrency
@@ -2579,6 +2781,9 @@ test_suite_account (void)
     GNC_TEST_ADD (suitename, "xaccAccountGetProjectedMinimumBalance", Fixture, &some_data, setup, test_xaccAccountGetProjectedMinimumBalance,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetBalanceAsOfDate", Fixture, &some_data, setup, test_xaccAccountGetBalanceAsOfDate,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetPresentBalance", Fixture, &some_data, setup, test_xaccAccountGetPresentBalance,  teardown );
+    GNC_TEST_ADD (suitename, "xaccAccountGetPresentBalance changes", Fixture, NULL, setup, test_xaccAccountGetPresentBalance_changes,  teardown );
+    GNC_TEST_ADD (suitename, "xaccAccountGetXxxBalanceInCurrencyRecursive", Fixture, NULL, setup, test_xaccAccountGetXxxBalanceInCurrencyRecursive,  teardown );
+    GNC_TEST_ADD (suitename, "xaccAccountGetXxxBalanceInCurrencyRecursive prices", Fixture, NULL, setup, test_xaccAccountGetXxxBalanceInCurrencyRecursive_prices,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountFindOpenLots", Fixture, &complex_data, setup, test_xaccAccountFindOpenLots,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountForEachLot", Fixture, &complex_data, setup, test_xaccAccountForEachLot,  teardown );
 
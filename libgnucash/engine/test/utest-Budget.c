@@ -2555,6 +2555,9 @@ test_gnc_set_budget_account_period_value()
     GncBudget* budget = gnc_budget_new(book);
     Account *acc;
     gnc_numeric val;
+    gnc_numeric twenty = gnc_numeric_create (20, 1);
+    gchar guid_str [GUID_ENCODING_LENGTH + 1];
+    GValue v = G_VALUE_INIT;
 
     guint log_level = G_LOG_LEVEL_WARNING | G_LOG_FLAG_FATAL;
     gchar *log_domain = "gnc.engine";
@@ -2571,6 +2574,36 @@ test_gnc_set_budget_account_period_value()
     val = gnc_budget_get_account_period_value(budget, acc, 0);
     g_assert (gnc_numeric_equal (val, gnc_numeric_create (100, 1)));
 
+    /* Values read before a change must not be served afterwards. */
+    gnc_budget_set_account_period_value(budget, acc, 0, gnc_numeric_create(50,1));
+    val = gnc_budget_get_account_period_value(budget, acc, 0);
+    g_assert (gnc_numeric_equal (val, gnc_numeric_create (50, 1)));
+    gnc_budget_set_num_periods(budget, 20);
+    val = gnc_budget_get_account_period_value(budget, acc, 0);
+    g_assert (gnc_numeric_equal (val, gnc_numeric_create (50, 1)));
+    gnc_budget_unset_account_period_value(budget, acc, 0);
+    g_assert(!gnc_budget_is_account_period_value_set(budget, acc, 0));
+    g_assert(gnc_numeric_zero_p (gnc_budget_get_account_period_value(budget, acc, 0)));
+    gnc_budget_set_num_periods(budget, 12);
+
+    /* A period that was never set reads as a valid zero. */
+    val = gnc_budget_get_account_period_value(budget, acc, 5);
+    g_assert_cmpint (gnc_numeric_check (val), ==, GNC_ERROR_OK);
+    g_assert (gnc_numeric_zero_p (val));
+
+    /* Slots written behind the setters' back are seen once the edit
+     * is committed. */
+    guid_to_string_buff (xaccAccountGetGUID (acc), guid_str);
+    g_value_init (&v, GNC_TYPE_NUMERIC);
+    g_value_set_boxed (&v, &twenty);
+    gnc_budget_begin_edit(budget);
+    qof_instance_set_kvp (QOF_INSTANCE (budget), &v, 2, guid_str, "5");
+    gnc_budget_commit_edit(budget);
+    g_value_unset (&v);
+    g_assert(gnc_budget_is_account_period_value_set(budget, acc, 5));
+    val = gnc_budget_get_account_period_value(budget, acc, 5);
+    g_assert (gnc_numeric_equal (val, twenty));
+
     /* Budget has 12 periods by default, numbered from 0 to 11. Setting
      * period 12 should throw an error. */
     oldlogger = g_log_set_default_handler ((GLogFunc)test_null_handler, &check);
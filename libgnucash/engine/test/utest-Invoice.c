@@ -202,6 +202,172 @@ test_invoice_posted_trans ( Fixture *fixture, gconstpointer pData )
     }
 }
 
+typedef struct
+{
+    GncOwner *owner;
+    GList *lots;
+} OwnerLotScan;
+
+static void
+scan_owner_lot (QofInstance *inst, gpointer user_data)
+{
+    OwnerLotScan *scan = user_data;
+
+    if (gncOwnerLotMatchOwnerFunc (GNC_LOT (inst), scan->owner))
+        scan->lots = g_list_prepend (scan->lots, inst);
+}
+
+/* The owner's lots found the slow way, without the owner lot index */
+static GList *
+scan_owner_lots (QofBook *book, GncOwner *owner)
+{
+    OwnerLotScan scan = { owner, NULL };
+
+    qof_collection_foreach (qof_book_get_collection (book, GNC_ID_LOT),
+                            scan_owner_lot, &scan);
+    return scan.lots;
+}
+
+static gint
+compare_pointers (gconstpointer a, gconstpointer b)
+{
+    return a < b ? -1 : a > b ? 1 : 0;
+}
+
+static void
+assert_owner_lots (QofBook *book, GncOwner *owner)
+{
+    GList *lots = g_list_sort (gncOwnerGetLots (owner), compare_pointers);
+    GList *expected = g_list_sort (scan_owner_lots (book, owner), compare_pointers);
+    GList *node, *enode;
+
+    g_assert_cmpint (g_list_length (lots), ==, g_list_length (expected));
+    for (node = lots, enode = expected; node; node = node->next, enode = enode->next)
+        g_assert (node->data == enode->data);
+    g_list_free (lots);
+    g_list_free (expected);
+}
+
+/* The owner's balance computed from a scan of all lots */
+static gnc_numeric
+scan_owner_balance (QofBook *book, GncOwner *owner)
+{
+    gnc_numeric balance = gnc_numeric_zero ();
+    gnc_commodity *currency = gncOwnerGetCurrency (owner);
+    GList *acct_types = gncOwnerGetAccountTypesList (owner);
+    GList *lots = scan_owner_lots (book, owner);
+    GList *node;
+
+    for (node = lots; node; node = node->next)
+    {
+        GNCLot *lot = node->data;
+        Account *acc = gnc_lot_get_account (lot);
+
+        if (!acc || gnc_lot_is_closed (lot) ||
+            !g_list_find (acct_types, GINT_TO_POINTER (xaccAccountGetType (acc))) ||
+            !gnc_commodity_equal (currency, xaccAccountGetCommodity (acc)) ||
+            !gncInvoiceGetInvoiceFromLot (lot))
+            continue;
+        balance = gnc_numeric_add (balance, gnc_lot_get_balance (lot),
+                                   gnc_commodity_get_fraction (currency),
+                                   GNC_HOW_RND_ROUND_HALF_UP);
+    }
+    g_list_free (lots);
+    g_list_free (acct_types);
+    return balance;
+}
+
+static void
+test_invoice_owner_lots ( Fixture *fixture, gconstpointer pData )
+{
+    GNCLot *lot = gncInvoiceGetPostedLot (fixture->invoice);
+    GList *lots;
+    GHashTable *balances;
+    gnc_numeric *balance;
+    gnc_numeric expected;
+
+    /* Make the posted lot count towards the owner's balance */
+    xaccAccountSetType (fixture->account2, ACCT_TYPE_RECEIVABLE);
+    gncCustomerSetCurrency (fixture->customer, fixture->commodity);
+
+    g_assert (lot);
+    lots = gncOwnerGetLots (&fixture->owner);
+    g_assert_cmpint (g_list_length (lots), ==, 1);
+    g_assert (lots->data == lot);
+    g_list_free (lots);
+    assert_owner_lots (fixture->book, &fixture->owner);
+
+    expected = scan_owner_balance (fixture->book, &fixture->owner);
+    g_assert (gnc_numeric_equal (gncOwnerGetBalanceInCurrency (&fixture->owner, NULL),
+                                 expected));
+
+    balances = gncOwnerGetBalancesInCurrency (fixture->book, GNC_OWNER_NONE, NULL);
+    balance = g_hash_table_lookup (balances, gncOwnerGetGUID (&fixture->owner));
+    g_assert (balance);
+    g_assert (gnc_numeric_equal (*balance, expected));
+    g_hash_table_destroy (balances);
+
+    /* Unposting turns the invoice lot into a pre-payment lot or destroys
+     * it, either way the index must follow. */
+    gncInvoiceUnpost (fixture->invoice, TRUE);
+    assert_owner_lots (fixture->book, &fixture->owner);
+
+    /* Post again so teardown can unpost */
+    fixture->trans = gncInvoicePostToAccount (fixture->invoice, fixture->account2,
+                                              gnc_time (NULL), gnc_time (NULL),
+                                              "memo", TRUE, FALSE);
+    lots = gncOwnerGetLots (&fixture->owner);
+    g_assert (g_list_find (lots, gncInvoiceGetPostedLot (fixture->invoice)));
+    g_list_free (lots);
+    assert_owner_lots (fixture->book, &fixture->owner);
+}
+
+static void
+test_invoice_owner_lots_suspended ( Fixture *fixture, gconstpointer pData )
+{
+    GNCLot *lot;
+    GList *lots;
+
+    /* Build the index, then change lots without any events reaching it */
+    assert_owner_lots (fixture->book, &fixture->owner);
+    qof_event_suspend ();
+
+    lot = gnc_lot_new (fixture->book);
+    gnc_lot_begin_edit (lot);
+    xaccAccountInsertLot (fixture->account2, lot);
+    gnc_lot_commit_edit (lot);
+    gncOwnerAttachToLot (&fixture->owner, lot);
+    lots = gncOwnerGetLots (&fixture->owner);
+    g_assert (g_list_find (lots, lot));
+    g_list_free (lots);
+    assert_owner_lots (fixture->book, &fixture->owner);
+
+    gnc_lot_destroy (lot);
+    lots = gncOwnerGetLots (&fixture->owner);
+    g_assert (!g_list_find (lots, lot));
+    g_list_free (lots);
+    assert_owner_lots (fixture->book, &fixture->owner);
+
+    /* Setting the owner properties updates the index before the commit */
+    lot = gnc_lot_new (fixture->book);
+    gnc_lot_begin_edit (lot);
+    xaccAccountInsertLot (fixture->account2, lot);
+    qof_instance_set (QOF_INSTANCE (lot),
+                      GNC_OWNER_TYPE, (gint64)gncOwnerGetType (&fixture->owner),
+                      GNC_OWNER_GUID, gncOwnerGetGUID (&fixture->owner),
+                      NULL);
+    lots = gncOwnerGetLots (&fixture->owner);
+    g_assert (g_list_find (lots, lot));
+    g_list_free (lots);
+    gnc_lot_commit_edit (lot);
+    assert_owner_lots (fixture->book, &fixture->owner);
+
+    gnc_lot_destroy (lot);
+    assert_owner_lots (fixture->book, &fixture->owner);
+
+    qof_event_resume ();
+}
+
 void
 test_suite_gncInvoice ( void )
 {
@@ -215,4 +381,6 @@ test_suite_gncInvoice ( void )
     GNC_TEST_ADD( suitename, "post trans - customer creditnote", Fixture, &pData, setup_with_invoice, test_invoice_posted_trans, teardown_with_invoice );
     pData.is_cn = FALSE;   // Customer invoice
     GNC_TEST_ADD( suitename, "post trans - customer invoice", Fixture, &pData, setup_with_invoice, test_invoice_posted_trans, teardown_with_invoice );
+    GNC_TEST_ADD( suitename, "owner lot index", Fixture, &pData, setup_with_invoice, test_invoice_owner_lots, teardown_with_invoice );
+    GNC_TEST_ADD( suitename, "owner lot index - events suspended", Fixture, &pData, setup_with_invoice, test_invoice_owner_lots_suspended, teardown_with_invoice );
 }
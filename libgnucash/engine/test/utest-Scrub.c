@@ -0,0 +1,276 @@
+/********************************************************************
+ * utest-Scrub.c: GLib g_test test suite for Scrub.c.               *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+********************************************************************/
+#include <config.h>
+#include <string.h>
+#include <glib.h>
+#include <unittest-support.h>
+/* Add specific headers for this class */
+#include "Scrub.h"
+#include "Account.h"
+#include "Split.h"
+#include "Transaction.h"
+#include "TransactionP.h"
+#include "gnc-commodity.h"
+
+static const gchar *suitename = "/engine/Scrub";
+void test_suite_scrub (void);
+
+/* Enough accounts for the tree scrubs to look for candidates on
+ * several threads. */
+#define NUM_ACCOUNTS 32
+#define NUM_TXNS 240
+
+typedef struct
+{
+    QofBook *serial;
+    QofBook *tree;
+} Fixture;
+
+static Split *
+add_split (Transaction *txn, Account *acc, gint64 amount, gint64 value)
+{
+    Split *split = xaccMallocSplit (xaccTransGetBook (txn));
+
+    xaccSplitSetParent (split, txn);
+    if (acc)
+        xaccSplitSetAccount (split, acc);
+    xaccSplitSetAmount (split, gnc_numeric_create (amount, 100));
+    xaccSplitSetValue (split, gnc_numeric_create (value, 100));
+    return split;
+}
+
+/* The accounts alternate between USD and EUR, and share transactions
+ * that are balanced, imbalanced, orphaned, balanced across currencies,
+ * imbalanced across currencies, or have a USD split whose amount
+ * differs from its value. */
+static void
+build_book (QofBook *book)
+{
+    Account *root = gnc_book_get_root_account (book);
+    gnc_commodity_table *table = gnc_commodity_table_get_table (book);
+    gnc_commodity *usd = gnc_commodity_table_lookup (table,
+                         GNC_COMMODITY_NS_CURRENCY, "USD");
+    gnc_commodity *eur = gnc_commodity_table_lookup (table,
+                         GNC_COMMODITY_NS_CURRENCY, "EUR");
+    Account *accounts[NUM_ACCOUNTS];
+    time64 date = gnc_dmy2time64 (1, 1, 2017);
+    gint i;
+
+    for (i = 0; i < NUM_ACCOUNTS; i++)
+    {
+        gchar *name = g_strdup_printf ("account-%02d", i);
+
+        accounts[i] = xaccMallocAccount (book);
+        xaccAccountBeginEdit (accounts[i]);
+        xaccAccountSetName (accounts[i], name);
+        xaccAccountSetType (accounts[i], ACCT_TYPE_BANK);
+        xaccAccountSetCommodity (accounts[i], i % 2 ? eur : usd);
+        gnc_account_append_child (root, accounts[i]);
+        xaccAccountCommitEdit (accounts[i]);
+        g_free (name);
+    }
+
+    /* Keep the defects; the commits would repair them otherwise */
+    xaccDisableDataScrubbing ();
+    for (i = 0; i < NUM_TXNS; i++)
+    {
+        Transaction *txn = xaccMallocTransaction (book);
+        /* Two USD accounts and a EUR one */
+        Account *usd_a = accounts[(2 * i) % NUM_ACCOUNTS];
+        Account *usd_b = accounts[(2 * i + 4) % NUM_ACCOUNTS];
+        Account *eur_a = accounts[(2 * i + 1) % NUM_ACCOUNTS];
+        gchar *desc = g_strdup_printf ("scrub-%03d", i);
+
+        xaccTransBeginEdit (txn);
+        xaccTransSetCurrency (txn, usd);
+        xaccTransSetDescription (txn, desc);
+        xaccTransSetDatePostedSecsNormalized (txn, date + i * 86400);
+        switch (i % 6)
+        {
+        case 0:
+            add_split (txn, usd_a, 1000, 1000);
+            add_split (txn, usd_b, -1000, -1000);
+            break;
+        case 1:
+            add_split (txn, usd_a, 1000, 1000);
+            add_split (txn, usd_b, -700, -700);
+            break;
+        case 2:
+            add_split (txn, usd_a, 1000, 1000);
+            add_split (txn, NULL, -1000, -1000);
+            break;
+        case 3:
+            add_split (txn, usd_a, 1000, 1000);
+            add_split (txn, eur_a, -900, -1000);
+            break;
+        case 4:
+            add_split (txn, usd_a, 1000, 1000);
+            add_split (txn, eur_a, -700, -800);
+            break;
+        case 5:
+            add_split (txn, usd_a, 1100, 1000);
+            add_split (txn, usd_b, -1000, -1000);
+            break;
+        }
+        xaccTransCommitEdit (txn);
+        g_free (desc);
+    }
+    xaccEnableDataScrubbing ();
+}
+
+static void
+setup (Fixture *fixture, gconstpointer pData)
+{
+    fixture->serial = qof_book_new ();
+    fixture->tree = qof_book_new ();
+    build_book (fixture->serial);
+    build_book (fixture->tree);
+}
+
+static void
+teardown (Fixture *fixture, gconstpointer pData)
+{
+    qof_book_destroy (fixture->serial);
+    qof_book_destroy (fixture->tree);
+}
+
+static void
+no_progress (const char *message, double percent)
+{
+}
+
+static void
+dump_trans (QofInstance *inst, gpointer data)
+{
+    Transaction *txn = GNC_TRANSACTION (inst);
+    GPtrArray *lines = data;
+    GList *node;
+
+    for (node = xaccTransGetSplitList (txn); node; node = node->next)
+    {
+        Split *split = node->data;
+        Account *acc = xaccSplitGetAccount (split);
+        gchar *amount = gnc_numeric_to_string (xaccSplitGetAmount (split));
+        gchar *value = gnc_numeric_to_string (xaccSplitGetValue (split));
+
+        g_ptr_array_add (lines, g_strdup_printf ("%s|%s|%s|%s|%s",
+                         xaccTransGetDescription (txn),
+                         gnc_commodity_get_mnemonic (xaccTransGetCurrency (txn)),
+                         acc ? xaccAccountGetName (acc) : "(orphan)",
+                         amount, value));
+        g_free (amount);
+        g_free (value);
+    }
+}
+
+static gint
+compare_lines (gconstpointer a, gconstpointer b)
+{
+    return g_strcmp0 (*(const gchar **)a, *(const gchar **)b);
+}
+
+/* Every split of the book as one sorted line each, for comparing books
+ * that were built the same way. */
+static gchar *
+dump_book (QofBook *book)
+{
+    GPtrArray *lines = g_ptr_array_new_with_free_func (g_free);
+    gchar *dump;
+
+    qof_collection_foreach (qof_book_get_collection (book, GNC_ID_TRANS),
+                            dump_trans, lines);
+    g_ptr_array_sort (lines, compare_lines);
+    g_ptr_array_add (lines, NULL);
+    dump = g_strjoinv ("\n", (gchar **)lines->pdata);
+    g_ptr_array_free (lines, TRUE);
+    return dump;
+}
+
+static void
+check_trans (QofInstance *inst, gpointer data)
+{
+    Transaction *txn = GNC_TRANSACTION (inst);
+    gboolean balanced = GPOINTER_TO_INT (data);
+    GList *node;
+
+    for (node = xaccTransGetSplitList (txn); node; node = node->next)
+        g_assert (xaccSplitGetAccount (node->data) != NULL);
+    if (balanced)
+        g_assert (xaccTransIsBalanced (txn));
+}
+
+/* xaccAccountTreeScrubOrphans
+void
+xaccAccountTreeScrubOrphans (Account *acc, QofPercentageFunc percentagefunc)
+*/
+static void
+test_xaccAccountTreeScrubOrphans (Fixture *fixture, gconstpointer pData)
+{
+    Account *root = gnc_book_get_root_account (fixture->serial);
+    gchar *serial, *tree;
+
+    /* The serial pass the tree scrub replaces */
+    xaccAccountScrubOrphans (root, no_progress);
+    gnc_account_foreach_descendant (root, (AccountCb)xaccAccountScrubOrphans,
+                                    no_progress);
+    xaccAccountTreeScrubOrphans (gnc_book_get_root_account (fixture->tree),
+                                 NULL);
+
+    qof_collection_foreach (qof_book_get_collection (fixture->tree,
+                            GNC_ID_TRANS), check_trans, GINT_TO_POINTER (FALSE));
+    serial = dump_book (fixture->serial);
+    tree = dump_book (fixture->tree);
+    g_assert_cmpstr (tree, ==, serial);
+    g_free (serial);
+    g_free (tree);
+}
+
+/* xaccAccountTreeScrubImbalance
+void
+xaccAccountTreeScrubImbalance (Account *acc, QofPercentageFunc percentagefunc)
+*/
+static void
+test_xaccAccountTreeScrubImbalance (Fixture *fixture, gconstpointer pData)
+{
+    Account *root = gnc_book_get_root_account (fixture->serial);
+    gchar *serial, *tree;
+
+    xaccAccountScrubImbalance (root, no_progress);
+    gnc_account_foreach_descendant (root, (AccountCb)xaccAccountScrubImbalance,
+                                    no_progress);
+    xaccAccountTreeScrubImbalance (gnc_book_get_root_account (fixture->tree),
+                                   NULL);
+
+    qof_collection_foreach (qof_book_get_collection (fixture->tree,
+                            GNC_ID_TRANS), check_trans, GINT_TO_POINTER (TRUE));
+    serial = dump_book (fixture->serial);
+    tree = dump_book (fixture->tree);
+    g_assert_cmpstr (tree, ==, serial);
+    g_free (serial);
+    g_free (tree);
+}
+
+void
+test_suite_scrub (void)
+{
+    GNC_TEST_ADD (suitename, "xaccAccountTreeScrubOrphans", Fixture, NULL, setup, test_xaccAccountTreeScrubOrphans, teardown);
+    GNC_TEST_ADD (suitename, "xaccAccountTreeScrubImbalance", Fixture, NULL, setup, test_xaccAccountTreeScrubImbalance, teardown);
+}
@@ -0,0 +1,257 @@
+/********************************************************************
+ * utest-TransLog.c: GLib g_test test suite for TransLog.c.         *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+********************************************************************/
+#include <config.h>
+#include <string.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <unittest-support.h>
+/* Add specific headers for this class */
+#include "TransLog.h"
+#include "Transaction.h"
+#include "Split.h"
+
+static const gchar *suitename = "/engine/TransLog";
+void test_suite_translog (void);
+
+#define NUM_TXNS 10
+
+typedef struct
+{
+    QofBook *book;
+    Transaction *txns[NUM_TXNS];
+    gchar *dir;
+} Fixture;
+
+static void
+setup (Fixture *fixture, gconstpointer pData)
+{
+    gchar *base;
+    gint i;
+
+    fixture->book = qof_book_new ();
+    for (i = 0; i < NUM_TXNS; i++)
+    {
+        Transaction *txn = xaccMallocTransaction (fixture->book);
+        Split *split = xaccMallocSplit (fixture->book);
+        gchar *desc = g_strdup_printf ("translog-test-%02d", i);
+
+        xaccTransBeginEdit (txn);
+        xaccTransSetDescription (txn, desc);
+        xaccSplitSetParent (split, txn);
+        /* xaccTransCommitEdit () does a bunch of scrubbing that we don't need */
+        qof_commit_edit (QOF_INSTANCE (txn));
+        fixture->txns[i] = txn;
+        g_free (desc);
+    }
+
+    fixture->dir = g_dir_make_tmp ("translog-XXXXXX", NULL);
+    g_assert (fixture->dir != NULL);
+    base = g_build_filename (fixture->dir, "test", NULL);
+    xaccLogSetBaseName (base);
+    g_free (base);
+
+    /* Write only when asked to, so the test sees what is pending */
+    xaccLogSetFlushPolicy (0, 0);
+    xaccLogEnable ();
+    xaccOpenLog ();
+}
+
+static void
+teardown (Fixture *fixture, gconstpointer pData)
+{
+    GDir *dir;
+    const gchar *name;
+
+    xaccCloseLog ();
+    xaccLogDisable ();
+    xaccLogSetFlushPolicy (1, 0);
+
+    dir = g_dir_open (fixture->dir, 0, NULL);
+    while ((name = g_dir_read_name (dir)))
+    {
+        gchar *path = g_build_filename (fixture->dir, name, NULL);
+        g_unlink (path);
+        g_free (path);
+    }
+    g_dir_close (dir);
+    g_rmdir (fixture->dir);
+    g_free (fixture->dir);
+
+    qof_book_destroy (fixture->book);
+}
+
+/* The contents of all log files in the directory, oldest first. */
+static gchar *
+read_logs (const Fixture *fixture)
+{
+    GDir *dir = g_dir_open (fixture->dir, 0, NULL);
+    GPtrArray *names = g_ptr_array_new_with_free_func (g_free);
+    GString *contents = g_string_new (NULL);
+    const gchar *name;
+    guint i;
+
+    while ((name = g_dir_read_name (dir)))
+        g_ptr_array_add (names, g_strdup (name));
+    g_dir_close (dir);
+    g_ptr_array_sort (names, (GCompareFunc)g_strcmp0);
+
+    for (i = 0; i < names->len; i++)
+    {
+        gchar *path = g_build_filename (fixture->dir,
+                                        g_ptr_array_index (names, i), NULL);
+        gchar *text = NULL;
+
+        g_assert (g_file_get_contents (path, &text, NULL, NULL));
+        g_string_append (contents, text);
+        g_free (text);
+        g_free (path);
+    }
+    g_ptr_array_free (names, TRUE);
+    return g_string_free (contents, FALSE);
+}
+
+/* Check that the records of txns first to last-1 are in the log once
+ * each and in the order they were written, and return where the last
+ * of them ends. */
+static const gchar *
+assert_records (const gchar *log, const Fixture *fixture, gint first,
+                gint last)
+{
+    const gchar *pos = log;
+    gint i;
+
+    for (i = first; i < last; i++)
+    {
+        const gchar *desc = xaccTransGetDescription (fixture->txns[i]);
+        const gchar *found = strstr (pos, desc);
+
+        g_assert (found != NULL);
+        g_assert (strstr (found + 1, desc) == NULL);
+        pos = found + strlen (desc);
+    }
+    return pos;
+}
+
+/* xaccTransWriteLog
+void
+xaccTransWriteLog (Transaction *trans, char flag)
+xaccLogFlush
+void
+xaccLogFlush (void)
+*/
+static void
+test_xaccLogFlush (Fixture *fixture, gconstpointer pData)
+{
+    gchar *log;
+    gint i;
+
+    for (i = 0; i < NUM_TXNS; i++)
+        xaccTransWriteLog (fixture->txns[i], 'C');
+
+    /* Nothing is due yet under the flush policy */
+    log = read_logs (fixture);
+    g_assert (strstr (log, "mod\ttrans_guid") != NULL);
+    g_assert (strstr (log, "translog-test-") == NULL);
+    g_free (log);
+
+    xaccLogFlush ();
+    log = read_logs (fixture);
+    assert_records (log, fixture, 0, NUM_TXNS);
+    g_free (log);
+}
+
+/* xaccLogSetFlushPolicy
+void
+xaccLogSetFlushPolicy (guint records, guint msec)
+*/
+static void
+test_xaccLogSetFlushPolicy (Fixture *fixture, gconstpointer pData)
+{
+    gint64 deadline;
+    gchar *log = NULL;
+    gint i;
+
+    /* The writer wakes up after the fifth record */
+    xaccLogSetFlushPolicy (5, 0);
+    for (i = 0; i < 5; i++)
+        xaccTransWriteLog (fixture->txns[i], 'C');
+
+    deadline = g_get_monotonic_time () + 10 * G_TIME_SPAN_SECOND;
+    do
+    {
+        g_free (log);
+        g_usleep (10 * 1000);
+        log = read_logs (fixture);
+    }
+    while (!strstr (log, xaccTransGetDescription (fixture->txns[4])) &&
+           g_get_monotonic_time () < deadline);
+    assert_records (log, fixture, 0, 5);
+    g_free (log);
+}
+
+/* xaccCloseLog
+void
+xaccCloseLog (void)
+xaccOpenLog
+void
+xaccOpenLog (void)
+*/
+static void
+test_xaccCloseLog_reopen (Fixture *fixture, gconstpointer pData)
+{
+    const gchar *pos;
+    gchar *log;
+    gint i;
+
+    for (i = 0; i < NUM_TXNS / 2; i++)
+        xaccTransWriteLog (fixture->txns[i], 'C');
+
+    /* Closing writes out what is pending before it returns */
+    xaccCloseLog ();
+    log = read_logs (fixture);
+    assert_records (log, fixture, 0, NUM_TXNS / 2);
+    g_free (log);
+
+    /* Writing to a closed log is a no-op */
+    xaccTransWriteLog (fixture->txns[NUM_TXNS / 2], 'C');
+    log = read_logs (fixture);
+    g_assert (strstr (log, xaccTransGetDescription
+                      (fixture->txns[NUM_TXNS / 2])) == NULL);
+    g_free (log);
+
+    /* A reopened log gets a new writer */
+    xaccOpenLog ();
+    for (i = NUM_TXNS / 2; i < NUM_TXNS; i++)
+        xaccTransWriteLog (fixture->txns[i], 'C');
+    xaccLogFlush ();
+    log = read_logs (fixture);
+    pos = assert_records (log, fixture, 0, NUM_TXNS);
+    g_assert (strstr (pos, "===== END") != NULL);
+    g_free (log);
+}
+
+void
+test_suite_translog (void)
+{
+    GNC_TEST_ADD (suitename, "xaccLogFlush", Fixture, NULL, setup, test_xaccLogFlush, teardown);
+    GNC_TEST_ADD (suitename, "xaccLogSetFlushPolicy", Fixture, NULL, setup, test_xaccLogSetFlushPolicy, teardown);
+    GNC_TEST_ADD (suitename, "xaccCloseLog and reopen", Fixture, NULL, setup, test_xaccCloseLog_reopen, teardown);
+}
@@ -105,6 +105,12 @@ public:
         set_error(m_result_err);
         m_last_call = "rollback";
     }
+    void begin_batch(QofBook*) override {
+        m_last_call = "begin_batch";
+    }
+    void commit_batch(QofBook*) override {
+        m_last_call = "commit_batch";
+    }
     void inject_error(QofBackendError err) {
         m_result_err = err;
     }
@@ -1636,6 +1642,90 @@ test_xaccTransCommitEdit (void)
     test_destroy (comm);
     qof_book_destroy (book);
 }
+/* xaccTransCommitEditBatch
+void
+xaccTransCommitEditBatch (GList *trans_list)
+*/
+static void
+test_xaccTransCommitEditBatch (Fixture *fixture, gconstpointer pData)
+{
+    QofBook *book = qof_instance_get_book (fixture->txn);
+    auto mbe = static_cast<TransMockBackend*>(qof_book_get_backend (book));
+    auto sig_modify = test_signal_new (QOF_INSTANCE (fixture->acc1),
+                                       QOF_EVENT_MODIFY, NULL);
+    auto sig_added = test_signal_new (QOF_INSTANCE (fixture->acc1),
+                                      GNC_EVENT_ITEM_ADDED, NULL);
+    auto sig_changed = test_signal_new (QOF_INSTANCE (fixture->acc1),
+                                        GNC_EVENT_ITEM_CHANGED, NULL);
+    auto num_splits = g_list_length (xaccAccountGetSplitList (fixture->acc1));
+    auto balance = xaccAccountGetBalance (fixture->acc1);
+    GList *batch = NULL;
+    Transaction *unbalanced = NULL;
+    Split *prev = NULL;
+
+    for (int i = 0; i < 5; i++)
+    {
+        auto txn = xaccMallocTransaction (book);
+        auto split1 = xaccMallocSplit (book);
+        auto split2 = xaccMallocSplit (book);
+
+        xaccTransBeginEdit (txn);
+        xaccTransSetCurrency (txn, fixture->curr);
+        /* Posted in reverse order, so the account has to sort them. */
+        xaccTransSetDatePostedSecs (txn, gnc_dmy2time64 (28 - i, 4, 2012));
+        xaccSplitSetParent (split1, txn);
+        xaccSplitSetParent (split2, txn);
+        xaccSplitSetAccount (split1, fixture->acc1);
+        xaccSplitSetAccount (split2, fixture->acc2);
+        xaccSplitSetAmount (split1, gnc_numeric_create (1000, 1000));
+        xaccSplitSetValue (split1, gnc_numeric_create (240, 240));
+        /* Leave one unbalanced to show that the scrub pass ran. */
+        if (i == 2)
+        {
+            unbalanced = txn;
+            xaccSplitSetAmount (split2, gnc_numeric_create (-120, 240));
+            xaccSplitSetValue (split2, gnc_numeric_create (-120, 240));
+        }
+        else
+        {
+            xaccSplitSetAmount (split2, gnc_numeric_create (-240, 240));
+            xaccSplitSetValue (split2, gnc_numeric_create (-240, 240));
+        }
+        batch = g_list_append (batch, txn);
+    }
+
+    xaccTransCommitEditBatch (batch);
+
+    for (auto node = batch; node; node = node->next)
+        g_assert (!xaccTransIsOpen (static_cast<Transaction*>(node->data)));
+    g_assert_cmpint (g_list_length (unbalanced->splits), ==, 3);
+
+    g_assert_cmpint (g_list_length (xaccAccountGetSplitList (fixture->acc1)),
+                     ==, num_splits + 5);
+    for (auto node = xaccAccountGetSplitList (fixture->acc1); node;
+         node = node->next)
+    {
+        auto split = static_cast<Split*>(node->data);
+        if (prev)
+            g_assert_cmpint (xaccSplitOrder (prev, split), <=, 0);
+        prev = split;
+    }
+    g_assert (gnc_numeric_equal (xaccAccountGetBalance (fixture->acc1),
+                                 gnc_numeric_add_fixed (balance,
+                                     gnc_numeric_create (5, 1))));
+
+    /* One modify and one refresh event for the account and none per
+     * split */
+    g_assert_cmpint (test_signal_return_hits (sig_modify), ==, 1);
+    g_assert_cmpint (test_signal_return_hits (sig_added), ==, 0);
+    g_assert_cmpint (test_signal_return_hits (sig_changed), ==, 1);
+    g_assert_cmpstr (mbe->m_last_call.c_str(), ==, "commit_batch");
+
+    test_signal_free (sig_modify);
+    test_signal_free (sig_added);
+    test_signal_free (sig_changed);
+    g_list_free (batch);
+}
 /* xaccTransRollbackEdit
 void
 xaccTransRollbackEdit (Transaction *trans)// C: 2 in 2  Local: 1:0:0
@@ -2034,6 +2124,7 @@ test_suite_transaction (void)
     GNC_TEST_ADD (suitename, "trans on error", Fixture, NULL, setup, test_trans_on_error, teardown);
     GNC_TEST_ADD (suitename, "trans cleanup commit", Fixture, NULL, setup, test_trans_cleanup_commit, teardown);
     GNC_TEST_ADD_FUNC (suitename, "xaccTransCommitEdit", test_xaccTransCommitEdit);
+    GNC_TEST_ADD (suitename, "xaccTransCommitEditBatch", Fixture, NULL, setup, test_xaccTransCommitEditBatch, teardown);
     GNC_TEST_ADD (suitename, "xaccTransRollbackEdit", Fixture, NULL, setup, test_xaccTransRollbackEdit, teardown);
     GNC_TEST_ADD (suitename, "xaccTransRollbackEdit - Backend Errors", Fixture, NULL, setup, test_xaccTransRollbackEdit_BackendErrors, teardown);
     GNC_TEST_ADD (suitename, "xaccTransOrder_num_action", Fixture, NULL, setup, test_xaccTransOrder_num_action, teardown);